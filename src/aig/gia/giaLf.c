@@ -23,6 +23,17 @@
 #include "misc/vec/vecSet.h"
 #include "misc/vec/vecMem.h"
 #include "misc/util/utilTruth.h"
+#include "map/if/if.h"
+
+#ifdef ABC_USE_PTHREADS
+
+#ifdef _WIN32
+#include "../lib/pthread.h"
+#else
+#include <pthread.h>
+#endif
+
+#endif
 
 ABC_NAMESPACE_IMPL_START
 
@@ -37,6 +48,8 @@ ABC_NAMESPACE_IMPL_START
 #define LF_CUT_WORDS (4+LF_LEAF_MAX/2)
 #define LF_TT_WORDS  ((LF_LEAF_MAX > 6) ? 1 << (LF_LEAF_MAX-6) : 1)
 #define LF_EPSILON 0.005
+#define LF_PAR_THR_MAX 64
+#define LF_PAR_CHUNK  (1 << 12)
 
 typedef struct Lf_Cut_t_ Lf_Cut_t; 
 struct Lf_Cut_t_
@@ -74,6 +87,14 @@ struct Lf_Mem_t_
     Vec_Ptr_t       vPages;          // memory pages
     Vec_Ptr_t *     vFree;           // free pages 
 };
+typedef struct Lf_Thr_t_ Lf_Thr_t; 
+struct Lf_Thr_t_
+{
+    int             fParallel;       // other threads compute cuts at the same time
+    word            CutTemp[3][LF_CUT_WORDS]; // unit cuts of the fanins
+    double          CutCount[3];     // cut counts
+    int             nTimeFails;      // timing fails
+};
 typedef struct Lf_Man_t_ Lf_Man_t; 
 struct Lf_Man_t_
 {
@@ -90,6 +111,13 @@ struct Lf_Man_t_
     Vec_Ptr_t       vFreePages;      // free memory pages
     Lf_Mem_t        vStoreOld;       // previous cuts
     Lf_Mem_t        vStoreNew;       // current cuts
+    int             fRecycle;        // recycle the pages of previous cuts while loading them
+    int             fParStore;       // previous cuts were saved in the level order
+    // parallel data
+    Lf_Thr_t *      pThrs;           // per-thread data of cut computation
+    If_TtStore_t *  pTtStore;        // concurrent hash table of vTtMem
+    Vec_Int_t       vParNodes;       // nodes sorted by level
+    Vec_Int_t       vParLevels;      // the first node of each level in vParNodes
     // mapper data
     Vec_Int_t       vOffsets;        // offsets
     Vec_Int_t       vRequired;       // required times
@@ -393,15 +421,26 @@ static inline Lf_Cut_t * Lf_ManFetchSet( Lf_Man_t * p, int i )
     }
     return (Lf_Cut_t *)((word *)Vec_PtrEntry(&p->vMemSets, Entry >> LF_LOG_PAGE) + p->nSetWords * (Entry & uMaskPage));
 }
-static inline int Lf_ManPrepareSet( Lf_Man_t * p, int iObj, int Index, Lf_Cut_t ** ppCutSet )
+static inline Lf_Cut_t * Lf_ManReadSet( Lf_Man_t * p, int i )
+{
+    int Entry = Vec_IntEntry( &p->vCutSets, Vec_IntEntry(&p->vOffsets, i) );
+    assert( Entry >= 0 );
+    return (Lf_Cut_t *)((word *)Vec_PtrEntry(&p->vMemSets, Entry >> LF_LOG_PAGE) + p->nSetWords * (Entry & ((1 << LF_LOG_PAGE) - 1)));
+}
+static inline void Lf_ManReleaseSet( Lf_Man_t * p, int i )
+{
+    if ( Vec_IntEntry(&p->vOffsets, i) != -1 )
+        Lf_ManFetchSet( p, i );
+}
+static inline int Lf_ManPrepareSet( Lf_Man_t * p, Lf_Thr_t * pThr, int iObj, int Index, Lf_Cut_t ** ppCutSet )
 {
-    static word CutTemp[3][LF_CUT_WORDS];
     if ( Vec_IntEntry(&p->vOffsets, iObj) == -1 )
-        return Lf_CutCreateUnit( (*ppCutSet = (Lf_Cut_t *)CutTemp[Index]), iObj );
+        return Lf_CutCreateUnit( (*ppCutSet = (Lf_Cut_t *)pThr->CutTemp[Index]), iObj );
     {
         Lf_Cut_t * pCut; 
         int i, nCutNum = p->pPars->nCutNum;
-        *ppCutSet = Lf_ManFetchSet(p, iObj);
+        // in parallel mode, the fanin cutsets are released later by Lf_ManReleaseSet()
+        *ppCutSet = pThr->fParallel ? Lf_ManReadSet(p, iObj) : Lf_ManFetchSet(p, iObj);
         Lf_CutSetForEachCut( p->nCutWords, *ppCutSet, pCut, i, nCutNum )
             if ( pCut->nLeaves == LF_NO_LEAF )
                 return i;
@@ -545,7 +584,7 @@ static inline int Lf_MemSaveCut( Lf_Mem_t * p, Lf_Cut_t * pCut, int iObj )
         p->iCur = (p->iCur & ~p->MaskPage) | iPlace;
     return iCur;
 }
-static inline Lf_Cut_t * Lf_MemLoadCut( Lf_Mem_t * p, int iCur, int iObj, Lf_Cut_t * pCut, int fTruth, int fRecycle )
+static inline Lf_Cut_t * Lf_MemLoadCut( Lf_Mem_t * p, int iCur, int iObj, Lf_Cut_t * pCut, int fTruth, int fRecycle, int fSign )
 {
     unsigned char * pPlace;  
     int i, Prev = iObj, Page = iCur >> p->LogPage;
@@ -562,7 +601,7 @@ static inline Lf_Cut_t * Lf_MemLoadCut( Lf_Mem_t * p, int iCur, int iObj, Lf_Cut
         Vec_PtrPush( p->vFree, Vec_PtrEntry(&p->vPages, Page-1) );
         Vec_PtrWriteEntry( &p->vPages, Page-1, NULL );
     }
-    pCut->Sign = fRecycle ? Lf_CutGetSign(pCut) : 0;
+    pCut->Sign = fSign ? Lf_CutGetSign(pCut) : 0;
     pCut->fMux7 = 0;
     return pCut;
 }
@@ -602,7 +641,7 @@ static inline Lf_Cut_t * Lf_ObjCutBest( Lf_Man_t * p, int i )
     pCut->Flow  = pBest->Flow[Index];
     if ( Index == 2 )
         return Lf_MemLoadMuxCut( p, i, pCut );
-    return Lf_MemLoadCut( &p->vStoreOld, pBest->Cut[Index].Handle, i, pCut, p->pPars->fCutMin, 0 );
+    return Lf_MemLoadCut( &p->vStoreOld, pBest->Cut[Index].Handle, i, pCut, p->pPars->fCutMin, 0, 0 );
 }
 static inline Lf_Cut_t * Lf_ObjCutBestNew( Lf_Man_t * p, int i, Lf_Cut_t * pCut )
 {
@@ -612,7 +651,7 @@ static inline Lf_Cut_t * Lf_ObjCutBestNew( Lf_Man_t * p, int i, Lf_Cut_t * pCut
     pCut->Flow  = pBest->Flow[Index];
     if ( Index == 2 )
         return Lf_MemLoadMuxCut( p, i, pCut );
-    return Lf_MemLoadCut( &p->vStoreNew, pBest->Cut[Index].Handle, i, pCut, 0, 0 );
+    return Lf_MemLoadCut( &p->vStoreNew, pBest->Cut[Index].Handle, i, pCut, 0, 0, 0 );
 }
 
 /**Function*************************************************************
@@ -961,6 +1000,12 @@ static inline int Lf_ManFindCofVar( word * pTruth, int nWords, int nVars )
   SeeAlso     []
 
 ***********************************************************************/
+static inline int Lf_ManTruthInsert( Lf_Man_t * p, word * pTruth )
+{
+    if ( p->pTtStore )
+        return If_TtStoreInsert( p->pTtStore, pTruth );
+    return Vec_MemHashInsert( p->vTtMem, pTruth );
+}
 static inline int Lf_CutComputeTruth6( Lf_Man_t * p, Lf_Cut_t * pCut0, Lf_Cut_t * pCut1, int fCompl0, int fCompl1, Lf_Cut_t * pCutR, int fIsXor )
 {
 //    extern int Mf_ManTruthCanonicize( word * t, int nVars );
@@ -975,7 +1020,7 @@ static inline int Lf_CutComputeTruth6( Lf_Man_t * p, Lf_Cut_t * pCut0, Lf_Cut_t
     if ( (fCompl = (int)(t & 1)) ) t = ~t;
     pCutR->nLeaves = Abc_Tt6MinBase( &t, pCutR->pLeaves, pCutR->nLeaves );
     assert( (int)(t & 1) == 0 );
-    truthId        = Vec_MemHashInsert(p->vTtMem, &t);
+    truthId        = Lf_ManTruthInsert(p, &t);
     pCutR->iFunc   = Abc_Var2Lit( truthId, fCompl );
 //    p->nCutMux += Lf_ManTtIsMux( t );
     assert( (int)pCutR->nLeaves <= nOldSupp );
@@ -1004,7 +1049,7 @@ static inline int Lf_CutComputeTruth( Lf_Man_t * p, Lf_Cut_t * pCut0, Lf_Cut_t *
     pCutR->nLeaves = Abc_TtMinBase( uTruth, pCutR->pLeaves, pCutR->nLeaves, LutSize );
     assert( (uTruth[0] & 1) == 0 );
 //Kit_DsdPrintFromTruth( uTruth, pCutR->nLeaves ), printf("\n" ), printf("\n" );
-    truthId        = Vec_MemHashInsert(p->vTtMem, uTruth);
+    truthId        = Lf_ManTruthInsert(p, uTruth);
     pCutR->iFunc   = Abc_Var2Lit( truthId, fCompl );
     assert( (int)pCutR->nLeaves <= nOldSupp );
     return (int)pCutR->nLeaves < nOldSupp;
@@ -1026,7 +1071,7 @@ static inline int Lf_CutComputeTruthMux6( Lf_Man_t * p, Lf_Cut_t * pCut0, Lf_Cut
     if ( (fCompl = (int)(t & 1)) ) t = ~t;
     pCutR->nLeaves = Abc_Tt6MinBase( &t, pCutR->pLeaves, pCutR->nLeaves );
     assert( (int)(t & 1) == 0 );
-    truthId        = Vec_MemHashInsert(p->vTtMem, &t);
+    truthId        = Lf_ManTruthInsert(p, &t);
     pCutR->iFunc   = Abc_Var2Lit( truthId, fCompl );
     assert( (int)pCutR->nLeaves <= nOldSupp );
     return (int)pCutR->nLeaves < nOldSupp;
@@ -1054,7 +1099,7 @@ static inline int Lf_CutComputeTruthMux( Lf_Man_t * p, Lf_Cut_t * pCut0, Lf_Cut_
     if ( fCompl ) Abc_TtNot( uTruth, nWords );
     pCutR->nLeaves = Abc_TtMinBase( uTruth, pCutR->pLeaves, pCutR->nLeaves, LutSize );
     assert( (uTruth[0] & 1) == 0 );
-    truthId        = Vec_MemHashInsert(p->vTtMem, uTruth);
+    truthId        = Lf_ManTruthInsert(p, uTruth);
     pCutR->iFunc   = Abc_Var2Lit( truthId, fCompl );
     assert( (int)pCutR->nLeaves <= nOldSupp );
     return (int)pCutR->nLeaves < nOldSupp;
@@ -1183,11 +1228,22 @@ static inline void Lf_CutParams( Lf_Man_t * p, Lf_Cut_t * pCut, int Required, fl
     }
 }
 
-void Lf_ObjMergeOrder( Lf_Man_t * p, int iObj )
+/**Function*************************************************************
+
+  Synopsis    [Computes the priority cuts of the node.]
+
+  Description [Returns the number of cuts in pCutsR, which point into
+  pCutSet, and the required time used to evaluate them. In parallel mode,
+  only adds truth tables to the manager.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static int Lf_ObjMergeOrderCuts( Lf_Man_t * p, Lf_Thr_t * pThr, int iObj, Lf_Cut_t * pCutSet, Lf_Cut_t ** pCutsR, int * pRequired )
 {
-    word CutSet[LF_CUT_MAX][LF_CUT_WORDS] = {{0}};
     Lf_Cut_t * pCutSet0, * pCutSet1, * pCutSet2, * pCut0, * pCut1, * pCut2;
-    Lf_Cut_t * pCutSet = (Lf_Cut_t *)CutSet, * pCutsR[LF_CUT_MAX];
     Gia_Obj_t * pObj = Gia_ManObj(p->pGia, iObj);
     Lf_Bst_t * pBest = Lf_ObjReadBest(p, iObj);
     float FlowRefs = Lf_ObjFlowRefs(p, iObj);
@@ -1197,11 +1253,11 @@ void Lf_ObjMergeOrder( Lf_Man_t * p, int iObj )
     int nCutWords  = p->nCutWords;
     int fComp0     = Gia_ObjFaninC0(pObj);
     int fComp1     = Gia_ObjFaninC1(pObj);
-    int nCuts0     = Lf_ManPrepareSet( p, Gia_ObjFaninId0(pObj, iObj), 0, &pCutSet0 );
-    int nCuts1     = Lf_ManPrepareSet( p, Gia_ObjFaninId1(pObj, iObj), 1, &pCutSet1 );
+    int nCuts0     = Lf_ManPrepareSet( p, pThr, Gia_ObjFaninId0(pObj, iObj), 0, &pCutSet0 );
+    int nCuts1     = Lf_ManPrepareSet( p, pThr, Gia_ObjFaninId1(pObj, iObj), 1, &pCutSet1 );
     int iSibl      = Gia_ObjSibl(p->pGia, iObj);
-    int i, k, n, iCutUsed, nCutsR = 0;
-    float Value1 = -1, Value2 = -1;
+    int i, k, n, nCutsR = 0;
+    float Value1 = -1;
     assert( !Gia_ObjIsBuf(pObj) );
     Lf_CutSetForEachCut( nCutWords, pCutSet, pCut0, i, nCutNum )
         pCutsR[i] = pCut0;
@@ -1209,9 +1265,9 @@ void Lf_ObjMergeOrder( Lf_Man_t * p, int iObj )
     {
         assert( nCutsR == 0 );
         // load cuts
-        Lf_MemLoadCut( &p->vStoreOld, pBest->Cut[0].Handle, iObj, pCutsR[0], p->pPars->fCutMin, 1 );
+        Lf_MemLoadCut( &p->vStoreOld, pBest->Cut[0].Handle, iObj, pCutsR[0], p->pPars->fCutMin, p->fRecycle, 1 );
         if ( Lf_BestDiffCuts(pBest) )
-            Lf_MemLoadCut( &p->vStoreOld, pBest->Cut[1].Handle, iObj, pCutsR[1], p->pPars->fCutMin, 1 );
+            Lf_MemLoadCut( &p->vStoreOld, pBest->Cut[1].Handle, iObj, pCutsR[1], p->pPars->fCutMin, p->fRecycle, 1 );
         // deref the cut
         if ( p->fUseEla && Lf_ObjMapRefNum(p, iObj) > 0 )
             Value1 = Lf_CutDeref_rec( p, pCutsR[Lf_BestIndex(pBest)] );
@@ -1227,13 +1283,13 @@ void Lf_ObjMergeOrder( Lf_Man_t * p, int iObj )
             nCutsR = Lf_SetAddCut( pCutsR, nCutsR, nCutNum );
         }
         if ( pCutsR[0]->fLate )
-            p->nTimeFails++;
+            pThr->nTimeFails++;
     }
     if ( iSibl )
     {
         Gia_Obj_t * pObjE = Gia_ObjSiblObj(p->pGia, iObj);
         int fCompE = Gia_ObjPhase(pObj) ^ Gia_ObjPhase(pObjE);
-        int nCutsE = Lf_ManPrepareSet( p, iSibl, 2, &pCutSet2 );
+        int nCutsE = Lf_ManPrepareSet( p, pThr, iSibl, 2, &pCutSet2 );
         Lf_CutSetForEachCut( nCutWords, pCutSet2, pCut2, n, nCutsE )
         {
             if ( pCut2->pLeaves[0] == iSibl )
@@ -1249,8 +1305,8 @@ void Lf_ObjMergeOrder( Lf_Man_t * p, int iObj )
     {
         Lf_Cut_t * pCutSave = NULL;
         int fComp2 = Gia_ObjFaninC2(p->pGia, pObj);
-        int nCuts2 = Lf_ManPrepareSet( p, Gia_ObjFaninId2(p->pGia, iObj), 2, &pCutSet2 );
-        p->CutCount[0] += nCuts0 * nCuts1 * nCuts2;
+        int nCuts2 = Lf_ManPrepareSet( p, pThr, Gia_ObjFaninId2(p->pGia, iObj), 2, &pCutSet2 );
+        pThr->CutCount[0] += nCuts0 * nCuts1 * nCuts2;
         Lf_CutSetForEachCut( nCutWords, pCutSet0, pCut0, i, nCuts0 ) if ( (int)pCut0->nLeaves <= nLutSize )
         Lf_CutSetForEachCut( nCutWords, pCutSet1, pCut1, k, nCuts1 ) if ( (int)pCut1->nLeaves <= nLutSize )
         Lf_CutSetForEachCut( nCutWords, pCutSet2, pCut2, n, nCuts2 ) if ( (int)pCut2->nLeaves <= nLutSize )
@@ -1258,12 +1314,12 @@ void Lf_ObjMergeOrder( Lf_Man_t * p, int iObj )
             pCutSave = pCut2;
             if ( Lf_CutCountBits(pCut0->Sign | pCut1->Sign | pCut2->Sign) > nLutSize )
                 continue;
-            p->CutCount[1]++; 
+            pThr->CutCount[1]++; 
             if ( !Lf_CutMergeOrderMux(pCut0, pCut1, pCut2, pCutsR[nCutsR], nLutSize) )
                 continue;
             if ( Lf_SetLastCutIsContained(pCutsR, nCutsR) )
                 continue;
-            p->CutCount[2]++;
+            pThr->CutCount[2]++;
             if ( p->pPars->fCutMin && Lf_CutComputeTruthMux(p, pCut0, pCut1, pCut2, fComp0, fComp1, fComp2, pCutsR[nCutsR]) )
                 pCutsR[nCutsR]->Sign = Lf_CutGetSign(pCutsR[nCutsR]);
             if ( p->pPars->nLutSizeMux && p->pPars->nLutSizeMux == (int)pCutsR[nCutsR]->nLeaves && 
@@ -1282,12 +1338,12 @@ void Lf_ObjMergeOrder( Lf_Man_t * p, int iObj )
                 assert( (int)pCut0->nLeaves + (int)pCut1->nLeaves + 1 <= p->pPars->nLutSize );
     //            if ( Lf_CutCountBits(pCut0->Sign | pCut1->Sign | pCutSave->Sign) > p->pPars->nLutSize )
     //                continue;
-                p->CutCount[1]++; 
+                pThr->CutCount[1]++; 
                 if ( !Lf_CutMergeOrderMux(pCut0, pCut1, pCutSave, pCutsR[nCutsR], p->pPars->nLutSize) )
                     continue;
                 if ( Lf_SetLastCutIsContained(pCutsR, nCutsR) )
                     continue;
-                p->CutCount[2]++;
+                pThr->CutCount[2]++;
                 if ( p->pPars->fCutMin && Lf_CutComputeTruthMux(p, pCut0, pCut1, pCutSave, fComp0, fComp1, fComp2, pCutsR[nCutsR]) )
                     pCutsR[nCutsR]->Sign = Lf_CutGetSign(pCutsR[nCutsR]);
     //            if ( p->pPars->nLutSizeMux && p->pPars->nLutSizeMux == (int)pCutsR[nCutsR]->nLeaves && 
@@ -1301,18 +1357,18 @@ void Lf_ObjMergeOrder( Lf_Man_t * p, int iObj )
     else
     {
         int fIsXor = Gia_ObjIsXor(pObj);
-        p->CutCount[0] += nCuts0 * nCuts1;
+        pThr->CutCount[0] += nCuts0 * nCuts1;
         Lf_CutSetForEachCut( nCutWords, pCutSet0, pCut0, i, nCuts0 ) if ( (int)pCut0->nLeaves <= nLutSize )
         Lf_CutSetForEachCut( nCutWords, pCutSet1, pCut1, k, nCuts1 ) if ( (int)pCut1->nLeaves <= nLutSize )
         {
             if ( (int)(pCut0->nLeaves + pCut1->nLeaves) > nLutSize && Lf_CutCountBits(pCut0->Sign | pCut1->Sign) > nLutSize )
                 continue;
-            p->CutCount[1]++; 
+            pThr->CutCount[1]++; 
             if ( !Lf_CutMergeOrder(pCut0, pCut1, pCutsR[nCutsR], nLutSize) )
                 continue;
             if ( Lf_SetLastCutIsContained(pCutsR, nCutsR) )
                 continue;
-            p->CutCount[2]++;
+            pThr->CutCount[2]++;
             if ( p->pPars->fCutMin && Lf_CutComputeTruth(p, pCut0, pCut1, fComp0, fComp1, pCutsR[nCutsR], fIsXor) )
                 pCutsR[nCutsR]->Sign = Lf_CutGetSign(pCutsR[nCutsR]);
             if ( p->pPars->nLutSizeMux && p->pPars->nLutSizeMux == (int)pCutsR[nCutsR]->nLeaves && 
@@ -1333,6 +1389,31 @@ void Lf_ObjMergeOrder( Lf_Man_t * p, int iObj )
     // verify
     assert( nCutsR > 0 && nCutsR < nCutNum );
 //    assert( Lf_SetCheckArray(pCutsR, nCutsR) );
+    *pRequired = Required;
+    return nCutsR;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Records the best cuts of the node and stores its cutset.]
+
+  Description []
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static void Lf_ObjMergeOrderSave( Lf_Man_t * p, int iObj, Lf_Cut_t ** pCutsR, int nCutsR, int Required )
+{
+    Lf_Cut_t * pCutSet, * pCut0, * pCut2;
+    Gia_Obj_t * pObj = Gia_ManObj(p->pGia, iObj);
+    Lf_Bst_t * pBest = Lf_ObjReadBest(p, iObj);
+    float FlowRefs = Lf_ObjFlowRefs(p, iObj);
+    int nCutNum    = p->pPars->nCutNum;
+    int nCutWords  = p->nCutWords;
+    int i, iCutUsed;
+    float Value2 = -1;
     // delay cut
     assert( nCutsR == 1 || pCutsR[0]->Delay <= pCutsR[1]->Delay );
     pBest->Cut[0].fUsed = pBest->Cut[1].fUsed = 0;
@@ -1392,6 +1473,354 @@ void Lf_ObjMergeOrder( Lf_Man_t * p, int iObj )
             pCut0->nLeaves = LF_NO_LEAF;
     }
 }
+void Lf_ObjMergeOrder( Lf_Man_t * p, int iObj )
+{
+    word CutSet[LF_CUT_MAX][LF_CUT_WORDS] = {{0}};
+    Lf_Cut_t * pCutsR[LF_CUT_MAX];
+    int Required, nCutsR;
+    nCutsR = Lf_ObjMergeOrderCuts( p, p->pThrs, iObj, (Lf_Cut_t *)CutSet, pCutsR, &Required );
+    Lf_ObjMergeOrderSave( p, iObj, pCutsR, nCutsR, Required );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Parallel cut computation.]
+
+  Description [The cuts of a node depend on the cuts of its fanins and
+  its sibling, and on the best cuts of the nodes in its fanin cone, so 
+  the nodes of one level can compute their cuts concurrently. The level 
+  is processed in chunks. The threads compute the cuts of the nodes of 
+  the chunk into their result slots, taking no locks other than those 
+  of the truth table store. Then the main thread saves the cuts of each 
+  node and recycles the fanin cutsets in the topological order of the 
+  level. The previous cuts are not recycled while they are loaded. Only 
+  the delay and area flow rounds are parallel, because exact local area 
+  references and dereferences the cones of the best cuts.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+typedef struct Lf_ParMan_t_ Lf_ParMan_t; 
+typedef struct Lf_ParThr_t_ Lf_ParThr_t; 
+struct Lf_ParThr_t_
+{
+    Lf_ParMan_t *   pMan;            // the parallel manager
+    int             iThread;         // the thread number
+    int             fStarted;        // the thread is running (otherwise its share is computed by thread 0)
+};
+struct Lf_ParMan_t_
+{
+    Lf_Man_t *      p;               // the mapping manager
+    int             nThreads;        // the number of threads
+    int *           pNodes;          // the nodes of the current chunk
+    int             nNodes;          // the number of nodes of the current chunk
+    word *          pSlots;          // the cuts computed for each node
+    int *           pSlotCuts;       // the number of cuts of each node
+    int *           pSlotReqs;       // the required time of each node
+    Lf_ParThr_t     Thr[LF_PAR_THR_MAX];
+#ifdef ABC_USE_PTHREADS
+    int             iChunkCur;       // the current chunk (incremented to start the workers)
+    int             nThrStarted;     // the workers that are running
+    int             nThrDone;        // the workers that finished the current chunk
+    int             fStop;           // the workers should exit
+    pthread_mutex_t Mutex;
+    pthread_cond_t  CondStart;
+    pthread_cond_t  CondDone;
+#endif
+};
+
+/**Function*************************************************************
+
+  Synopsis    [Returns 1 if the round can be performed in parallel.]
+
+  Description [The CI arrival times of the boxes are updated during the 
+  round, and exact local area depends on the order of nodes.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static int Lf_ManParIsSupported( Lf_Man_t * p )
+{
+#ifndef ABC_USE_PTHREADS
+    return 0;
+#endif
+    return p->pPars->nProcNum > 1 && !p->fUseEla && p->pGia->pManTime == NULL;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Sorts the nodes by level.]
+
+  Description [A buffer has the level of its driver, because the arrival
+  time of the buffer is that of the driver.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static void Lf_ManParComputeLevels( Lf_Man_t * p )
+{
+    Gia_Man_t * pGia = p->pGia;
+    Gia_Obj_t * pObj;
+    int * pLevels = ABC_CALLOC( int, Gia_ManObjNum(pGia) );
+    int i, k, Level, nLevels = 0;
+    Gia_ManForEachAnd( pGia, pObj, i )
+    {
+        if ( Gia_ObjIsBuf(pObj) )
+        {
+            pLevels[i] = pLevels[Gia_ObjFaninId0(pObj, i)];
+            continue;
+        }
+        Level = Abc_MaxInt( pLevels[Gia_ObjFaninId0(pObj, i)], pLevels[Gia_ObjFaninId1(pObj, i)] );
+        if ( Gia_ObjIsMuxId(pGia, i) )
+            Level = Abc_MaxInt( Level, pLevels[Gia_ObjFaninId2(pGia, i)] );
+        if ( Gia_ObjSibl(pGia, i) )
+        {
+            assert( Gia_ObjSibl(pGia, i) < i );
+            Level = Abc_MaxInt( Level, pLevels[Gia_ObjSibl(pGia, i)] );
+        }
+        pLevels[i] = Level + 1;
+        nLevels = Abc_MaxInt( nLevels, Level + 1 );
+    }
+    // counting sort keeps the topological order in a level
+    Vec_IntFill( &p->vParLevels, nLevels + 2, 0 );
+    Gia_ManForEachAnd( pGia, pObj, i )
+        if ( !Gia_ObjIsBuf(pObj) )
+            Vec_IntAddToEntry( &p->vParLevels, pLevels[i] + 1, 1 );
+    for ( k = 1; k < Vec_IntSize(&p->vParLevels); k++ )
+        Vec_IntAddToEntry( &p->vParLevels, k, Vec_IntEntry(&p->vParLevels, k-1) );
+    Vec_IntFill( &p->vParNodes, Vec_IntEntryLast(&p->vParLevels), -1 );
+    Gia_ManForEachAnd( pGia, pObj, i )
+        if ( !Gia_ObjIsBuf(pObj) )
+        {
+            Vec_IntWriteEntry( &p->vParNodes, Vec_IntEntry(&p->vParLevels, pLevels[i]), i );
+            Vec_IntAddToEntry( &p->vParLevels, pLevels[i], 1 );
+        }
+    // restore the level starts
+    for ( k = Vec_IntSize(&p->vParLevels) - 1; k > 0; k-- )
+        Vec_IntWriteEntry( &p->vParLevels, k, Vec_IntEntry(&p->vParLevels, k-1) );
+    Vec_IntWriteEntry( &p->vParLevels, 0, 0 );
+    ABC_FREE( pLevels );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Computes the cuts of the share of the chunk.]
+
+  Description [Thread i takes the nodes i, i + nThreads, etc.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static void Lf_ManParMapShare( Lf_ParMan_t * pMan, int iThread )
+{
+    Lf_Man_t * p = pMan->p;
+    Lf_Thr_t * pThr = p->pThrs + iThread;
+    word CutSet[LF_CUT_MAX][LF_CUT_WORDS];
+    Lf_Cut_t * pCutsR[LF_CUT_MAX], * pSlot;
+    int i, k, nCutsR;
+    for ( i = iThread; i < pMan->nNodes; i += pMan->nThreads )
+    {
+        memset( CutSet, 0, sizeof(CutSet) );
+        nCutsR = Lf_ObjMergeOrderCuts( p, pThr, pMan->pNodes[i], (Lf_Cut_t *)CutSet, pCutsR, pMan->pSlotReqs + i );
+        pSlot = (Lf_Cut_t *)(pMan->pSlots + (size_t)i * p->nSetWords);
+        for ( k = 0; k < nCutsR; k++, pSlot = Lf_CutNext(pSlot, p->nCutWords) )
+            Lf_CutCopy( pSlot, pCutsR[k], p->nCutWords );
+        pMan->pSlotCuts[i] = nCutsR;
+    }
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Saves the cuts of a node computed in parallel.]
+
+  Description [Releases the fanin cutsets in the same order as the 
+  serial computation.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static void Lf_ManParSaveNode( Lf_ParMan_t * pMan, int i )
+{
+    Lf_Man_t * p = pMan->p;
+    Lf_Cut_t * pCutsR[LF_CUT_MAX], * pSlot, * pCut;
+    int k, iObj = pMan->pNodes[i];
+    Gia_Obj_t * pObj = Gia_ManObj( p->pGia, iObj );
+    Lf_ManReleaseSet( p, Gia_ObjFaninId0(pObj, iObj) );
+    Lf_ManReleaseSet( p, Gia_ObjFaninId1(pObj, iObj) );
+    if ( Gia_ObjSibl(p->pGia, iObj) )
+        Lf_ManReleaseSet( p, Gia_ObjSibl(p->pGia, iObj) );
+    if ( Gia_ObjIsMuxId(p->pGia, iObj) )
+        Lf_ManReleaseSet( p, Gia_ObjFaninId2(p->pGia, iObj) );
+    pSlot = (Lf_Cut_t *)(pMan->pSlots + (size_t)i * p->nSetWords);
+    Lf_CutSetForEachCut( p->nCutWords, pSlot, pCut, k, pMan->pSlotCuts[i] )
+        pCutsR[k] = pCut;
+    Lf_ObjMergeOrderSave( p, iObj, pCutsR, pMan->pSlotCuts[i], pMan->pSlotReqs[i] );
+}
+
+#ifdef ABC_USE_PTHREADS
+
+/**Function*************************************************************
+
+  Synopsis    [Worker thread.]
+
+  Description [Waits for the next chunk, computes its share, reports back.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static void * Lf_ManParWorkerThread( void * pArg )
+{
+    Lf_ParThr_t * pThr = (Lf_ParThr_t *)pArg;
+    Lf_ParMan_t * pMan = pThr->pMan;
+    int iChunk = 0;
+    while ( 1 )
+    {
+        pthread_mutex_lock( &pMan->Mutex );
+        while ( pMan->iChunkCur == iChunk && !pMan->fStop )
+            pthread_cond_wait( &pMan->CondStart, &pMan->Mutex );
+        iChunk = pMan->iChunkCur;
+        if ( pMan->fStop )
+        {
+            pthread_mutex_unlock( &pMan->Mutex );
+            return NULL;
+        }
+        pthread_mutex_unlock( &pMan->Mutex );
+        Lf_ManParMapShare( pMan, pThr->iThread );
+        pthread_mutex_lock( &pMan->Mutex );
+        if ( ++pMan->nThrDone == pMan->nThrStarted )
+            pthread_cond_signal( &pMan->CondDone );
+        pthread_mutex_unlock( &pMan->Mutex );
+    }
+    assert( 0 );
+    return NULL;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Computes the cuts of one chunk using all threads.]
+
+  Description []
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static void Lf_ManParMapChunk( Lf_ParMan_t * pMan )
+{
+    int i;
+    pthread_mutex_lock( &pMan->Mutex );
+    pMan->nThrDone = 0;
+    pMan->iChunkCur++;
+    pthread_cond_broadcast( &pMan->CondStart );
+    pthread_mutex_unlock( &pMan->Mutex );
+    // the main thread takes share 0 and the shares of the workers that did not start
+    pMan->p->pThrs[0].fParallel = 1;
+    Lf_ManParMapShare( pMan, 0 );
+    pMan->p->pThrs[0].fParallel = 0;
+    for ( i = 1; i < pMan->nThreads; i++ )
+        if ( !pMan->Thr[i].fStarted )
+            Lf_ManParMapShare( pMan, i );
+    pthread_mutex_lock( &pMan->Mutex );
+    while ( pMan->nThrDone < pMan->nThrStarted )
+        pthread_cond_wait( &pMan->CondDone, &pMan->Mutex );
+    pthread_mutex_unlock( &pMan->Mutex );
+}
+
+#endif
+
+/**Function*************************************************************
+
+  Synopsis    [Performs one mapping round in parallel.]
+
+  Description [Returns 0 if the round cannot be parallelized; the caller
+  then performs it serially. The result is the same as that of the 
+  serial round. Chunks with fewer nodes than threads are serial.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+int Lf_ManComputeMappingPar( Lf_Man_t * p )
+{
+#ifndef ABC_USE_PTHREADS
+    return 0;
+#else
+    Lf_ParMan_t * pMan;
+    pthread_t WorkerThread[LF_PAR_THR_MAX];
+    int i, k, iBeg, iEnd;
+    if ( !Lf_ManParIsSupported( p ) )
+        return 0;
+    pMan = ABC_CALLOC( Lf_ParMan_t, 1 );
+    pMan->p         = p;
+    pMan->nThreads  = Abc_MinInt( p->pPars->nProcNum, LF_PAR_THR_MAX );
+    pMan->pSlots    = ABC_ALLOC( word, (size_t)LF_PAR_CHUNK * p->nSetWords );
+    pMan->pSlotCuts = ABC_ALLOC( int, LF_PAR_CHUNK );
+    pMan->pSlotReqs = ABC_ALLOC( int, LF_PAR_CHUNK );
+    pthread_mutex_init( &pMan->Mutex, NULL );
+    pthread_cond_init( &pMan->CondStart, NULL );
+    pthread_cond_init( &pMan->CondDone, NULL );
+    for ( i = 1; i < pMan->nThreads; i++ )
+    {
+        p->pThrs[i].fParallel = 1;
+        pMan->Thr[i].pMan = pMan;
+        pMan->Thr[i].iThread = i;
+        pMan->Thr[i].fStarted = !pthread_create( WorkerThread + i, NULL, Lf_ManParWorkerThread, (void *)(pMan->Thr + i) );
+        pMan->nThrStarted += pMan->Thr[i].fStarted;
+    }
+    // map the levels
+    for ( k = 0; k + 1 < Vec_IntSize(&p->vParLevels); k++ )
+    {
+        iEnd = Vec_IntEntry( &p->vParLevels, k+1 );
+        for ( iBeg = Vec_IntEntry(&p->vParLevels, k); iBeg < iEnd; iBeg += pMan->nNodes )
+        {
+            pMan->pNodes = Vec_IntEntryP( &p->vParNodes, iBeg );
+            pMan->nNodes = Abc_MinInt( iEnd - iBeg, LF_PAR_CHUNK );
+            if ( pMan->nNodes < pMan->nThreads )
+            {
+                for ( i = 0; i < pMan->nNodes; i++ )
+                    Lf_ObjMergeOrder( p, pMan->pNodes[i] );
+                continue;
+            }
+            Lf_ManParMapChunk( pMan );
+            for ( i = 0; i < pMan->nNodes; i++ )
+                Lf_ManParSaveNode( pMan, i );
+        }
+    }
+    // stop the threads
+    pthread_mutex_lock( &pMan->Mutex );
+    pMan->fStop = 1;
+    pthread_cond_broadcast( &pMan->CondStart );
+    pthread_mutex_unlock( &pMan->Mutex );
+    for ( i = 1; i < pMan->nThreads; i++ )
+    {
+        if ( pMan->Thr[i].fStarted )
+            pthread_join( WorkerThread[i], NULL );
+        p->pThrs[i].fParallel = 0;
+    }
+    pthread_mutex_destroy( &pMan->Mutex );
+    pthread_cond_destroy( &pMan->CondStart );
+    pthread_cond_destroy( &pMan->CondDone );
+    ABC_FREE( pMan->pSlots );
+    ABC_FREE( pMan->pSlotCuts );
+    ABC_FREE( pMan->pSlotReqs );
+    ABC_FREE( pMan );
+    return 1;
+#endif
+}
 
 /**Function*************************************************************
 
@@ -1957,6 +2386,7 @@ Lf_Man_t * Lf_ManAlloc( Gia_Man_t * pGia, Jf_Par_t * pPars )
     p->vTtMem    = pPars->fCutMin ? Vec_MemAllocForTT( pPars->nLutSize, 0 ) : NULL;
     if ( pPars->fCutMin && pPars->fUseMux7 )
         Vec_MemAddMuxTT( p->vTtMem, pPars->nLutSize );
+    p->pThrs     = ABC_CALLOC( Lf_Thr_t, Abc_MaxInt(1, Abc_MinInt(pPars->nProcNum, LF_PAR_THR_MAX)) );
     p->pObjBests = ABC_CALLOC( Lf_Bst_t, Gia_ManAndNotBufNum(pGia) );
     Vec_IntGrow( &p->vFreeSets, (1<<14) );
     Vec_PtrGrow( &p->vFreePages, 256 );
@@ -1973,6 +2403,12 @@ Lf_Man_t * Lf_ManAlloc( Gia_Man_t * pGia, Jf_Par_t * pPars )
             Vec_IntWriteEntry( &p->vOffsets, i, k++ );
     assert( k == Gia_ManAndNotBufNum(pGia) );
     Lf_ManSetFlowRefs( pGia, &p->vFlowRefs, &p->vOffsets );
+    if ( pPars->nProcNum > 1 )
+    {
+        Lf_ManParComputeLevels( p );
+        if ( pPars->fCutMin )
+            p->pTtStore = If_TtStoreStart( p->vTtMem );
+    }
     if ( pPars->pTimesArr )
         for ( i = 0; i < Gia_ManPiNum(pGia); i++ )
             Vec_IntWriteEntry( &p->vCiArrivals, i, pPars->pTimesArr[i] );
@@ -1982,6 +2418,7 @@ void Lf_ManFree( Lf_Man_t * p )
 {
     ABC_FREE( p->pPars->pTimesArr );
     ABC_FREE( p->pPars->pTimesReq );
+    If_TtStoreStop( p->pTtStore );
     if ( p->pPars->fCutMin )
         Vec_MemHashFree( p->vTtMem );
     if ( p->pPars->fCutMin )
@@ -2003,6 +2440,9 @@ void Lf_ManFree( Lf_Man_t * p )
     ABC_FREE( p->vMapRefs.pArray );
     ABC_FREE( p->vSwitches.pArray );
     ABC_FREE( p->vCiArrivals.pArray );
+    ABC_FREE( p->vParNodes.pArray );
+    ABC_FREE( p->vParLevels.pArray );
+    ABC_FREE( p->pThrs );
     ABC_FREE( p->pObjBests );
     ABC_FREE( p );
 }
@@ -2046,6 +2486,7 @@ void Lf_ManSetDefaultPars( Jf_Par_t * pPars )
     pPars->fVeryVerbose =  0;
     pPars->nLutSizeMax  =  LF_LEAF_MAX;
     pPars->nCutNumMax   =  LF_CUT_MAX;
+    pPars->nProcNumMax  =  LF_PAR_THR_MAX;
 }
 void Lf_ManPrintStats( Lf_Man_t * p, char * pTitle )
 {
@@ -2077,6 +2518,8 @@ void Lf_ManPrintInit( Lf_Man_t * p )
     printf( "Delay = %d  ",   p->pPars->DelayTarget );
     printf( "CutMin = %d  ",  p->pPars->fCutMin );
     printf( "Coarse = %d  ",  p->pPars->fCoarsen );
+    if ( p->pPars->nProcNum > 1 )
+    printf( "Threads = %d  ", p->pPars->nProcNum );
     printf( "Cut/Set = %d/%d Bytes", 8*p->nCutWords, 8*p->nSetWords );
     printf( "\n" );
     printf( "Computing cuts...\r" );
@@ -2088,7 +2531,7 @@ void Lf_ManPrintQuit( Lf_Man_t * p, Gia_Man_t * pNew )
     float MemMan   = 1.0 * sizeof(int) * (2 * Gia_ManObjNum(p->pGia) + 3 * Gia_ManAndNotBufNum(p->pGia)) / (1<<20); // offset, required, cutsets, maprefs, flowrefs
     float MemCutsB = 1.0 * (p->vStoreOld.MaskPage + 1) * (Vec_PtrSize(&p->vFreePages) + Vec_PtrSize(&p->vStoreOld.vPages)) / (1<<20) + 1.0 * sizeof(Lf_Bst_t) * Gia_ManAndNotBufNum(p->pGia) / (1<<20);
     float MemCutsF = 1.0 * sizeof(word) * p->nSetWords * (1<<LF_LOG_PAGE) * Vec_PtrSize(&p->vMemSets) / (1<<20);
-    float MemTt    = p->vTtMem ? Vec_MemMemory(p->vTtMem) / (1<<20) : 0;
+    float MemTt    = p->pTtStore ? If_TtStoreMemory(p->pTtStore) / (1<<20) : p->vTtMem ? Vec_MemMemory(p->vTtMem) / (1<<20) : 0;
     float MemMap   = Vec_IntMemory(pNew->vMapping) / (1<<20);
     if ( p->CutCount[0] == 0 )
         p->CutCount[0] = 1;
@@ -2138,8 +2581,10 @@ void Lf_ManPrintQuit( Lf_Man_t * p, Gia_Man_t * pNew )
 void Lf_ManComputeMapping( Lf_Man_t * p )
 {
     Gia_Obj_t * pObj;
-    int i, arrTime;
+    int i, k, arrTime, fParallel = Lf_ManParIsSupported( p );
     assert( p->vStoreNew.iCur == 0 );
+    // previous cuts are recycled while loading only if they are loaded in the order they were saved
+    p->fRecycle = !fParallel && !p->fParStore;
     Lf_ManSetCutRefs( p );
     if ( p->pGia->pManTime != NULL )
     {
@@ -2165,12 +2610,21 @@ void Lf_ManComputeMapping( Lf_Man_t * p )
         }
 //        Tim_ManPrint( p->pGia->pManTime );
     }
-    else
+    else if ( !fParallel || !Lf_ManComputeMappingPar( p ) )
     {
         Gia_ManForEachAnd( p->pGia, pObj, i )
             if ( !Gia_ObjIsBuf(pObj) )
                 Lf_ObjMergeOrder( p, i );
     }
+    p->fParStore = fParallel;
+    for ( i = 0; i < Abc_MaxInt(1, Abc_MinInt(p->pPars->nProcNum, LF_PAR_THR_MAX)); i++ )
+    {
+        for ( k = 0; k < 3; k++ )
+            p->CutCount[k] += p->pThrs[i].CutCount[k];
+        p->nTimeFails += p->pThrs[i].nTimeFails;
+        memset( p->pThrs[i].CutCount, 0, sizeof(double) * 3 );
+        p->pThrs[i].nTimeFails = 0;
+    }
     Lf_MemRecycle( &p->vStoreOld );
     ABC_SWAP( Lf_Mem_t, p->vStoreOld, p->vStoreNew );
     if ( p->fUseEla )
@@ -585,7 +585,8 @@ extern Abc_Ntk_t *Abc_NtkFromAigPhase(Aig_Man_t *pMan);
 extern int ymc_hello_wrapper();
 extern int ymc_try_metis_wrapper();
 extern int ymc_test_yaig_wrapper();
-extern Abc_Ntk_t* ymc_pif_wrapper(Abc_Ntk_t* pNtk, uint32_t nParts, uint32_t sCluster,  char* libFileName, char* dirName);
+extern Abc_Ntk_t* ymc_pif_wrapper(Abc_Ntk_t* pNtk, uint32_t nParts, uint32_t sCluster, uint32_t nThreads, uint32_t nIters, char* libFileName, char* dirName, char* dumpFormat, int fCalibrate, uint32_t nFringe, int fEco);
+extern void ymc_pif_stop_wrapper();
 //int Dau_DsdDecompose( word * pTruth, int nVarsInit, int fSplitPrime, int fWriteTruth, char * pRes );
 static void timer(int reset)
 {
@@ -621,12 +622,18 @@ static int Abc_CommandPif(Abc_Frame_t *pAbc, int argc, char **argv)
     extern void Abc_NtkCecFraig(Abc_Ntk_t * pNtk1, Abc_Ntk_t * pNtk2, int nSeconds, int fVerbose);
     uint32_t nParts = 0;
     uint32_t sCluster = 0;
+    uint32_t nThreads = 1;
+    uint32_t nIters = 1;
     uint32_t c;
     char* dirName = NULL;
     char* FileName = NULL;
+    char* dumpFormat = NULL;
+    uint32_t nFringe = 0;
+    int fCalibrate = 0;
+    int fEco = 0;
 
     Extra_UtilGetoptReset();
-    while ( ( c = Extra_UtilGetopt( argc, argv, "Nsdlh" ) ) != EOF )
+    while ( ( c = Extra_UtilGetopt( argc, argv, "NPIFsdlwCEh" ) ) != EOF )
     {
         switch ( c )
         {
@@ -645,6 +652,48 @@ static int Abc_CommandPif(Abc_Frame_t *pAbc, int argc, char **argv)
             }
             Abc_Print( -2, "Partition an AIG into %d subgraphs.\n",nParts );
             break;
+        case 'P':
+            if ( globalUtilOptind >= argc )
+            {
+                Abc_Print( -1, "Command line switch \"-P\" should be followed by a positive integer.\n" );
+                goto usage;
+            }
+            nThreads = atoi(argv[globalUtilOptind]);
+            globalUtilOptind++;
+            if ( (int)nThreads < 1 )
+            {
+                Abc_Print( -1, "Invalid nThreads.(nThreads >= 1)\n" );
+                goto usage;
+            }
+            break;
+        case 'I':
+            if ( globalUtilOptind >= argc )
+            {
+                Abc_Print( -1, "Command line switch \"-I\" should be followed by a positive integer.\n" );
+                goto usage;
+            }
+            nIters = atoi(argv[globalUtilOptind]);
+            globalUtilOptind++;
+            if ( (int)nIters < 1 )
+            {
+                Abc_Print( -1, "Invalid nIters.(nIters >= 1)\n" );
+                goto usage;
+            }
+            break;
+        case 'F':
+            if ( globalUtilOptind >= argc )
+            {
+                Abc_Print( -1, "Command line switch \"-F\" should be followed by a non-negative integer.\n" );
+                goto usage;
+            }
+            nFringe = atoi(argv[globalUtilOptind]);
+            globalUtilOptind++;
+            if ( (int)nFringe < 0 )
+            {
+                Abc_Print( -1, "Invalid nFringe.(nFringe >= 0)\n" );
+                goto usage;
+            }
+            break;
         case 's':
             if ( globalUtilOptind >= argc )
             {
@@ -673,6 +722,26 @@ static int Abc_CommandPif(Abc_Frame_t *pAbc, int argc, char **argv)
             FileName = argv[globalUtilOptind];
             globalUtilOptind++;
             break;
+        case 'w':
+            if (globalUtilOptind >= argc)
+            {
+                Abc_Print(-1, "Command line switch \"-w\" should be followed by a format (blif, aig or v).\n");
+                goto usage;
+            }
+            dumpFormat = argv[globalUtilOptind];
+            globalUtilOptind++;
+            if (strcmp(dumpFormat, "blif") && strcmp(dumpFormat, "aig") && strcmp(dumpFormat, "v"))
+            {
+                Abc_Print(-1, "Unknown format \"%s\" of the partition dump.\n", dumpFormat);
+                goto usage;
+            }
+            break;
+        case 'C':
+            fCalibrate ^= 1;
+            break;
+        case 'E':
+            fEco ^= 1;
+            break;
         case 'h':
             goto usage;
         default:
@@ -727,7 +796,7 @@ static int Abc_CommandPif(Abc_Frame_t *pAbc, int argc, char **argv)
         printf("strash & balance spent time: %f\n\n", time);
     }
 
-    pNtkRes = ymc_pif_wrapper(pNtk, nParts, sCluster, FileName, dirName);
+    pNtkRes = ymc_pif_wrapper(pNtk, nParts, sCluster, nThreads, nIters, FileName, dirName, dumpFormat, fCalibrate, nFringe, fEco);
     if (pNtkRes == NULL)
     {
         Abc_Print(-1, "pif has failed.\n");
@@ -748,12 +817,18 @@ static int Abc_CommandPif(Abc_Frame_t *pAbc, int argc, char **argv)
     return 0;
 
 usage:
-    Abc_Print( -2, "usage: pif [-N num] [-d dir] [-l file] [-s size] [-h]\n" );
+    Abc_Print( -2, "usage: pif [-N num] [-P num] [-I num] [-F num] [-w fmt] [-d dir] [-l file] [-s size] [-CEh]\n" );
     Abc_Print( -2, "\t           partition an AIG into subgraphs\n" );
     Abc_Print( -2, "\t-N num   : the number of subgraphs [default = adaptive]\n");
-    Abc_Print( -2, "\t-d dir   : the directory name for output network(s)\n");
+    Abc_Print( -2, "\t-P num   : the number of mapping threads in the work-stealing pool [default = %d]\n", 1);
+    Abc_Print( -2, "\t-I num   : the max number of rounds re-mapping the parts with changed boundary timing [default = %d]\n", 1);
+    Abc_Print( -2, "\t-F num   : the levels of fanin logic copied across a cut edge for LUT packing [default = %d]\n", 0);
+    Abc_Print( -2, "\t-w fmt   : write the partitions as blif, aig or v in the background [default = no]\n");
+    Abc_Print( -2, "\t-d dir   : the directory name for the partitions written by -w [default = .]\n");
     Abc_Print( -2, "\t-l file  : the DSD library file\n");
     Abc_Print( -2, "\t-s size  : the upper bound of the merged cluster size [default = adaptive]\n");
+    Abc_Print( -2, "\t-C       : toggle refining the part cost model <DSD library>.cost with the measured mapping times [default = %s]\n", fCalibrate? "yes": "no" );
+    Abc_Print( -2, "\t-E       : toggle reusing the partition and the unchanged mapped parts of the previous pif -E run [default = %s]\n", fEco? "yes": "no" );
     Abc_Print( -2, "\t-h       : print the command usage\n");
     return 1;
 }
@@ -1721,6 +1796,7 @@ void Abc_End(Abc_Frame_t *pAbc)
     Gia_ManStopP(&pAbc->pGiaSaved);
     if (Abc_NtkRecIsRunning3())
         Abc_NtkRecStop3();
+    ymc_pif_stop_wrapper();
 }
 
 /**Function*************************************************************
@@ -7192,16 +7268,18 @@ usage:
 ***********************************************************************/
 int Abc_CommandTestNpn(Abc_Frame_t *pAbc, int argc, char **argv)
 {
-    extern int Abc_NpnTest(char *pFileName, int NpnType, int nVarNum, int fDumpRes, int fBinary, int fVerbose);
+    extern int Abc_NpnTest(char *pFileName, int NpnType, int nVarNum, int nThreads, int fCheck, int fDumpRes, int fBinary, int fVerbose);
     char *pFileName;
     int c;
     int fVerbose = 0;
     int NpnType = 0;
     int nVarNum = -1;
+    int nThreads = 1;
+    int fCheck = 0;
     int fDumpRes = 0;
     int fBinary = 0;
     Extra_UtilGetoptReset();
-    while ((c = Extra_UtilGetopt(argc, argv, "ANdbvh")) != EOF)
+    while ((c = Extra_UtilGetopt(argc, argv, "ANPcdbvh")) != EOF)
     {
         switch (c)
         {
@@ -7227,6 +7305,20 @@ int Abc_CommandTestNpn(Abc_Frame_t *pAbc, int argc, char **argv)
             if (nVarNum < 0)
                 goto usage;
             break;
+        case 'P':
+            if (globalUtilOptind >= argc)
+            {
+                Abc_Print(-1, "Command line switch \"-P\" should be followed by an integer.\n");
+                goto usage;
+            }
+            nThreads = atoi(argv[globalUtilOptind]);
+            globalUtilOptind++;
+            if (nThreads < 1)
+                goto usage;
+            break;
+        case 'c':
+            fCheck ^= 1;
+            break;
         case 'd':
             fDumpRes ^= 1;
             break;
@@ -7255,11 +7347,11 @@ int Abc_CommandTestNpn(Abc_Frame_t *pAbc, int argc, char **argv)
     // get the output file name
     pFileName = argv[globalUtilOptind];
     // call the testbench
-    Abc_NpnTest(pFileName, NpnType, nVarNum, fDumpRes, fBinary, fVerbose);
+    Abc_NpnTest(pFileName, NpnType, nVarNum, nThreads, fCheck, fDumpRes, fBinary, fVerbose);
     return 0;
 
 usage:
-    Abc_Print(-2, "usage: testnpn [-AN <num>] [-dbvh] <file>\n");
+    Abc_Print(-2, "usage: testnpn [-ANP <num>] [-cdbvh] <file>\n");
     Abc_Print(-2, "\t           testbench for computing (semi-)canonical forms\n");
     Abc_Print(-2, "\t           of completely-specified Boolean functions up to 16 varibles\n");
     Abc_Print(-2, "\t-A <num> : semi-caninical form computation algorithm [default = %d]\n", NpnType);
@@ -7275,7 +7367,10 @@ usage:
     Abc_Print(-2, "\t               9: adjustable algorithm (heuristic) by XueGong Zhou at Fudan University, Shanghai\n");
     Abc_Print(-2, "\t              10: adjustable algorithm (exact)     by XueGong Zhou at Fudan University, Shanghai\n");
     Abc_Print(-2, "\t              11: new cost-aware exact algorithm   by XueGong Zhou at Fudan University, Shanghai\n");
+    Abc_Print(-2, "\t              12: batched fast hybrid semi-canonical form (same as 5)\n");
     Abc_Print(-2, "\t-N <num> : the number of support variables (binary files only) [default = unused]\n");
+    Abc_Print(-2, "\t-P <num> : the number of threads for the batched form [default = %d]\n", nThreads);
+    Abc_Print(-2, "\t-c       : toggle comparing the batched form with the scalar one [default = %s]\n", fCheck ? "yes" : "no");
     Abc_Print(-2, "\t-d       : toggle dumping resulting functions into a file [default = %s]\n", fDumpRes ? "yes" : "no");
     Abc_Print(-2, "\t-b       : toggle dumping in binary format [default = %s]\n", fBinary ? "yes" : "no");
     Abc_Print(-2, "\t-v       : toggle verbose printout [default = %s]\n", fVerbose ? "yes" : "no");
@@ -19064,7 +19159,7 @@ int Abc_CommandIf(Abc_Frame_t *pAbc, int argc, char **argv)
     If_ManSetDefaultPars(pPars);
     pPars->pLutLib = (If_LibLut_t *)Abc_FrameReadLibLut();
     Extra_UtilGetoptReset();
-    while ((c = Extra_UtilGetopt(argc, argv, "KCFAGRNTXYDEWSqaflepmrsdbgxyuojiktncvh")) != EOF)
+    while ((c = Extra_UtilGetopt(argc, argv, "KCFAGRNTPMXYDEWSIOqaflepmrsdbgxyuojiktncvh")) != EOF)
     {
         switch (c)
         {
@@ -19158,6 +19253,28 @@ int Abc_CommandIf(Abc_Frame_t *pAbc, int argc, char **argv)
             if (pPars->nStructType < 0 || pPars->nStructType > 2)
                 goto usage;
             break;
+        case 'P':
+            if (globalUtilOptind >= argc)
+            {
+                Abc_Print(-1, "Command line switch \"-P\" should be followed by a positive integer.\n");
+                goto usage;
+            }
+            pPars->nThreads = atoi(argv[globalUtilOptind]);
+            globalUtilOptind++;
+            if (pPars->nThreads < 1)
+                goto usage;
+            break;
+        case 'M':
+            if (globalUtilOptind >= argc)
+            {
+                Abc_Print(-1, "Command line switch \"-M\" should be followed by a positive integer.\n");
+                goto usage;
+            }
+            pPars->nMemLimit = atoi(argv[globalUtilOptind]);
+            globalUtilOptind++;
+            if (pPars->nMemLimit < 0)
+                goto usage;
+            break;
         case 'X':
             if (globalUtilOptind >= argc)
             {
@@ -19227,6 +19344,24 @@ int Abc_CommandIf(Abc_Frame_t *pAbc, int argc, char **argv)
                 goto usage;
             }
             break;
+        case 'I':
+            if (globalUtilOptind >= argc)
+            {
+                Abc_Print(-1, "Command line switch \"-I\" should be followed by a file name.\n");
+                goto usage;
+            }
+            pPars->pCutDbIn = argv[globalUtilOptind];
+            globalUtilOptind++;
+            break;
+        case 'O':
+            if (globalUtilOptind >= argc)
+            {
+                Abc_Print(-1, "Command line switch \"-O\" should be followed by a file name.\n");
+                goto usage;
+            }
+            pPars->pCutDbOut = argv[globalUtilOptind];
+            globalUtilOptind++;
+            break;
         case 'q':
             pPars->fPreprocess ^= 1;
             break;
@@ -19580,7 +19715,7 @@ usage:
         sprintf(LutSize, "library");
     else
         sprintf(LutSize, "%d", pPars->nLutSize);
-    Abc_Print(-2, "usage: if [-KCFAGRNTXY num] [-DEW float] [-S str] [-qarlepmsdbgxyuojiktncvh]\n");
+    Abc_Print(-2, "usage: if [-KCFAGRNTPMXY num] [-DEW float] [-S str] [-IO file] [-qarlepmsdbgxyuojiktncvh]\n");
     Abc_Print(-2, "\t           performs FPGA technology mapping of the network\n");
     Abc_Print(-2, "\t-K num   : the number of LUT inputs (2 < num < %d) [default = %s]\n", IF_MAX_LUTSIZE + 1, LutSize);
     Abc_Print(-2, "\t-C num   : the max number of priority cuts (0 < num < 2^12) [default = %d]\n", pPars->nCutsMax);
@@ -19590,12 +19725,16 @@ usage:
     Abc_Print(-2, "\t-R num   : the delay relaxation ratio (num >= 0) [default = %d]\n", pPars->nRelaxRatio);
     Abc_Print(-2, "\t-N num   : the max size of non-decomposable nodes [default = unused]\n", pPars->nNonDecLimit);
     Abc_Print(-2, "\t-T num   : the type of LUT structures [default = any]\n");
+    Abc_Print(-2, "\t-P num   : the number of threads for delay-oriented cut enumeration [default = %d]\n", pPars->nThreads);
+    Abc_Print(-2, "\t-M num   : the memory limit in MB, enforced by using fewer cuts (0 = unlimited) [default = %d]\n", pPars->nMemLimit);
     Abc_Print(-2, "\t-X num   : delay of AND-gate in LUT library units [default = %d]\n", pPars->nAndDelay);
     Abc_Print(-2, "\t-Y num   : area of AND-gate in LUT library units [default = %d]\n", pPars->nAndArea);
     Abc_Print(-2, "\t-D float : sets the delay constraint for the mapping [default = %s]\n", Buffer);
     Abc_Print(-2, "\t-E float : sets epsilon used for tie-breaking [default = %f]\n", pPars->Epsilon);
     Abc_Print(-2, "\t-W float : sets wire delay between adjects LUTs [default = %f]\n", pPars->WireDelay);
     Abc_Print(-2, "\t-S str   : string representing the LUT structure [default = %s]\n", pPars->pLutStruct ? pPars->pLutStruct : "not used");
+    Abc_Print(-2, "\t-I file  : reuses the cuts of the unchanged nodes from this cut database [default = %s]\n", pPars->pCutDbIn ? pPars->pCutDbIn : "not used");
+    Abc_Print(-2, "\t-O file  : writes the cuts of the first mapping round into this cut database [default = %s]\n", pPars->pCutDbOut ? pPars->pCutDbOut : "not used");
     Abc_Print(-2, "\t-q       : toggles preprocessing using several starting points [default = %s]\n", pPars->fPreprocess ? "yes" : "no");
     Abc_Print(-2, "\t-a       : toggles area-oriented mapping [default = %s]\n", pPars->fArea ? "yes" : "no");
     Abc_Print(-2, "\t-r       : enables expansion/reduction of the best cuts [default = %s]\n", pPars->fExpRed ? "yes" : "no");
@@ -19763,15 +19902,18 @@ int Abc_CommandDsdSave(Abc_Frame_t *pAbc, int argc, char **argv)
     char *FileName;
     char **pArgvNew;
     int nArgcNew;
-    int c, fSecond = 0;
+    int c, fSecond = 0, fMmap = 0;
     Extra_UtilGetoptReset();
-    while ((c = Extra_UtilGetopt(argc, argv, "bh")) != EOF)
+    while ((c = Extra_UtilGetopt(argc, argv, "bmh")) != EOF)
     {
         switch (c)
         {
         case 'b':
             fSecond ^= 1;
             break;
+        case 'm':
+            fMmap ^= 1;
+            break;
         case 'h':
             goto usage;
         default:
@@ -19794,7 +19936,10 @@ int Abc_CommandDsdSave(Abc_Frame_t *pAbc, int argc, char **argv)
             Abc_Print(-1, "The DSD manager is not started.\n");
             return 1;
         }
-        If_DsdManSave((If_DsdMan_t *)Abc_FrameReadManDsd2(), FileName);
+        if (fMmap)
+            If_DsdManSaveMmap((If_DsdMan_t *)Abc_FrameReadManDsd2(), FileName);
+        else
+            If_DsdManSave((If_DsdMan_t *)Abc_FrameReadManDsd2(), FileName);
     }
     else
     {
@@ -19803,14 +19948,18 @@ int Abc_CommandDsdSave(Abc_Frame_t *pAbc, int argc, char **argv)
             Abc_Print(-1, "The DSD manager is not started.\n");
             return 1;
         }
-        If_DsdManSave((If_DsdMan_t *)Abc_FrameReadManDsd(), FileName);
+        if (fMmap)
+            If_DsdManSaveMmap((If_DsdMan_t *)Abc_FrameReadManDsd(), FileName);
+        else
+            If_DsdManSave((If_DsdMan_t *)Abc_FrameReadManDsd(), FileName);
     }
     return 0;
 
 usage:
-    Abc_Print(-2, "usage: dsd_save [-bh] <file>\n");
+    Abc_Print(-2, "usage: dsd_save [-bmh] <file>\n");
     Abc_Print(-2, "\t         saves DSD manager into a file\n");
     Abc_Print(-2, "\t-b     : toggles processing second manager [default = %s]\n", fSecond ? "yes" : "no");
+    Abc_Print(-2, "\t-m     : toggles writing the image for memory-mapped loading [default = %s]\n", fMmap ? "yes" : "no");
     Abc_Print(-2, "\t-h     : print the command usage\n");
     Abc_Print(-2, "\t<file> : (optional) file name to write\n");
     return 1;
@@ -19831,17 +19980,20 @@ int Abc_CommandDsdLoad(Abc_Frame_t *pAbc, int argc, char **argv)
 {
     char *FileName, *pTemp;
     char **pArgvNew;
-    int c, nArgcNew, fSecond = 0;
+    int c, nArgcNew, fSecond = 0, fMmap = 0;
     FILE *pFile;
     If_DsdMan_t *pDsdMan;
     Extra_UtilGetoptReset();
-    while ((c = Extra_UtilGetopt(argc, argv, "bh")) != EOF)
+    while ((c = Extra_UtilGetopt(argc, argv, "bmh")) != EOF)
     {
         switch (c)
         {
         case 'b':
             fSecond ^= 1;
             break;
+        case 'm':
+            fMmap ^= 1;
+            break;
         case 'h':
             goto usage;
         default:
@@ -19873,7 +20025,7 @@ int Abc_CommandDsdLoad(Abc_Frame_t *pAbc, int argc, char **argv)
     if (fSecond)
     {
         Abc_FrameSetManDsd2(NULL);
-        pDsdMan = If_DsdManLoad(FileName);
+        pDsdMan = fMmap ? If_DsdManLoadMmap(FileName, 1) : If_DsdManLoad(FileName);
         if (pDsdMan == NULL)
             return 1;
         Abc_FrameSetManDsd2(pDsdMan);
@@ -19881,7 +20033,7 @@ int Abc_CommandDsdLoad(Abc_Frame_t *pAbc, int argc, char **argv)
     else
     {
         Abc_FrameSetManDsd(NULL);
-        pDsdMan = If_DsdManLoad(FileName);
+        pDsdMan = fMmap ? If_DsdManLoadMmap(FileName, 1) : If_DsdManLoad(FileName);
         if (pDsdMan == NULL)
             return 1;
         Abc_FrameSetManDsd(pDsdMan);
@@ -19889,9 +20041,10 @@ int Abc_CommandDsdLoad(Abc_Frame_t *pAbc, int argc, char **argv)
     return 0;
 
 usage:
-    Abc_Print(-2, "usage: dsd_load [-bh] <file>\n");
+    Abc_Print(-2, "usage: dsd_load [-bmh] <file>\n");
     Abc_Print(-2, "\t         loads DSD manager from file\n");
     Abc_Print(-2, "\t-b     : toggles processing second manager [default = %s]\n", fSecond ? "yes" : "no");
+    Abc_Print(-2, "\t-m     : toggles memory-mapping the image written by \"dsd_save -m\" [default = %s]\n", fMmap ? "yes" : "no");
     Abc_Print(-2, "\t-h     : print the command usage\n");
     Abc_Print(-2, "\t<file> : file name to read\n");
     return 1;
@@ -20058,11 +20211,11 @@ usage:
 ***********************************************************************/
 int Abc_CommandDsdMatch(Abc_Frame_t *pAbc, int argc, char **argv)
 {
-    char *pStruct = NULL;
+    char *pStruct = NULL, *pFileCkpt = NULL;
     int c, fVerbose = 0, fFast = 0, fAdd = 0, fSpec = 0, LutSize = 0, nConfls = 10000, nProcs = 1;
     If_DsdMan_t *pDsdMan = (If_DsdMan_t *)Abc_FrameReadManDsd();
     Extra_UtilGetoptReset();
-    while ((c = Extra_UtilGetopt(argc, argv, "KCPSfasvh")) != EOF)
+    while ((c = Extra_UtilGetopt(argc, argv, "KCPSFfasvh")) != EOF)
     {
         switch (c)
         {
@@ -20104,6 +20257,15 @@ int Abc_CommandDsdMatch(Abc_Frame_t *pAbc, int argc, char **argv)
             pStruct = argv[globalUtilOptind];
             globalUtilOptind++;
             break;
+        case 'F':
+            if (globalUtilOptind >= argc)
+            {
+                Abc_Print(-1, "Command line switch \"-F\" should be followed by a file name.\n");
+                goto usage;
+            }
+            pFileCkpt = argv[globalUtilOptind];
+            globalUtilOptind++;
+            break;
         case 'f':
             fFast ^= 1;
             break;
@@ -20137,12 +20299,14 @@ int Abc_CommandDsdMatch(Abc_Frame_t *pAbc, int argc, char **argv)
         }
         Id_DsdManTuneStr(pDsdMan, pStruct, nConfls, nProcs, fVerbose);
     }
+    else if (nProcs > 1 || pFileCkpt)
+        If_DsdManTunePar(pDsdMan, LutSize, fFast, fAdd, fSpec, nProcs, pFileCkpt, fVerbose);
     else
         If_DsdManTune(pDsdMan, LutSize, fFast, fAdd, fSpec, fVerbose);
     return 0;
 
 usage:
-    Abc_Print(-2, "usage: dsd_match [-KCP num] [-fasvh] [-S str]\n");
+    Abc_Print(-2, "usage: dsd_match [-KCP num] [-fasvh] [-S str] [-F file]\n");
     Abc_Print(-2, "\t         matches DSD structures with the given cell\n");
     Abc_Print(-2, "\t-K num : LUT size used for tuning [default = %d]\n", LutSize);
     Abc_Print(-2, "\t-C num : the maximum number of conflicts [default = %d]\n", nConfls);
@@ -20152,6 +20316,7 @@ usage:
     Abc_Print(-2, "\t-s     : toggles using specialized check [default = %s]\n", fSpec ? "yes" : "no");
     Abc_Print(-2, "\t-v     : toggles verbose output [default = %s]\n", fVerbose ? "yes" : "no");
     Abc_Print(-2, "\t-S str : string representing programmable cell [default = %s]\n", pStruct ? pStruct : "not used");
+    Abc_Print(-2, "\t-F file: checkpoint file to resume LUT tuning from [default = %s]\n", pFileCkpt ? pFileCkpt : "not used");
     Abc_Print(-2, "\t-h     : print the command usage\n");
     return 1;
 }
@@ -20241,9 +20406,10 @@ usage:
 int Abc_CommandDsdFilter(Abc_Frame_t *pAbc, int argc, char **argv)
 {
     If_DsdMan_t *pDsd = (If_DsdMan_t *)Abc_FrameReadManDsd();
-    int c, nLimit = 0, nLutSize = -1, fCleanOccur = 0, fCleanMarks = 0, fInvMarks = 0, fUnate = 0, fThresh = 0, fThreshHeuristic = 0, fVerbose = 0;
+    char *pFileCkpt = NULL;
+    int c, nLimit = 0, nLutSize = -1, nProcs = 1, fCleanOccur = 0, fCleanMarks = 0, fInvMarks = 0, fUnate = 0, fThresh = 0, fThreshHeuristic = 0, fVerbose = 0;
     Extra_UtilGetoptReset();
-    while ((c = Extra_UtilGetopt(argc, argv, "LKomiutsvh")) != EOF)
+    while ((c = Extra_UtilGetopt(argc, argv, "LKPFomiutsvh")) != EOF)
     {
         switch (c)
         {
@@ -20265,6 +20431,24 @@ int Abc_CommandDsdFilter(Abc_Frame_t *pAbc, int argc, char **argv)
             nLutSize = atoi(argv[globalUtilOptind]);
             globalUtilOptind++;
             break;
+        case 'P':
+            if (globalUtilOptind >= argc)
+            {
+                Abc_Print(-1, "Command line switch \"-P\" should be followed by a floating point number.\n");
+                goto usage;
+            }
+            nProcs = atoi(argv[globalUtilOptind]);
+            globalUtilOptind++;
+            break;
+        case 'F':
+            if (globalUtilOptind >= argc)
+            {
+                Abc_Print(-1, "Command line switch \"-F\" should be followed by a file name.\n");
+                goto usage;
+            }
+            pFileCkpt = argv[globalUtilOptind];
+            globalUtilOptind++;
+            break;
         case 'o':
             fCleanOccur ^= 1;
             break;
@@ -20297,6 +20481,11 @@ int Abc_CommandDsdFilter(Abc_Frame_t *pAbc, int argc, char **argv)
         Abc_Print(-1, "The DSD manager is not started.\n");
         return 0;
     }
+    if ((nProcs > 1 || pFileCkpt) && (nLimit > 0 || fInvMarks || fUnate + fThresh + fThreshHeuristic != 1))
+    {
+        Abc_Print(-1, "Switches \"-P\" and \"-F\" apply only to marking with exactly one of \"-u\", \"-t\" or \"-s\" (without \"-L\" and \"-i\").\n");
+        return 1;
+    }
     if (nLimit > 0)
         Abc_FrameSetManDsd(If_DsdManFilter(pDsd, nLimit));
     if (nLutSize >= 0)
@@ -20308,16 +20497,20 @@ int Abc_CommandDsdFilter(Abc_Frame_t *pAbc, int argc, char **argv)
     if (fInvMarks)
         If_DsdManInvertMarks(pDsd, fVerbose);
 #ifdef ABC_USE_CUDD
+    else if (nLimit == 0 && fUnate + fThresh + fThreshHeuristic == 1 && (nProcs > 1 || pFileCkpt))
+        Id_DsdManTuneThreshPar(pDsd, fUnate, fThresh, fThreshHeuristic, nProcs, pFileCkpt, fVerbose);
     else if (nLimit == 0)
         Id_DsdManTuneThresh(pDsd, fUnate, fThresh, fThreshHeuristic, fVerbose);
 #endif
     return 0;
 
 usage:
-    Abc_Print(-2, "usage: dsd_filter [-LK num] [-omiutsvh]\n");
+    Abc_Print(-2, "usage: dsd_filter [-LKP num] [-F file] [-omiutsvh]\n");
     Abc_Print(-2, "\t         filtering structured and modifying parameters of DSD manager\n");
     Abc_Print(-2, "\t-L num : remove structures with fewer occurrences that this [default = %d]\n", nLimit);
     Abc_Print(-2, "\t-K num : new LUT size to set for the DSD manager [default = %d]\n", nLutSize);
+    Abc_Print(-2, "\t-P num : the number of threads used to mark functions with -u/-t/-s [default = %d]\n", nProcs);
+    Abc_Print(-2, "\t-F file: checkpoint file to resume marking functions with -u/-t/-s from [default = %s]\n", pFileCkpt ? pFileCkpt : "not used");
     Abc_Print(-2, "\t-o     : toggles cleaning occurrence counters [default = %s]\n", fCleanOccur ? "yes" : "no");
     Abc_Print(-2, "\t-m     : toggles cleaning matching marks [default = %s]\n", fCleanMarks ? "yes" : "no");
     Abc_Print(-2, "\t-i     : toggles inverting matching marks [default = %s]\n", fInvMarks ? "yes" : "no");
@@ -39687,7 +39880,7 @@ int Abc_CommandAbc9Lf(Abc_Frame_t *pAbc, int argc, char **argv)
     int c;
     Lf_ManSetDefaultPars(pPars);
     Extra_UtilGetoptReset();
-    while ((c = Extra_UtilGetopt(argc, argv, "KCFARLEDWMekmupstgvwh")) != EOF)
+    while ((c = Extra_UtilGetopt(argc, argv, "KCFARLEDWMPekmupstgvwh")) != EOF)
     {
         switch (c)
         {
@@ -39810,6 +40003,20 @@ int Abc_CommandAbc9Lf(Abc_Frame_t *pAbc, int argc, char **argv)
                 goto usage;
             }
             break;
+        case 'P':
+            if (globalUtilOptind >= argc)
+            {
+                Abc_Print(-1, "Command line switch \"-P\" should be followed by a positive integer.\n");
+                goto usage;
+            }
+            pPars->nProcNum = atoi(argv[globalUtilOptind]);
+            globalUtilOptind++;
+            if (pPars->nProcNum < 0 || pPars->nProcNum > pPars->nProcNumMax)
+            {
+                Abc_Print(-1, "The number of threads (%d) is not supported.\n", pPars->nProcNum);
+                goto usage;
+            }
+            break;
         case 'a':
             pPars->fAreaOnly ^= 1;
             break;
@@ -39888,7 +40095,7 @@ usage:
         sprintf(Buffer, "best possible");
     else
         sprintf(Buffer, "%d", pPars->DelayTarget);
-    Abc_Print(-2, "usage: &lf [-KCFARLEDM num] [-kmupstgvwh]\n");
+    Abc_Print(-2, "usage: &lf [-KCFARLEDMP num] [-kmupstgvwh]\n");
     Abc_Print(-2, "\t           performs technology mapping of the network\n");
     Abc_Print(-2, "\t-K num   : LUT size for the mapping (2 <= K <= %d) [default = %d]\n", pPars->nLutSizeMax, pPars->nLutSize);
     Abc_Print(-2, "\t-C num   : the max number of priority cuts (1 <= C <= %d) [default = %d]\n", pPars->nCutNumMax, pPars->nCutNum);
@@ -39899,6 +40106,7 @@ usage:
     Abc_Print(-2, "\t-E num   : the area/edge tradeoff parameter (0 <= num <= 100) [default = %d]\n", pPars->nAreaTuner);
     Abc_Print(-2, "\t-D num   : sets the delay constraint for the mapping [default = %s]\n", Buffer);
     Abc_Print(-2, "\t-M num   : LUT size when cofactoring is performed (0 <= num <= 100) [default = %d]\n", pPars->nLutSizeMux);
+    Abc_Print(-2, "\t-P num   : the number of threads for cut computation (0 = serial) [default = %d]\n", pPars->nProcNum);
     //    Abc_Print( -2, "\t-a       : toggles area-oriented mapping [default = %s]\n", pPars->fAreaOnly? "yes": "no" );
     Abc_Print(-2, "\t-e       : toggles edge vs node minimization [default = %s]\n", pPars->fOptEdge ? "yes" : "no");
     Abc_Print(-2, "\t-k       : toggles coarsening the subject graph [default = %s]\n", pPars->fCoarsen ? "yes" : "no");
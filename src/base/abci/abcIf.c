@@ -114,6 +114,9 @@ Abc_Ntk_t * Abc_NtkIf( Abc_Ntk_t * pNtk, If_Par_t * pPars )
     // get timing information
     pPars->pTimesArr = Abc_NtkGetCiArrivalFloats(pNtk);
     pPars->pTimesReq = Abc_NtkGetCoRequiredFloats(pNtk);
+    //ymc: cut-caused PIs arrive when the parts driving them deliver
+    if ( pPars->bIsPif && pPars->pPifCiSlots )
+        If_PifBoardReadArrivals( pPars->pPifBoard, pPars->pPifCiSlots, Abc_NtkCiNum(pNtk), pPars->pTimesArr );
 
     // update timing info to reflect logic level
     if ( (pPars->fDelayOpt || pPars->fDsdBalance || pPars->fUserRecLib || pPars->fUserSesLib) && pNtk->pManTime )
@@ -227,6 +230,14 @@ If_Man_t * Abc_NtkToIf( Abc_Ntk_t * pNtk, If_Par_t * pPars )
     pIfMan = If_ManStart( pPars );
     pIfMan->pName = Abc_UtilStrsav( Abc_NtkName(pNtk) );
 
+    // check the memory limit before allocating the subject graph
+    if ( pPars->nMemLimit && 1.0 * Abc_NtkObjNum(pNtk) * pIfMan->nObjBytes / (1<<20) > 1.0 * pPars->nMemLimit )
+    {
+        printf( "The mapper needs %.1f MB to represent the subject graph with %d AIG nodes, which exceeds the memory limit (%d MB).\n", 
+            1.0 * Abc_NtkObjNum(pNtk) * pIfMan->nObjBytes / (1<<20), Abc_NtkObjNum(pNtk), pPars->nMemLimit );
+        If_ManStop( pIfMan );
+        return NULL;
+    }
     // print warning about excessive memory usage
     if ( 1.0 * Abc_NtkObjNum(pNtk) * pIfMan->nObjBytes / (1<<30) > 1.0 )
         printf( "Warning: The mapper will allocate %.1f GB for to represent the subject graph with %d AIG nodes.\n", 
@@ -240,14 +251,6 @@ If_Man_t * Abc_NtkToIf( Abc_Ntk_t * pNtk, If_Par_t * pPars )
         pNode->pCopy = (Abc_Obj_t *)If_ManCreateCi( pIfMan );
         // transfer logic level information
         Abc_ObjIfCopy(pNode)->Level = pNode->Level;
-        if(pPars->bIsPif)
-        {
-            if(pNode->fMarkA) //mark the cut-caused PI and store the corresponding PO in "pFanin0"
-            {
-                if(Abc_ObjIsPo(pNode->pData))
-                    Abc_ObjIfCopy(pNode)->pFanin0 = (If_Obj_t*) (pNode->pData); //in order to transfer the delay of cut-caused PO
-            }
-        }
     }
 
     // load the AIG into the mapper
@@ -260,6 +263,9 @@ If_Man_t * Abc_NtkToIf( Abc_Ntk_t * pNtk, If_Par_t * pPars )
         pNode->pCopy = (Abc_Obj_t *)If_ManCreateAnd( pIfMan, 
             If_NotCond( Abc_ObjIfCopy(Abc_ObjFanin0(pNode)), Abc_ObjFaninC0(pNode) ), 
             If_NotCond( Abc_ObjIfCopy(Abc_ObjFanin1(pNode)), Abc_ObjFaninC1(pNode) ) );
+        //ymc: a fringe copied from another part is only packed into the LUTs of this part
+        if ( pPars->bIsPif && pNode->fMarkB && If_ObjIsAnd(If_Regular(Abc_ObjIfCopy(pNode))) )
+            If_Regular(Abc_ObjIfCopy(pNode))->fSkipCut = 1;
         // set up the choice node
         if ( Abc_AigNodeIsChoice( pNode ) )
         {
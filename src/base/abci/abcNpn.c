@@ -174,7 +174,7 @@ void Abc_TruthNpnPrint( char * pCanonPermInit, unsigned uCanonPhase, int nVars )
   SeeAlso     []
 
 ***********************************************************************/
-void Abc_TruthNpnPerform( Abc_TtStore_t * p, int NpnType, int fVerbose )
+void Abc_TruthNpnPerform( Abc_TtStore_t * p, int NpnType, int nThreads, int fCheck, int fVerbose )
 {
     unsigned pAux[2048];
     word pAuxWord[1024], pAuxWord1[1024];
@@ -208,6 +208,8 @@ void Abc_TruthNpnPerform( Abc_TtStore_t * p, int NpnType, int fVerbose )
         pAlgoName = "adjustable algorithm (exact)     ";
     else if ( NpnType == 11 )
         pAlgoName = "new cost-aware exact algorithm   ";
+    else if ( NpnType == 12 )
+        pAlgoName = "batched hybrid fast ";
 
     assert( p->nVars <= 16 );
     if ( pAlgoName )
@@ -356,6 +358,22 @@ void Abc_TruthNpnPerform( Abc_TtStore_t * p, int NpnType, int fVerbose )
         }
 		Abc_TtHieManStop(pMan);
     }
+    else if ( NpnType == 12 )
+    {
+        char * pPerms = ABC_ALLOC( char, p->nFuncs * p->nVars );
+        unsigned * pPhases = ABC_ALLOC( unsigned, p->nFuncs );
+        int nFails = Abc_TtCanonicizeBatch( p->pFuncs[0], p->nFuncs, p->nVars, pPerms, pPhases, nThreads, fCheck );
+        if ( fVerbose )
+            for ( i = 0; i < p->nFuncs; i++ )
+            {
+                printf( "%7d : ", i );
+                Extra_PrintHex( stdout, (unsigned *)p->pFuncs[i], p->nVars ), Abc_TruthNpnPrint(pPerms + i * p->nVars, pPhases[i], p->nVars), printf( "\n" );
+            }
+        if ( fCheck )
+            printf( "Differ from scalar =%6d  ", nFails );
+        ABC_FREE( pPerms );
+        ABC_FREE( pPhases );
+    }
     else assert( 0 );
     clk = Abc_Clock() - clk;
     printf( "Classes =%9d  ", Abc_TruthNpnCountUnique(p) );
@@ -373,7 +391,7 @@ void Abc_TruthNpnPerform( Abc_TtStore_t * p, int NpnType, int fVerbose )
   SeeAlso     []
 
 ***********************************************************************/
-void Abc_TruthNpnTest( char * pFileName, int NpnType, int nVarNum, int fDumpRes, int fBinary, int fVerbose )
+void Abc_TruthNpnTest( char * pFileName, int NpnType, int nVarNum, int nThreads, int fCheck, int fDumpRes, int fBinary, int fVerbose )
 {
     Abc_TtStore_t * p;
     char * pFileNameOut;
@@ -384,7 +402,7 @@ void Abc_TruthNpnTest( char * pFileName, int NpnType, int nVarNum, int fDumpRes,
         return;
 
     // consider functions from the file
-    Abc_TruthNpnPerform( p, NpnType, fVerbose );
+    Abc_TruthNpnPerform( p, NpnType, nThreads, fCheck, fVerbose );
 
     // write the result
     if ( fDumpRes )
@@ -415,12 +433,12 @@ void Abc_TruthNpnTest( char * pFileName, int NpnType, int nVarNum, int fDumpRes,
   SeeAlso     []
 
 ***********************************************************************/
-int Abc_NpnTest( char * pFileName, int NpnType, int nVarNum, int fDumpRes, int fBinary, int fVerbose )
+int Abc_NpnTest( char * pFileName, int NpnType, int nVarNum, int nThreads, int fCheck, int fDumpRes, int fBinary, int fVerbose )
 {
     if ( fVerbose )
         printf( "Using truth tables from file \"%s\"...\n", pFileName );
-    if ( NpnType >= 0 && NpnType <= 11 )
-        Abc_TruthNpnTest( pFileName, NpnType, nVarNum, fDumpRes, fBinary, fVerbose );
+    if ( NpnType >= 0 && NpnType <= 12 )
+        Abc_TruthNpnTest( pFileName, NpnType, nVarNum, nThreads, fCheck, fDumpRes, fBinary, fVerbose );
     else
         printf( "Unknown canonical form value (%d).\n", NpnType );
     fflush( stdout );
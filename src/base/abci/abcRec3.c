@@ -606,7 +606,7 @@ clk = Abc_Clock();
 #ifdef LMS_USE_OLD_FORM
         uCanonPhase = Kit_TruthSemiCanonicize( (unsigned *)p->pTemp1, (unsigned *)p->pTemp2, nLeaves, pCanonPerm );
 #else
-        uCanonPhase = Abc_TtCanonicize( p->pTemp1, nLeaves, pCanonPerm );
+        uCanonPhase = Abc_TtCanonicizeCache( p->pTemp1, nLeaves, pCanonPerm );
 #endif
         Abc_TtStretch5( (unsigned *)p->pTemp1, nLeaves, p->nVars );
 p->timeCanon += Abc_Clock() - clk;
@@ -720,7 +720,7 @@ clk = Abc_Clock();
 #ifdef LMS_USE_OLD_FORM
     uCanonPhase = Kit_TruthSemiCanonicize( (unsigned *)p->pTemp1, (unsigned *)p->pTemp2, nLeaves, pCanonPerm );
 #else
-    uCanonPhase = Abc_TtCanonicize( p->pTemp1, nLeaves, pCanonPerm );
+    uCanonPhase = Abc_TtCanonicizeCache( p->pTemp1, nLeaves, pCanonPerm );
 #endif
     Abc_TtStretch5( (unsigned *)p->pTemp1, nLeaves, p->nVars );
 p->timeCanon += Abc_Clock() - clk;
@@ -936,7 +936,7 @@ clk = Abc_Clock();
 #ifdef LMS_USE_OLD_FORM
     *puCanonPhase = Kit_TruthSemiCanonicize( (unsigned *)p->pTemp1, (unsigned *)p->pTemp2, nLeaves, pCanonPerm );
 #else
-    *puCanonPhase = Abc_TtCanonicize( p->pTemp1, nLeaves, pCanonPerm );
+    *puCanonPhase = Abc_TtCanonicizeCache( p->pTemp1, nLeaves, pCanonPerm );
 #endif
     Abc_TtStretch5( (unsigned *)p->pTemp1, nLeaves, p->nVars );
 p->timeCanon += Abc_Clock() - clk;
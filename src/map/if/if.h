@@ -81,6 +81,9 @@ typedef struct If_Set_t_     If_Set_t;
 typedef struct If_LibLut_t_  If_LibLut_t;
 typedef struct If_LibBox_t_  If_LibBox_t;
 typedef struct If_DsdMan_t_  If_DsdMan_t;
+typedef struct If_PifBoard_t_ If_PifBoard_t;
+typedef struct If_TtStore_t_ If_TtStore_t;
+typedef struct If_CutDb_t_   If_CutDb_t;
 typedef struct Ifn_Ntk_t_    Ifn_Ntk_t;
 
 typedef struct Ifif_Par_t_   Ifif_Par_t;
@@ -102,12 +105,18 @@ struct If_Par_t_
     // user-controlable parameters
     If_DsdMan_t*       pDsdMan;       //ymc: for multithread pif
     int                bIsPif;        //ymc: for multithread pif
-    int*               piMaxReqTime; //ymc: for multithread pif
+    If_PifBoard_t *    pPifBoard;     //ymc: timing shared by the parts of pif
+    int *              pPifCiSlots;   //ymc: board slot of each CI (cut-caused PI) or -1
+    int *              pPifCoSlots;   //ymc: board slot of each CO (cut-caused PO) or -1
     float              factor;        //ymc: for ReqTime 
-    int                iThreadId;     //ymc: for debug
+    int                iThreadId;     //ymc: the part mapped (pif timing board)
 
     int                nLutSize;      // the LUT size
     int                nCutsMax;      // the max number of cuts
+    int                nThreads;      // the number of threads for cut enumeration
+    int                nMemLimit;     // the memory limit in MB (0 = unlimited)
+    char *             pCutDbIn;      // the cut database to warm-start from (or NULL)
+    char *             pCutDbOut;     // the cut database to write (or NULL)
     int                nFlowIters;    // the number of iterations of area recovery
     int                nAreaIters;    // the number of iterations of area recovery
     int                nGateSize;     // the max size of the AND/OR gate to map into
@@ -171,6 +180,9 @@ struct If_Par_t_
     float              DelayTargetNew;// new delay target
     float              FinalDelay;    // final delay after mapping
     float              FinalArea;     // final area after mapping
+    int                nCutsMergedAll;// cuts merged in all mapping rounds (out)
+    abctime            timeMapAll;    // thread CPU time of all mapping rounds (out)
+    Vec_Int_t *        vCutCosts;     // if given, cuts merged at each object ID in all mapping rounds (out)
     If_LibLut_t *      pLutLib;       // the LUT library
     float *            pTimesArr;     // arrival times
     float *            pTimesReq;     // required times
@@ -249,6 +261,13 @@ struct If_Man_t_
     If_Set_t *         pMemCi;        // memory for CI cutsets
     If_Set_t *         pMemAnd;       // memory for AND cutsets
     If_Set_t *         pFreeList;     // the list of free cutsets
+    int                nCutsMax;      // the number of cuts in a cutset (pPars->nCutsMax fitted into the memory limit)
+    int                nCutsLimit;    // the max number of cuts in a node cutset (reduced under the memory limit)
+    double             MemReduced;    // the memory used when nCutsLimit was last reduced
+    int                nSetsAlloc;    // the number of allocated cutsets
+    int                nSetsUsed;     // the number of cutsets in use
+    int                nSetsPeak;     // the peak number of cutsets in use
+    word               nSetsFetched;  // the number of cutsets fetched
     int                nSmallSupp;    // the small support
     int                nCutsTotal;
     int                nCutsUseless[32];
@@ -257,7 +276,9 @@ struct If_Man_t_
     int                nCutsUselessAll;
     int                nCuts5, nCuts5a;
     If_DsdMan_t *      pIfDsdMan;     // DSD manager
-    Vec_Mem_t *        vTtMem[IF_MAX_FUNC_LUTSIZE+1];   // truth table memory and hash table
+    Vec_Mem_t *        vTtMem[IF_MAX_FUNC_LUTSIZE+1];   // truth table memory
+    If_TtStore_t *     pTtStores[IF_MAX_FUNC_LUTSIZE+1];// concurrent hash tables of vTtMem
+    If_CutDb_t *       pCutDb;        // the database of cuts of the first round (or NULL)
     Vec_Wec_t *        vTtIsops[IF_MAX_FUNC_LUTSIZE+1]; // mapping of truth table into DSD
     Vec_Int_t *        vTtDsds[IF_MAX_FUNC_LUTSIZE+1];  // mapping of truth table into DSD
     Vec_Str_t *        vTtPerms[IF_MAX_FUNC_LUTSIZE+1]; // mapping of truth table into permutations
@@ -323,6 +344,23 @@ struct If_Set_t_
     If_Cut_t **        ppCuts;        // the array of pointers to the cuts
 };
 
+// timing board shared by the parts of pif (see ifPif.c)
+struct If_PifBoard_t_
+{
+    int                MaxReqTime;    // global required time committed in the last round
+    int                MaxReqTimeNext;// max-reduced by the parts during this round
+    int                nRounds;       // the number of committed rounds
+    int                nParts;        // the number of parts
+    float *            pPartDelays;   // the latest delay of each part
+    int                nArrSlots;     // boundary signals (cut-caused POs)
+    int                nReqSlots;     // their consumers (cut-caused PIs)
+    int *              pReq2Arr;      // consumer -> boundary signal
+    float *            pArrs;         // committed arrival time of each boundary signal
+    float *            pArrsNext;     // published by the driving part
+    float *            pReqs;         // committed required time of each boundary signal
+    float *            pReqsNext;     // published by each consumer
+};
+
 // node extension
 struct If_Obj_t_
 {
@@ -543,6 +581,11 @@ extern float           If_CutPowerDeref( If_Man_t * p, If_Cut_t * pCut, If_Obj_t
 extern float           If_CutPowerRef( If_Man_t * p, If_Cut_t * pCut, If_Obj_t * pRoot );
 extern float           If_CutPowerDerefed( If_Man_t * p, If_Cut_t * pCut, If_Obj_t * pRoot );
 extern float           If_CutPowerRefed( If_Man_t * p, If_Cut_t * pCut, If_Obj_t * pRoot );
+/*=== ifCutDb.c ===========================================================*/
+extern If_CutDb_t *    If_CutDbStart( If_Man_t * p );
+extern void            If_CutDbStop( If_Man_t * p );
+extern int             If_CutDbLoadCuts( If_Man_t * p, If_Obj_t * pObj, If_Set_t * pCutSet );
+extern void            If_CutDbSaveCuts( If_Man_t * p, If_Obj_t * pObj );
 /*=== ifDec.c =============================================================*/
 extern word            If_CutPerformDerive07( If_Man_t * p, unsigned * pTruth, int nVars, int nLeaves, char * pStr );
 extern int             If_CutPerformCheck07( If_Man_t * p, unsigned * pTruth, int nVars, int nLeaves, char * pStr );
@@ -567,14 +610,19 @@ extern int             If_CutLutBalanceEval( If_Man_t * p, If_Cut_t * pCut );
 extern int             If_CutLutBalancePinDelays( If_Man_t * p, If_Cut_t * pCut, char * pPerm );
 /*=== ifDsd.c =============================================================*/
 extern If_DsdMan_t *   If_DsdManAlloc( int nVars, int nLutSize );
+extern If_DsdMan_t *   If_DsdManStartOverlay( If_DsdMan_t * pBase );
 extern void            If_DsdManAllocIsops( If_DsdMan_t * p, int nLutSize );
 extern void            If_DsdManPrint( If_DsdMan_t * p, char * pFileName, int Number, int Support, int fOccurs, int fTtDump, int fVerbose );
 extern void            If_DsdManTune( If_DsdMan_t * p, int LutSize, int fFast, int fAdd, int fSpec, int fVerbose );
+extern void            If_DsdManTunePar( If_DsdMan_t * p, int LutSize, int fFast, int fAdd, int fSpec, int nProcs, char * pFileName, int fVerbose );
 extern void            Id_DsdManTuneStr( If_DsdMan_t * p, char * pStruct, int nConfls, int nProcs, int fVerbose );
 extern void            If_DsdManFree( If_DsdMan_t * p, int fVerbose );
 extern void            If_DsdManSave( If_DsdMan_t * p, char * pFileName );
 extern If_DsdMan_t *   If_DsdManLoad( char * pFileName );
+extern void            If_DsdManSaveMmap( If_DsdMan_t * p, char * pFileName );
+extern If_DsdMan_t *   If_DsdManLoadMmap( char * pFileName, int fVerbose );
 extern void            If_DsdManMerge( If_DsdMan_t * p, If_DsdMan_t * pNew );
+extern void            If_DsdManMergeOverlay( If_DsdMan_t * p, If_DsdMan_t * pOver );
 extern void            If_DsdManCleanOccur( If_DsdMan_t * p, int fVerbose );
 extern void            If_DsdManCleanMarks( If_DsdMan_t * p, int fVerbose );
 extern void            If_DsdManInvertMarks( If_DsdMan_t * p, int fVerbose );
@@ -597,6 +645,7 @@ extern unsigned        If_DsdManCheckXY( If_DsdMan_t * p, int iDsd, int LutSize,
 extern int             If_CutDsdBalanceEval( If_Man_t * p, If_Cut_t * pCut, Vec_Int_t * vAig );
 extern int             If_CutDsdBalancePinDelays( If_Man_t * p, If_Cut_t * pCut, char * pPerm );
 extern void            Id_DsdManTuneThresh( If_DsdMan_t * p, int fUnate, int fThresh, int fThreshHeuristic, int fVerbose );
+extern void            Id_DsdManTuneThreshPar( If_DsdMan_t * p, int fUnate, int fThresh, int fThreshHeuristic, int nProcs, char * pFileName, int fVerbose );
 /*=== ifLib.c =============================================================*/
 extern If_LibLut_t *   If_LibLutRead( char * FileName );
 extern If_LibLut_t *   If_LibLutDup( If_LibLut_t * p );
@@ -636,11 +685,30 @@ extern If_Set_t *      If_ManSetupNodeCutSet( If_Man_t * p, If_Obj_t * pObj );
 extern void            If_ManDerefNodeCutSet( If_Man_t * p, If_Obj_t * pObj );
 extern void            If_ManDerefChoiceCutSet( If_Man_t * p, If_Obj_t * pObj );
 extern void            If_ManSetupSetAll( If_Man_t * p, int nCrossCut );
+extern double          If_ManMemoryUsage( If_Man_t * p );
+extern int             If_ManMemoryFitCuts( If_Man_t * p, int nCrossCut );
+extern void            If_ManMemoryCheck( If_Man_t * p );
+extern void            If_ManMemoryPrintStats( If_Man_t * p );
 /*=== ifMap.c =============================================================*/
 extern int *           If_CutArrTimeProfile( If_Man_t * p, If_Cut_t * pCut );
+extern If_Set_t *      If_ObjPerformMappingAndStart( If_Man_t * p, If_Obj_t * pObj, int Mode );
+extern int             If_ObjPerformMappingAndCuts( If_Man_t * p, If_Obj_t * pObj, If_Set_t * pCutSet, int Mode, int fPreprocess, int fFirst );
+extern void            If_ObjPerformMappingAndStop( If_Man_t * p, If_Obj_t * pObj, int Mode );
 extern void            If_ObjPerformMappingAnd( If_Man_t * p, If_Obj_t * pObj, int Mode, int fPreprocess, int fFirst );
 extern void            If_ObjPerformMappingChoice( If_Man_t * p, If_Obj_t * pObj, int Mode, int fPreprocess );
 extern int             If_ManPerformMappingRound( If_Man_t * p, int nCutsUsed, int Mode, int fPreprocess, int fFirst, char * pLabel );
+/*=== ifPar.c =============================================================*/
+extern int             If_ManCrossCutLevel( If_Man_t * p );
+extern int             If_ManPerformMappingRoundPar( If_Man_t * p, int Mode, int fPreprocess, int fFirst );
+/*=== ifPif.c =============================================================*/
+extern If_PifBoard_t * If_PifBoardStart( int nParts, int nArrSlots, int nReqSlots, int * pReq2Arr );
+extern void            If_PifBoardStop( If_PifBoard_t * p );
+extern void            If_PifBoardCommit( If_PifBoard_t * p );
+extern void            If_PifBoardUpdateMaxReq( If_PifBoard_t * p, int ReqTime );
+extern void            If_PifBoardReadArrivals( If_PifBoard_t * p, int * pCiSlots, int nCis, float * pTimesArr );
+extern float           If_PifBoardCoRequired( If_PifBoard_t * p, int iSlot, float RequiredGlo, float ArrTime );
+extern void            If_PifBoardPublish( If_Man_t * pIfMan );
+extern void            If_PifBoardPublishPart( If_PifBoard_t * p, int iPart, float Delay, int * pCoSlots, float * pCoArrs, int nCos );
 /*=== ifReduce.c ==========================================================*/
 extern void            If_ManImproveMapping( If_Man_t * p );
 /*=== ifSat.c ==========================================================*/
@@ -662,6 +730,12 @@ extern int             If_CutComputeTruth( If_Man_t * p, If_Cut_t * pCut, If_Cut
 extern int             If_CutComputeTruthPerm( If_Man_t * p, If_Cut_t * pCut, If_Cut_t * pCut0, If_Cut_t * pCut1, int fCompl0, int fCompl1 );
 extern Vec_Mem_t *     If_DeriveHashTable6( int nVars, word Truth );
 extern int             If_CutCheckTruth6( If_Man_t * p, If_Cut_t * pCut );
+/*=== ifTtStore.c =========================================================*/
+extern If_TtStore_t *  If_TtStoreStart( Vec_Mem_t * vMem );
+extern void            If_TtStoreStop( If_TtStore_t * p );
+extern int             If_TtStoreInsert( If_TtStore_t * p, word * pTruth );
+extern double          If_TtStoreMemory( If_TtStore_t * p );
+extern void            If_TtStorePrintStats( If_TtStore_t * p, int nVars );
 /*=== ifTune.c ===========================================================*/
 extern Ifn_Ntk_t *     Ifn_NtkParse( char * pStr );
 extern int             Ifn_NtkTtBits( char * pStr );
@@ -48,6 +48,8 @@ void If_ManSetDefaultPars(If_Par_t *pPars)
     memset(pPars, 0, sizeof(If_Par_t));
     pPars->nLutSize = -1;
     pPars->nCutsMax = 8; 
+    pPars->nThreads = 1;
+    pPars->nMemLimit = 0;
     pPars->nFlowIters = 1; 
     pPars->nAreaIters = 2; 
     pPars->DelayTarget = -1;
@@ -77,14 +79,24 @@ void If_ManSetDefaultPars(If_Par_t *pPars)
 ***********************************************************************/
 int If_ManPerformMapping(If_Man_t *p)
 {
+    int nCrossCut, RetValue;
     p->pPars->fAreaOnly = p->pPars->fArea; // temporary
     // create the CI cutsets
     If_ManSetupCiCutSets(p);
-    // allocate memory for other cutsets
-    If_ManSetupSetAll(p, If_ManCrossCut(p));
+    // allocate memory for other cutsets (parallel rounds keep whole levels alive)
+    nCrossCut = If_ManCrossCut(p);
+    if (p->pPars->nThreads > 1)
+        nCrossCut = Abc_MaxInt(nCrossCut, If_ManCrossCutLevel(p));
+    if (!If_ManMemoryFitCuts(p, nCrossCut))
+        return 0;
+    If_ManSetupSetAll(p, nCrossCut);
     // derive reverse top order
     p->vObjsRev = If_ManReverseOrder(p);
-    return If_ManPerformMappingComb(p);
+    // reuse the cuts of the unchanged nodes and save the cuts for later runs
+    p->pCutDb = If_CutDbStart(p);
+    RetValue = If_ManPerformMappingComb(p);
+    If_CutDbStop(p);
+    return RetValue;
 }
 
 /**Function*************************************************************
@@ -115,20 +127,20 @@ int If_ManPerformMappingComb( If_Man_t * p )
     if (p->pPars->fPreprocess && !p->pPars->fArea)
     {
         // map for delay
-        If_ManPerformMappingRound(p, p->pPars->nCutsMax, 0, 1, 1, "Delay");
+        If_ManPerformMappingRound(p, p->nCutsMax, 0, 1, 1, "Delay");
         // map for delay second option
         p->pPars->fFancy = 1;
         If_ManResetOriginalRefs(p);
-        If_ManPerformMappingRound(p, p->pPars->nCutsMax, 0, 1, 0, "Delay-2");
+        If_ManPerformMappingRound(p, p->nCutsMax, 0, 1, 0, "Delay-2");
         p->pPars->fFancy = 0;
         // map for area
         p->pPars->fArea = 1;
         If_ManResetOriginalRefs(p);
-        If_ManPerformMappingRound(p, p->pPars->nCutsMax, 0, 1, 0, "Area");
+        If_ManPerformMappingRound(p, p->nCutsMax, 0, 1, 0, "Area");
         p->pPars->fArea = 0;
     }
     else
-        If_ManPerformMappingRound(p, p->pPars->nCutsMax, 0, 0, 1, "Delay");
+        If_ManPerformMappingRound(p, p->nCutsMax, 0, 0, 1, "Delay");
 
     // try to improve area by expanding and reducing the cuts
     if (p->pPars->fExpRed)
@@ -137,7 +149,7 @@ int If_ManPerformMappingComb( If_Man_t * p )
     // area flow oriented mapping
     for (i = 0; i < p->pPars->nFlowIters; i++)
     {
-        If_ManPerformMappingRound(p, p->pPars->nCutsMax, 1, 0, 0, "Flow");
+        If_ManPerformMappingRound(p, p->nCutsMax, 1, 0, 0, "Flow");
         if (p->pPars->fExpRed)
             If_ManImproveMapping(p);
     }
@@ -145,7 +157,7 @@ int If_ManPerformMappingComb( If_Man_t * p )
     // area oriented mapping
     for (i = 0; i < p->pPars->nAreaIters; i++)
     {
-        If_ManPerformMappingRound(p, p->pPars->nCutsMax, 2, 0, 0, "Area");
+        If_ManPerformMappingRound(p, p->nCutsMax, 2, 0, 0, "Area");
         if (p->pPars->fExpRed)
             If_ManImproveMapping(p);
     }
@@ -159,6 +171,8 @@ int If_ManPerformMappingComb( If_Man_t * p )
 //            1.0 * (p->nObjBytes + 2*sizeof(void *)) * If_ManObjNum(p) / (1<<20), 
         //            1.0 * (p->nObjBytes + 2*sizeof(void *)) * If_ManObjNum(p) / (1<<20),
         //            1.0 * p->nSetBytes * Mem_FixedReadMaxEntriesUsed(p->pMemSet) / (1<<20) );
+        if (p->nSetsAlloc)
+            If_ManMemoryPrintStats(p);
         Abc_PrintTime(1, "Total time", Abc_Clock() - clkTotal);
     }
     //    Abc_Print( 1, "Cross cut memory = %d.\n", Mem_FixedReadMaxEntriesUsed(p->pMemSet) );
@@ -0,0 +1,694 @@
+/**CFile****************************************************************
+
+  FileName    [ifCutDb.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [FPGA mapping based on priority cuts.]
+
+  Synopsis    [Persistent database of priority cuts for warm starts.]
+
+  Author      [ymc]
+
+  Affiliation []
+
+  Date        [Ver. 1.0. Started - October 17, 2026.]
+
+  Revision    [$Id: ifCutDb.c,v 1.00 2026/10/17 00:00:00 ymc Exp $]
+
+***********************************************************************/
+
+#include "if.h"
+
+ABC_NAMESPACE_IMPL_START
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+// The database keeps the priority cuts computed by the first delay round
+// for each AND node. A node is identified by its structural key, which
+// is derived from the keys of the fanins, the complemented attributes
+// and the fanout count of every node in its transitive fanin, so the
+// key of a node is the same in two runs if and only if (up to hashing)
+// its TFI and the fanout counts in the TFI are the same. In this case
+// the cutsets computed by the first round are the same too, so they can
+// be read from the database instead of being enumerated. The leaves of
+// the cuts are stored as keys and the truth tables are stored in the
+// database, so the cuts can be used in a different network.
+//
+// File format (version 1, native byte order):
+//   char[8]  "IFCUTDB"
+//   int      version
+//   word     the key of the mapping parameters
+//   int      the LUT size
+//   int      1 if truth tables are used
+//   for each truth table size v = 6..max(6,K) if truth tables are used:
+//     int    the number of tables, followed by the tables
+//   int      the number of nodes, followed by their keys (word)
+//   int      the number of nodes, followed by their starts in the data (int)
+//   int      the number of data entries, followed by the data (word)
+// The data of a node is the number of cuts followed by the cuts. A cut is
+// the number of leaves and the truth table literal (-1 if not used),
+// the delay and the area (as floats), and the keys of the leaves.
+
+#define IF_CUTDB_VERSION  1
+
+#define IF_CUTDB_DUP      1           // the key of the object is not unique
+#define IF_CUTDB_HIT      2           // the cuts of the node were read
+#define IF_CUTDB_SAVED    4           // the cuts of the node were saved
+
+typedef struct If_CutDbData_t_ If_CutDbData_t;
+struct If_CutDbData_t_
+{
+    word               ParKey;        // the key of the mapping parameters
+    int                nLutSize;      // the LUT size
+    Vec_Mem_t *        vTtMem[IF_MAX_FUNC_LUTSIZE+1]; // truth tables (v >= 6)
+    Vec_Wrd_t *        vKeys;         // the keys of the nodes
+    Vec_Int_t *        vStarts;       // the first data entry of each node
+    Vec_Wrd_t *        vData;         // the cuts of the nodes
+    Vec_Int_t *        vTable;        // hash table of the keys
+};
+
+struct If_CutDb_t_
+{
+    If_CutDbData_t *   pIn;           // the database read from file (or NULL)
+    If_CutDbData_t *   pOut;          // the database to be written (or NULL)
+    char *             pFileIn;       // the input file name
+    char *             pFileOut;      // the output file name
+    int                nCutsLimit;    // the cut limit the parameter key uses
+    Vec_Wrd_t *        vObjKeys;      // the key of each object
+    Vec_Int_t *        vObjTable;     // hash table of the object keys
+    Vec_Str_t *        vObjState;     // the flags of each object
+    abctime            clkTotal;      // the time to read and write
+};
+
+static inline word If_CutDbHash( word x )
+{
+    x += ABC_CONST(0x9E3779B97F4A7C15);
+    x = (x ^ (x >> 30)) * ABC_CONST(0xBF58476D1CE4E5B9);
+    x = (x ^ (x >> 27)) * ABC_CONST(0x94D049BB133111EB);
+    return x ^ (x >> 31);
+}
+static inline word If_CutDbHashAdd( word Key, word Value ) { return If_CutDbHash( Key ^ Value ); }
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+/**Function*************************************************************
+
+  Synopsis    [Hash table of keys.]
+
+  Description [The table is an open-addressing table of the indexes of
+  the keys in vKeys (plus one, 0 is an empty slot). Lookup returns the
+  index of the key or -1.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static int If_CutDbTableLookup( Vec_Int_t * vTable, Vec_Wrd_t * vKeys, word Key )
+{
+    int Mask = Vec_IntSize(vTable) - 1;
+    int i = (int)(Key & Mask), Entry;
+    while ( (Entry = Vec_IntEntry(vTable, i)) )
+    {
+        if ( Vec_WrdEntry(vKeys, Entry-1) == Key )
+            return Entry-1;
+        i = (i + 1) & Mask;
+    }
+    return -1;
+}
+static void If_CutDbTableInsert( Vec_Int_t * vTable, Vec_Wrd_t * vKeys, int iKey )
+{
+    int Mask = Vec_IntSize(vTable) - 1;
+    int i = (int)(Vec_WrdEntry(vKeys, iKey) & Mask);
+    while ( Vec_IntEntry(vTable, i) )
+        i = (i + 1) & Mask;
+    Vec_IntWriteEntry( vTable, i, iKey+1 );
+}
+static void If_CutDbTableStart( Vec_Int_t * vTable, int nKeys )
+{
+    Vec_IntFill( vTable, 1 << Abc_Base2Log(2 * nKeys + 2), 0 );
+}
+static void If_CutDbTableRehash( Vec_Int_t * vTable, Vec_Wrd_t * vKeys )
+{
+    int i;
+    If_CutDbTableStart( vTable, Vec_WrdSize(vKeys) );
+    for ( i = 0; i < Vec_WrdSize(vKeys); i++ )
+        If_CutDbTableInsert( vTable, vKeys, i );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Allocates and frees the database.]
+
+  Description []
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static If_CutDbData_t * If_CutDbDataAlloc( word ParKey, int nLutSize, int fTruth )
+{
+    If_CutDbData_t * p = ABC_CALLOC( If_CutDbData_t, 1 );
+    int v;
+    p->ParKey   = ParKey;
+    p->nLutSize = nLutSize;
+    if ( fTruth )
+    {
+        for ( v = 6; v <= Abc_MaxInt(6, nLutSize); v++ )
+        {
+            p->vTtMem[v] = Vec_MemAlloc( Abc_Truth6WordNum(v), 12 );
+            Vec_MemHashAlloc( p->vTtMem[v], 1000 );
+        }
+    }
+    p->vKeys    = Vec_WrdAlloc( 1000 );
+    p->vStarts  = Vec_IntAlloc( 1000 );
+    p->vData    = Vec_WrdAlloc( 10000 );
+    p->vTable   = Vec_IntAlloc( 0 );
+    If_CutDbTableStart( p->vTable, 0 );
+    return p;
+}
+static void If_CutDbDataFree( If_CutDbData_t * p )
+{
+    int v;
+    if ( p == NULL )
+        return;
+    for ( v = 6; v <= Abc_MaxInt(6, p->nLutSize); v++ )
+    {
+        if ( p->vTtMem[v] == NULL )
+            continue;
+        Vec_MemHashFree( p->vTtMem[v] );
+        Vec_MemFree( p->vTtMem[v] );
+    }
+    Vec_WrdFree( p->vKeys );
+    Vec_IntFree( p->vStarts );
+    Vec_WrdFree( p->vData );
+    Vec_IntFree( p->vTable );
+    ABC_FREE( p );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Writes and reads the database.]
+
+  Description []
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static int If_CutDbDataWrite( If_CutDbData_t * p, char * pFileName )
+{
+    char pMagic[8] = "IFCUTDB";
+    int v, i, Version = IF_CUTDB_VERSION, fTruth = (p->vTtMem[6] != NULL), nEntries, RetValue = 1;
+    FILE * pFile = fopen( pFileName, "wb" );
+    if ( pFile == NULL )
+    {
+        Abc_Print( -1, "Cannot open file \"%s\" for writing the cut database.\n", pFileName );
+        return 0;
+    }
+    RetValue &= fwrite( pMagic, 1, 8, pFile ) == 8;
+    RetValue &= fwrite( &Version, sizeof(int), 1, pFile ) == 1;
+    RetValue &= fwrite( &p->ParKey, sizeof(word), 1, pFile ) == 1;
+    RetValue &= fwrite( &p->nLutSize, sizeof(int), 1, pFile ) == 1;
+    RetValue &= fwrite( &fTruth, sizeof(int), 1, pFile ) == 1;
+    for ( v = 6; v <= Abc_MaxInt(6, p->nLutSize); v++ )
+    {
+        if ( p->vTtMem[v] == NULL )
+            break;
+        nEntries = Vec_MemEntryNum( p->vTtMem[v] );
+        RetValue &= fwrite( &nEntries, sizeof(int), 1, pFile ) == 1;
+        for ( i = 0; i < nEntries; i++ )
+            RetValue &= fwrite( Vec_MemReadEntry(p->vTtMem[v], i), sizeof(word), Abc_Truth6WordNum(v), pFile ) == (size_t)Abc_Truth6WordNum(v);
+    }
+    nEntries = Vec_WrdSize( p->vKeys );
+    RetValue &= fwrite( &nEntries, sizeof(int), 1, pFile ) == 1;
+    RetValue &= fwrite( Vec_WrdArray(p->vKeys), sizeof(word), nEntries, pFile ) == (size_t)nEntries;
+    nEntries = Vec_IntSize( p->vStarts );
+    RetValue &= fwrite( &nEntries, sizeof(int), 1, pFile ) == 1;
+    RetValue &= fwrite( Vec_IntArray(p->vStarts), sizeof(int), nEntries, pFile ) == (size_t)nEntries;
+    nEntries = Vec_WrdSize( p->vData );
+    RetValue &= fwrite( &nEntries, sizeof(int), 1, pFile ) == 1;
+    RetValue &= fwrite( Vec_WrdArray(p->vData), sizeof(word), nEntries, pFile ) == (size_t)nEntries;
+    fclose( pFile );
+    if ( !RetValue )
+        Abc_Print( -1, "Writing the cut database into file \"%s\" has failed.\n", pFileName );
+    return RetValue;
+}
+// checks the record of one node: the number of cuts followed by the cuts,
+// each being the leaf count with the truth literal, the delay with the area, and the leaf keys
+static int If_CutDbDataCheckNode( If_CutDbData_t * p, int iStart )
+{
+    word * pData = Vec_WrdArray( p->vData );
+    int i, nCuts, nLeaves, nData = Vec_WrdSize( p->vData );
+    if ( iStart < 0 || iStart >= nData || pData[iStart] > (word)nData )
+        return 0;
+    nCuts = (int)pData[iStart++];
+    for ( i = 0; i < nCuts; i++ )
+    {
+        if ( iStart + 2 > nData )
+            return 0;
+        nLeaves = (int)(pData[iStart] & 0xFF);
+        if ( nLeaves > p->nLutSize || iStart + 2 + nLeaves > nData )
+            return 0;
+        iStart += 2 + nLeaves;
+    }
+    return 1;
+}
+static If_CutDbData_t * If_CutDbDataRead( char * pFileName )
+{
+    If_CutDbData_t * p = NULL;
+    word * pTruth = NULL, ParKey;
+    char pMagic[8];
+    int v, i, Version, nLutSize, fTruth, nEntries, RetValue = 1;
+    FILE * pFile = fopen( pFileName, "rb" );
+    if ( pFile == NULL )
+    {
+        Abc_Print( -1, "Cannot open file \"%s\" with the cut database.\n", pFileName );
+        return NULL;
+    }
+    if ( fread( pMagic, 1, 8, pFile ) != 8 || strncmp(pMagic, "IFCUTDB", 8) )
+    {
+        Abc_Print( -1, "File \"%s\" is not a cut database.\n", pFileName );
+        fclose( pFile );
+        return NULL;
+    }
+    if ( fread( &Version, sizeof(int), 1, pFile ) != 1 || Version != IF_CUTDB_VERSION )
+    {
+        Abc_Print( -1, "The cut database in file \"%s\" has unsupported version.\n", pFileName );
+        fclose( pFile );
+        return NULL;
+    }
+    RetValue &= fread( &ParKey, sizeof(word), 1, pFile ) == 1;
+    RetValue &= fread( &nLutSize, sizeof(int), 1, pFile ) == 1;
+    RetValue &= fread( &fTruth, sizeof(int), 1, pFile ) == 1;
+    if ( !RetValue || nLutSize < 0 || nLutSize > IF_MAX_LUTSIZE || (fTruth && nLutSize > IF_MAX_FUNC_LUTSIZE) )
+    {
+        Abc_Print( -1, "The header of the cut database in file \"%s\" is corrupted.\n", pFileName );
+        fclose( pFile );
+        return NULL;
+    }
+    p = If_CutDbDataAlloc( ParKey, nLutSize, fTruth );
+    for ( v = 6; RetValue && v <= Abc_MaxInt(6, nLutSize); v++ )
+    {
+        if ( p->vTtMem[v] == NULL )
+            break;
+        pTruth = ABC_ALLOC( word, Abc_Truth6WordNum(v) );
+        RetValue &= fread( &nEntries, sizeof(int), 1, pFile ) == 1 && nEntries >= 0;
+        for ( i = 0; RetValue && i < nEntries; i++ )
+        {
+            RetValue &= fread( pTruth, sizeof(word), Abc_Truth6WordNum(v), pFile ) == (size_t)Abc_Truth6WordNum(v);
+            RetValue &= Vec_MemHashInsert( p->vTtMem[v], pTruth ) == i;
+        }
+        ABC_FREE( pTruth );
+    }
+    RetValue = RetValue && fread( &nEntries, sizeof(int), 1, pFile ) == 1 && nEntries >= 0;
+    if ( RetValue )
+    {
+        Vec_WrdFill( p->vKeys, nEntries, 0 );
+        RetValue &= fread( Vec_WrdArray(p->vKeys), sizeof(word), nEntries, pFile ) == (size_t)nEntries;
+    }
+    RetValue = RetValue && fread( &nEntries, sizeof(int), 1, pFile ) == 1 && nEntries == Vec_WrdSize(p->vKeys);
+    if ( RetValue )
+    {
+        Vec_IntFill( p->vStarts, nEntries, 0 );
+        RetValue &= fread( Vec_IntArray(p->vStarts), sizeof(int), nEntries, pFile ) == (size_t)nEntries;
+    }
+    RetValue = RetValue && fread( &nEntries, sizeof(int), 1, pFile ) == 1 && nEntries >= 0;
+    if ( RetValue )
+    {
+        Vec_WrdFill( p->vData, nEntries, 0 );
+        RetValue &= fread( Vec_WrdArray(p->vData), sizeof(word), nEntries, pFile ) == (size_t)nEntries;
+    }
+    fclose( pFile );
+    // the record of each node should lie within the data
+    for ( i = 0; RetValue && i < Vec_IntSize(p->vStarts); i++ )
+        RetValue = If_CutDbDataCheckNode( p, Vec_IntEntry(p->vStarts, i) );
+    if ( !RetValue )
+    {
+        Abc_Print( -1, "The cut database in file \"%s\" is corrupted.\n", pFileName );
+        If_CutDbDataFree( p );
+        return NULL;
+    }
+    If_CutDbTableRehash( p->vTable, p->vKeys );
+    return p;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Returns 1 if the cuts can be reused with these options.]
+
+  Description [The cutsets of the first round should depend only on
+  the TFI of the node and on the parameters included in the key.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static int If_CutDbIsSupported( If_Man_t * p )
+{
+    If_Par_t * pPars = p->pPars;
+    if ( p->pManTim != NULL || p->nChoices > 0 || pPars->bIsPif || pPars->fLiftLeaves || pPars->fUsePerm || pPars->fPower )
+        return 0;
+    if ( pPars->fUseTtPerm || pPars->pFuncCost || pPars->pFuncCell || pPars->pFuncCell2 || pPars->pLutStruct )
+        return 0;
+    if ( pPars->fUseDsd || pPars->fUseDsdTune || pPars->fUseAndVars || pPars->fUseCofVars || pPars->fUse34Spec || pPars->fLut6Filter )
+        return 0;
+    if ( pPars->fDelayOpt || pPars->fDsdBalance || pPars->fUserRecLib || pPars->fUserSesLib || pPars->fDelayOptLut || pPars->nGateSize > 0 )
+        return 0;
+    if ( pPars->fUseBat || pPars->fEnableCheck07 || pPars->fEnableCheck75 || pPars->fEnableCheck75u )
+        return 0;
+    return 1;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Computes the keys.]
+
+  Description [The key of the parameters includes everything that
+  changes the cutsets of the first round other than the network.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static word If_CutDbParKey( If_Man_t * p )
+{
+    If_Par_t * pPars = p->pPars;
+    word Key = If_CutDbHash( IF_CUTDB_VERSION );
+    int i, k;
+    Key = If_CutDbHashAdd( Key, (word)pPars->nLutSize );
+    Key = If_CutDbHashAdd( Key, (word)p->nCutsLimit );
+    Key = If_CutDbHashAdd( Key, (word)(pPars->fTruth | (pPars->fCutMin << 1) | (pPars->fSkipCutFilter << 2) | (pPars->fEdge << 3) | (pPars->fArea << 4)) );
+    Key = If_CutDbHashAdd( Key, (word)pPars->nAndDelay | ((word)pPars->nAndArea << 32) );
+    Key = If_CutDbHashAdd( Key, (word)(unsigned)Abc_Float2Int(pPars->Epsilon) );
+    if ( pPars->pLutLib == NULL )
+        return Key;
+    Key = If_CutDbHashAdd( Key, (word)pPars->pLutLib->LutMax | ((word)pPars->pLutLib->fVarPinDelays << 32) );
+    for ( i = 0; i <= pPars->pLutLib->LutMax; i++ )
+    {
+        Key = If_CutDbHashAdd( Key, (word)(unsigned)Abc_Float2Int(pPars->pLutLib->pLutAreas[i]) );
+        for ( k = 0; k <= pPars->pLutLib->LutMax; k++ )
+            Key = If_CutDbHashAdd( Key, (word)(unsigned)Abc_Float2Int(pPars->pLutLib->pLutDelays[i][k]) );
+    }
+    return Key;
+}
+static void If_CutDbObjKeys( If_CutDb_t * pDb, If_Man_t * p )
+{
+    If_Obj_t * pObj;
+    word Key;
+    int i, iObj;
+    Vec_WrdFill( pDb->vObjKeys, If_ManObjNum(p), 0 );
+    Vec_StrFill( pDb->vObjState, If_ManObjNum(p), 0 );
+    If_ManForEachObj( p, pObj, i )
+    {
+        if ( If_ObjIsConst1(pObj) )
+            Key = If_CutDbHash( 1 );
+        else if ( If_ObjIsCi(pObj) )
+        {
+            Key = If_CutDbHashAdd( If_CutDbHash(2), (word)pObj->IdPio );
+            if ( p->pPars->pTimesArr )
+                Key = If_CutDbHashAdd( Key, (word)(unsigned)Abc_Float2Int(p->pPars->pTimesArr[pObj->IdPio]) );
+        }
+        else if ( If_ObjIsAnd(pObj) )
+        {
+            Key = If_CutDbHashAdd( If_CutDbHash(3), Vec_WrdEntry(pDb->vObjKeys, If_ObjFanin0(pObj)->Id) );
+            Key = If_CutDbHashAdd( Key, Vec_WrdEntry(pDb->vObjKeys, If_ObjFanin1(pObj)->Id) );
+            Key = If_CutDbHashAdd( Key, (word)(pObj->fCompl0 | (pObj->fCompl1 << 1) | (pObj->fSpec << 2) | (pObj->fSkipCut << 3)) );
+        }
+        else
+            continue;
+        Key = If_CutDbHashAdd( Key, (word)pObj->nRefs );
+        Vec_WrdWriteEntry( pDb->vObjKeys, pObj->Id, Key );
+    }
+    // hash the keys of all objects except the COs
+    If_CutDbTableStart( pDb->vObjTable, If_ManObjNum(p) );
+    If_ManForEachObj( p, pObj, i )
+    {
+        if ( If_ObjIsCo(pObj) )
+            continue;
+        iObj = If_CutDbTableLookup( pDb->vObjTable, pDb->vObjKeys, Vec_WrdEntry(pDb->vObjKeys, pObj->Id) );
+        if ( iObj >= 0 )
+        {
+            Vec_StrWriteEntry( pDb->vObjState, iObj, IF_CUTDB_DUP );
+            Vec_StrWriteEntry( pDb->vObjState, pObj->Id, IF_CUTDB_DUP );
+            continue;
+        }
+        If_CutDbTableInsert( pDb->vObjTable, pDb->vObjKeys, pObj->Id );
+    }
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Starts the cut database of the mapping manager.]
+
+  Description [Reads the database given by pPars->pCutDbIn and prepares
+  the database to be written into pPars->pCutDbOut. Returns NULL if the
+  database cannot be used.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+If_CutDb_t * If_CutDbStart( If_Man_t * p )
+{
+    If_CutDb_t * pDb;
+    abctime clk = Abc_Clock();
+    word ParKey;
+    if ( p->pPars->pCutDbIn == NULL && p->pPars->pCutDbOut == NULL )
+        return NULL;
+    if ( !If_CutDbIsSupported(p) )
+    {
+        Abc_Print( 0, "The cut database is not supported for the current mapping options.\n" );
+        return NULL;
+    }
+    ParKey = If_CutDbParKey( p );
+    pDb = ABC_CALLOC( If_CutDb_t, 1 );
+    pDb->pFileIn    = p->pPars->pCutDbIn;
+    pDb->pFileOut   = p->pPars->pCutDbOut;
+    pDb->nCutsLimit = p->nCutsLimit;
+    if ( pDb->pFileIn )
+    {
+        pDb->pIn = If_CutDbDataRead( pDb->pFileIn );
+        if ( pDb->pIn && (pDb->pIn->ParKey != ParKey || pDb->pIn->nLutSize != p->pPars->nLutSize) )
+        {
+            Abc_Print( 0, "The cut database in file \"%s\" was derived with different mapping parameters and is not used.\n", pDb->pFileIn );
+            If_CutDbDataFree( pDb->pIn );
+            pDb->pIn = NULL;
+        }
+    }
+    if ( pDb->pFileOut )
+        pDb->pOut = If_CutDbDataAlloc( ParKey, p->pPars->nLutSize, p->pPars->fTruth );
+    pDb->vObjKeys  = Vec_WrdAlloc( 0 );
+    pDb->vObjTable = Vec_IntAlloc( 0 );
+    pDb->vObjState = Vec_StrAlloc( 0 );
+    If_CutDbObjKeys( pDb, p );
+    pDb->clkTotal = Abc_Clock() - clk;
+    return pDb;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Stops the cut database of the mapping manager.]
+
+  Description [Writes the database if requested and prints statistics.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_CutDbStop( If_Man_t * p )
+{
+    If_CutDb_t * pDb = p->pCutDb;
+    abctime clk = Abc_Clock();
+    int i, nHits = 0;
+    if ( pDb == NULL )
+        return;
+    p->pCutDb = NULL;
+    if ( pDb->pOut )
+        If_CutDbDataWrite( pDb->pOut, pDb->pFileOut );
+    pDb->clkTotal += Abc_Clock() - clk;
+    if ( p->pPars->fVerbose )
+    {
+        for ( i = 0; i < Vec_StrSize(pDb->vObjState); i++ )
+            nHits += (Vec_StrEntry(pDb->vObjState, i) & IF_CUTDB_HIT) != 0;
+        if ( pDb->pIn )
+            Abc_Print( 1, "Cut database: Read %d nodes from \"%s\". Reused the cuts of %d nodes (%.2f %%).\n",
+                Vec_WrdSize(pDb->pIn->vKeys), pDb->pFileIn, nHits, 100.0 * nHits / Abc_MaxInt(1, If_ManAndNum(p)) );
+        if ( pDb->pOut )
+            Abc_Print( 1, "Cut database: Wrote %d nodes (%.2f MB) into \"%s\".\n", Vec_WrdSize(pDb->pOut->vKeys),
+                8.0 * (Vec_WrdSize(pDb->pOut->vKeys) + Vec_WrdSize(pDb->pOut->vData)) / (1<<20), pDb->pFileOut );
+        Abc_PrintTime( 1, "Cut database time", pDb->clkTotal );
+    }
+    If_CutDbDataFree( pDb->pIn );
+    If_CutDbDataFree( pDb->pOut );
+    Vec_WrdFree( pDb->vObjKeys );
+    Vec_IntFree( pDb->vObjTable );
+    Vec_StrFree( pDb->vObjState );
+    ABC_FREE( pDb );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Reads the cutset of the node from the database.]
+
+  Description [Returns 1 if the cuts of the node were found and added
+  to the empty cutset (without the trivial cut). Only reads the shared
+  data and writes the cutset and the flag of the node, so it may be
+  called concurrently for the nodes of one level.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+int If_CutDbLoadCuts( If_Man_t * p, If_Obj_t * pObj, If_Set_t * pCutSet )
+{
+    If_CutDb_t * pDb = p->pCutDb;
+    If_CutDbData_t * pIn = pDb->pIn;
+    word pTruth[1 << (IF_MAX_FUNC_LUTSIZE-6)], * pData, * pLeafKeys;
+    int fUseAndCut = (p->pPars->nAndDelay > 0) || (p->pPars->nAndArea > 0);
+    int i, k, j, iNode, iLeaf, nCuts, nLeaves, nWords, TruthLit;
+    If_Cut_t * pCut;
+    assert( pCutSet->nCuts == 0 );
+    if ( pIn == NULL || p->nCutsLimit != pDb->nCutsLimit || (Vec_StrEntry(pDb->vObjState, pObj->Id) & IF_CUTDB_DUP) )
+        return 0;
+    iNode = If_CutDbTableLookup( pIn->vTable, pIn->vKeys, Vec_WrdEntry(pDb->vObjKeys, pObj->Id) );
+    if ( iNode == -1 )
+        return 0;
+    pData = Vec_WrdEntryP( pIn->vData, Vec_IntEntry(pIn->vStarts, iNode) );
+    nCuts = (int)*pData++;
+    for ( i = 0; i < nCuts; i++ )
+    {
+        pCut      = pCutSet->ppCuts[pCutSet->nCuts];
+        nLeaves   = (int)(pData[0] & 0xFF);
+        TruthLit  = (int)(pData[0] >> 32);
+        pLeafKeys = pData + 2;
+        pData    += 2 + nLeaves;
+        if ( nLeaves > p->pPars->nLutSize )
+            break;
+        // find the leaves in this network
+        for ( k = 0; k < nLeaves; k++ )
+        {
+            iLeaf = If_CutDbTableLookup( pDb->vObjTable, pDb->vObjKeys, pLeafKeys[k] );
+            if ( iLeaf < 0 || iLeaf >= pObj->Id || (Vec_StrEntry(pDb->vObjState, iLeaf) & IF_CUTDB_DUP) )
+                break;
+            pCut->pLeaves[k] = iLeaf;
+        }
+        if ( k < nLeaves )
+            break;
+        // sort the leaves by ID and permute the truth table accordingly
+        nWords = p->pPars->fTruth ? p->nTruth6Words[nLeaves] : 0;
+        if ( nWords )
+        {
+            if ( TruthLit < 0 || Abc_Lit2Var(TruthLit) >= Vec_MemEntryNum(pIn->vTtMem[Abc_MaxInt(6, nLeaves)]) )
+                break;
+            Abc_TtCopy( pTruth, Vec_MemReadEntry(pIn->vTtMem[Abc_MaxInt(6, nLeaves)], Abc_Lit2Var(TruthLit)), nWords, 0 );
+        }
+        for ( k = 1; k < nLeaves; k++ )
+            for ( j = k; j > 0 && pCut->pLeaves[j-1] > pCut->pLeaves[j]; j-- )
+            {
+                ABC_SWAP( int, pCut->pLeaves[j-1], pCut->pLeaves[j] );
+                if ( nWords )
+                    Abc_TtSwapAdjacent( pTruth, nWords, j-1 );
+            }
+        for ( k = 1; k < nLeaves; k++ )
+            if ( pCut->pLeaves[k-1] == pCut->pLeaves[k] )
+                break;
+        if ( k < nLeaves )
+            break;
+        // restore the cut as If_ObjPerformMappingAndCuts() derives it
+        pCut->nLeaves  = nLeaves;
+        pCut->uSign    = If_ObjCutSignCompute( pCut );
+        pCut->fAndCut  = fUseAndCut && nLeaves == 2 && pCut->pLeaves[0] == pObj->pFanin0->Id && pCut->pLeaves[1] == pObj->pFanin1->Id;
+        pCut->fCompl   = 0;
+        pCut->fUseless = 0;
+        pCut->fUser    = 0;
+        pCut->Cost     = 0;
+        pCut->iCutFunc = nWords ? Abc_Var2Lit( If_TtStoreInsert(p->pTtStores[nLeaves], pTruth), Abc_LitIsCompl(TruthLit) ) : -1;
+        pCut->Delay    = If_CutDelay( p, pObj, pCut );
+        pCut->Area     = If_CutAreaFlow( p, pCut );
+        if ( p->pPars->fEdge )
+            pCut->Edge = If_CutEdgeFlow( p, pCut );
+        If_CutSort( p, pCutSet, pCut );
+    }
+    if ( i < nCuts || pCutSet->nCuts == 0 )
+    {
+        pCutSet->nCuts = 0;
+        return 0;
+    }
+    Vec_StrWriteEntry( pDb->vObjState, pObj->Id, (char)(Vec_StrEntry(pDb->vObjState, pObj->Id) | IF_CUTDB_HIT) );
+    return 1;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Saves the cutset of the node into the database.]
+
+  Description [Saves the cutset computed for the node by the first
+  round, which should be called before the cutset is recycled.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_CutDbSaveCuts( If_Man_t * p, If_Obj_t * pObj )
+{
+    If_CutDb_t * pDb = p->pCutDb;
+    If_CutDbData_t * pOut = pDb->pOut;
+    If_Cut_t * pCut;
+    word Key;
+    int i, k, iStart, nCuts = 0, TruthLit;
+    char State = Vec_StrEntry( pDb->vObjState, pObj->Id );
+    if ( pOut == NULL || (State & (IF_CUTDB_SAVED | IF_CUTDB_DUP)) || pObj->pCutSet == NULL || p->nCutsLimit != pDb->nCutsLimit )
+        return;
+    Vec_StrWriteEntry( pDb->vObjState, pObj->Id, (char)(State | IF_CUTDB_SAVED) );
+    Key = Vec_WrdEntry( pDb->vObjKeys, pObj->Id );
+    if ( If_CutDbTableLookup(pOut->vTable, pOut->vKeys, Key) >= 0 )
+        return;
+    iStart = Vec_WrdSize( pOut->vData );
+    Vec_WrdPush( pOut->vData, 0 );
+    If_ObjForEachCut( pObj, pCut, i )
+    {
+        if ( pCut->nLeaves == 1 && pCut->pLeaves[0] == pObj->Id )
+            continue;
+        TruthLit = -1;
+        if ( p->pPars->fTruth )
+            TruthLit = Abc_Var2Lit( Vec_MemHashInsert(pOut->vTtMem[Abc_MaxInt(6, pCut->nLeaves)], If_CutTruthWR(p, pCut)), Abc_LitIsCompl(pCut->iCutFunc) );
+        Vec_WrdPush( pOut->vData, (word)pCut->nLeaves | ((word)(unsigned)TruthLit << 32) );
+        Vec_WrdPush( pOut->vData, (word)(unsigned)Abc_Float2Int(pCut->Delay) | ((word)(unsigned)Abc_Float2Int(pCut->Area) << 32) );
+        for ( k = 0; k < (int)pCut->nLeaves; k++ )
+            Vec_WrdPush( pOut->vData, Vec_WrdEntry(pDb->vObjKeys, pCut->pLeaves[k]) );
+        nCuts++;
+    }
+    if ( nCuts == 0 )
+    {
+        Vec_WrdShrink( pOut->vData, iStart );
+        return;
+    }
+    Vec_WrdWriteEntry( pOut->vData, iStart, (word)nCuts );
+    Vec_WrdPush( pOut->vKeys, Key );
+    Vec_IntPush( pOut->vStarts, iStart );
+    if ( 2 * Vec_WrdSize(pOut->vKeys) > Vec_IntSize(pOut->vTable) )
+        If_CutDbTableRehash( pOut->vTable, pOut->vKeys );
+    else
+        If_CutDbTableInsert( pOut->vTable, pOut->vKeys, Vec_WrdSize(pOut->vKeys)-1 );
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
+
+
+ABC_NAMESPACE_IMPL_END
@@ -103,10 +103,11 @@ int Dau_DsdCheckDecExist_rec( char * pStr, char ** p, int * pMatches, int * pnSu
 }
 int Dau_DsdCheckDecExist( char * pDsd )
 {
+    int pMatches[DAU_MAX_STR];
     int nSupp = 0;
     if ( pDsd[1] == 0 )
         return 0;
-    return Dau_DsdCheckDecExist_rec( pDsd, &pDsd, Dau_DsdComputeMatches(pDsd), &nSupp );
+    return Dau_DsdCheckDecExist_rec( pDsd, &pDsd, Dau_DsdComputeMatches(pDsd, pMatches), &nSupp );
 }
 
 /**Function*************************************************************
@@ -184,10 +185,11 @@ int Dau_DsdCheckDecAndExist_rec( char * pStr, char ** p, int * pMatches, int * p
 }
 int Dau_DsdCheckDecAndExist( char * pDsd )
 {
+    int pMatches[DAU_MAX_STR];
     int nSupp = 0;
     if ( pDsd[1] == 0 )
         return 1;
-    return Dau_DsdCheckDecAndExist_rec( pDsd, &pDsd, Dau_DsdComputeMatches(pDsd), &nSupp );
+    return Dau_DsdCheckDecAndExist_rec( pDsd, &pDsd, Dau_DsdComputeMatches(pDsd, pMatches), &nSupp );
 }
 
 /**Function*************************************************************
@@ -30,6 +30,13 @@
 #include "bdd/extrab/extraBdd.h"
 #endif
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #ifdef ABC_USE_PTHREADS
 
 #ifdef _WIN32
@@ -49,6 +56,7 @@ ABC_NAMESPACE_IMPL_START
 ////////////////////////////////////////////////////////////////////////
 
 #define DSD_VERSION "dsd1"
+#define DSD_VERSION_MMAP "dsm1"
 
 // network types
 typedef enum { 
@@ -61,6 +69,28 @@ typedef enum {
     IF_DSD_PRIME                   // 6:  PRIME
 } If_DsdType_t;
 
+// header of the memory-mapped library image (If_DsdManSaveMmap);
+// the sections follow in the order of If_DsdManLoadMmap, each padded to 8 bytes
+typedef struct If_DsdImage_t_ If_DsdImage_t;
+struct If_DsdImage_t_
+{
+    char           pMagic[8];      // DSD_VERSION_MMAP
+    int            nVars;          // max var number
+    int            LutSize;        // LUT size
+    int            nObjs;          // the number of objects
+    int            nObjWords;      // the number of words used by objects
+    int            nBins;          // hash table size
+    int            nConfigWords;   // the number of words for config data per node
+    int            nTtBits;        // the number of truth table bits
+    int            nConfigs;       // the number of config words
+    int            nCellStr;       // the length of the cell description
+    int            Reserved;
+    int            nTts[IF_MAX_FUNC_LUTSIZE+1];     // the number of truth tables
+    int            nTables[IF_MAX_FUNC_LUTSIZE+1];  // truth table hash table size
+    int            nDecs[IF_MAX_FUNC_LUTSIZE+1];    // the number of decompositions
+    int            nDecInts[IF_MAX_FUNC_LUTSIZE+1]; // the number of ints in decompositions
+};
+
 typedef struct If_DsdObj_t_ If_DsdObj_t;
 struct If_DsdObj_t_
 {
@@ -88,6 +118,7 @@ struct If_DsdMan_t_
     Vec_Int_t *    vTemp1;         // temp
     Vec_Int_t *    vTemp2;         // temp
     word **        pTtElems;       // elementary TTs
+    word           pTtRes[DAU_MAX_WORD]; // truth table returned by If_DsdManComputeTruth()
     Vec_Mem_t *    vTtMem[IF_MAX_FUNC_LUTSIZE+1];  // truth table memory and hash table
     Vec_Ptr_t *    vTtDecs[IF_MAX_FUNC_LUTSIZE+1]; // truth table decompositions
     Vec_Wec_t *    vIsops[IF_MAX_FUNC_LUTSIZE+1];  // ISOP for each function
@@ -101,6 +132,13 @@ struct If_DsdMan_t_
     char *         pCellStr;       // symbolic cell description
     int            nObjsPrev;      // previous number of objects
     int            fNewAsUseless;  // set new as useless
+    If_DsdMan_t *  pBase;          // shared read-only manager (overlays only)
+    int            nObjsBase;      // the number of objects taken from the base
+    int            nTtsBase[IF_MAX_FUNC_LUTSIZE+1]; // the number of truth tables taken from the base
+    void *         pMapped;        // memory-mapped library image
+    size_t         nMapped;        // the size of the image
+    int            fMappedVecs;    // the arrays still point into the image
+    Vec_Int_t *    pDecsMapped[IF_MAX_FUNC_LUTSIZE+1]; // decompositions pointing into the image
     int            nUniqueHits;    // statistics
     int            nUniqueMisses;  // statistics
     abctime        timeDsd;        // statistics
@@ -111,9 +149,14 @@ struct If_DsdMan_t_
 };
 
 static inline int           If_DsdObjWordNum( int nFans )                                    { return sizeof(If_DsdObj_t) / 8 + nFans / 2 + ((nFans & 1) > 0);              }
-static inline int           If_DsdObjTruthId( If_DsdMan_t * p, If_DsdObj_t * pObj )          { return (pObj->Type == IF_DSD_PRIME && pObj->nFans > 2) ? Vec_IntEntry(&p->vTruths, pObj->Id) : -1;     }
-static inline word *        If_DsdObjTruth( If_DsdMan_t * p, If_DsdObj_t * pObj )            { return Vec_MemReadEntry(p->vTtMem[pObj->nFans], If_DsdObjTruthId(p, pObj));  }
-static inline void          If_DsdObjSetTruth( If_DsdMan_t * p, If_DsdObj_t * pObj, int Id ) { assert( pObj->Type == IF_DSD_PRIME && pObj->nFans > 2 ); Vec_IntWriteEntry(&p->vTruths, pObj->Id, Id); }
+// in an overlay, objects and truth tables below nObjsBase/nTtsBase belong to the base manager;
+// vNexts, vTruths, vTtMem and vTtDecs only store the entries added on top of it
+static inline int           If_DsdObjTruthId( If_DsdMan_t * p, If_DsdObj_t * pObj )          { if ( pObj->Type != IF_DSD_PRIME || pObj->nFans <= 2 ) return -1; return (int)pObj->Id < p->nObjsBase ? Vec_IntEntry(&p->pBase->vTruths, pObj->Id) : Vec_IntEntry(&p->vTruths, pObj->Id - p->nObjsBase); }
+static inline word *        If_DsdManTruth( If_DsdMan_t * p, int nVars, int truthId )        { return truthId < p->nTtsBase[nVars] ? Vec_MemReadEntry(p->pBase->vTtMem[nVars], truthId) : Vec_MemReadEntry(p->vTtMem[nVars], truthId - p->nTtsBase[nVars]);                }
+static inline Vec_Int_t *   If_DsdManTtDecs( If_DsdMan_t * p, int nVars, int truthId )       { return (Vec_Int_t *)(truthId < p->nTtsBase[nVars] ? Vec_PtrEntry(p->pBase->vTtDecs[nVars], truthId) : Vec_PtrEntry(p->vTtDecs[nVars], truthId - p->nTtsBase[nVars])); }
+static inline word *        If_DsdObjTruth( If_DsdMan_t * p, If_DsdObj_t * pObj )            { return If_DsdManTruth(p, pObj->nFans, If_DsdObjTruthId(p, pObj));  }
+static inline void          If_DsdObjSetTruth( If_DsdMan_t * p, If_DsdObj_t * pObj, int Id ) { assert( pObj->Type == IF_DSD_PRIME && pObj->nFans > 2 ); Vec_IntWriteEntry(&p->vTruths, pObj->Id - p->nObjsBase, Id); }
+static inline int *         If_DsdObjNextP( If_DsdMan_t * p, If_DsdObj_t * pObj )            { return Vec_IntEntryP(&p->vNexts, pObj->Id - p->nObjsBase); }
 
 static inline void          If_DsdObjClean( If_DsdObj_t * pObj )                       { memset( pObj, 0, sizeof(If_DsdObj_t) );                                            }
 static inline int           If_DsdObjId( If_DsdObj_t * pObj )                          { return pObj->Id;                                                                   }
@@ -214,6 +257,8 @@ void If_DsdManSetNewAsUseless( If_DsdMan_t * p )
 }
 word * If_DsdManGetFuncConfig( If_DsdMan_t * p, int iDsd )
 {
+    if ( Abc_Lit2Var(iDsd) < p->nObjsBase )
+        return If_DsdManGetFuncConfig( p->pBase, iDsd );
     return p->vConfigs ? Vec_WrdEntryP(p->vConfigs, p->nConfigWords * Abc_Lit2Var(iDsd)) : NULL;
 }
 char * If_DsdManGetCellStr( If_DsdMan_t * p )
@@ -257,8 +302,8 @@ If_DsdObj_t * If_DsdObjAlloc( If_DsdMan_t * p, int Type, int nFans )
     Vec_PtrPush( &p->vObjs, pObj ); //ymc: vector growing will cause thread problem.
     Vec_IntPush( &p->vNexts, 0 );
     Vec_IntPush( &p->vTruths, -1 );
-    assert( Vec_IntSize(&p->vNexts) == Vec_PtrSize(&p->vObjs) );
-    assert( Vec_IntSize(&p->vTruths) == Vec_PtrSize(&p->vObjs) );
+    assert( p->nObjsBase + Vec_IntSize(&p->vNexts) == Vec_PtrSize(&p->vObjs) );
+    assert( p->nObjsBase + Vec_IntSize(&p->vTruths) == Vec_PtrSize(&p->vObjs) );
     return pObj;
 }
 If_DsdMan_t * If_DsdManAlloc( int nVars, int LutSize )
@@ -303,6 +348,52 @@ If_DsdMan_t * If_DsdManAlloc( int nVars, int LutSize )
     p->vCover   = Vec_IntAlloc( 0 );
     return p;
 }
+// starts a private overlay on top of a manager shared by several threads;
+// the base is only read while the overlay is in use, new structures go into the overlay
+If_DsdMan_t * If_DsdManStartOverlay( If_DsdMan_t * pBase )
+{
+    If_DsdMan_t * p; int v;
+    assert( pBase->pBase == NULL );
+    assert( pBase->vIsops[3] == NULL && pBase->pTtGia == NULL );
+    p = ABC_CALLOC( If_DsdMan_t, 1 );
+    p->pBase    = pBase;
+    p->pStore   = Abc_UtilStrsav( pBase->pStore );
+    p->nVars    = pBase->nVars;
+    p->LutSize  = pBase->LutSize;
+    p->nWords   = pBase->nWords;
+    p->nBins    = Abc_PrimeCudd( 1000 );
+    p->pBins    = ABC_CALLOC( unsigned, p->nBins );
+    p->pMem     = Mem_FlexStart();
+    p->nTtBits  = pBase->nTtBits;
+    p->nConfigWords  = pBase->nConfigWords;
+    p->nObjsPrev     = pBase->nObjsPrev;
+    p->fNewAsUseless = pBase->fNewAsUseless;
+    if ( pBase->pCellStr )
+        p->pCellStr = Abc_UtilStrsav( pBase->pCellStr );
+    // object pointers of the base are copied, the objects themselves are shared
+    p->nObjsBase = Vec_PtrSize( &pBase->vObjs );
+    Vec_PtrGrow( &p->vObjs, p->nObjsBase + 1000 );
+    memcpy( Vec_PtrArray(&p->vObjs), Vec_PtrArray(&pBase->vObjs), sizeof(void *) * p->nObjsBase );
+    p->vObjs.nSize = p->nObjsBase;
+    Vec_IntGrow( &p->vNexts, 1000 );
+    Vec_IntGrow( &p->vTruths, 1000 );
+    p->vTemp1   = Vec_IntAlloc( 32 );
+    p->vTemp2   = Vec_IntAlloc( 32 );
+    p->pTtElems = If_ManDsdTtElems();
+    for ( v = 3; v <= p->nVars; v++ )
+    {
+        p->nTtsBase[v] = Vec_MemEntryNum( pBase->vTtMem[v] );
+        p->vTtMem[v] = Vec_MemAlloc( Abc_TtWordNum(v), 12 );
+        Vec_MemHashAlloc( p->vTtMem[v], 1000 );
+        p->vTtDecs[v] = Vec_PtrAlloc( 100 );
+    }
+    for ( v = 2; v < p->nVars; v++ )
+        p->pSched[v] = Extra_GreyCodeSchedule( v );
+    if ( p->LutSize )
+    p->pSat     = If_ManSatBuildXY( p->LutSize );
+    p->vCover   = Vec_IntAlloc( 0 );
+    return p;
+}
 void If_DsdManAllocIsops( If_DsdMan_t * p, int nLutSize )
 {
     Vec_Int_t * vLevel;
@@ -349,12 +440,30 @@ void If_DsdManFree( If_DsdMan_t * p, int fVerbose )
         ABC_FREE( p->pSched[v] );
     for ( v = 3; v <= p->nVars; v++ )
     {
-        Vec_MemHashFree( p->vTtMem[v] );
-        Vec_MemFree( p->vTtMem[v] );
-        Vec_VecFree( (Vec_Vec_t *)(p->vTtDecs[v]) );
+        if ( p->fMappedVecs ) // the arrays point into the image
+        {
+            ABC_FREE( p->vTtMem[v]->vTable );
+            ABC_FREE( p->vTtMem[v]->vNexts );
+            ABC_FREE( p->vTtMem[v]->ppPages );
+            ABC_FREE( p->vTtMem[v] );
+            Vec_PtrFree( p->vTtDecs[v] );
+            ABC_FREE( p->pDecsMapped[v] );
+        }
+        else
+        {
+            Vec_MemHashFree( p->vTtMem[v] );
+            Vec_MemFree( p->vTtMem[v] );
+            Vec_VecFree( (Vec_Vec_t *)(p->vTtDecs[v]) );
+        }
         if ( p->vIsops[v] )
             Vec_WecFree( p->vIsops[v] );
     }
+    if ( p->fMappedVecs )
+    {
+        ABC_FREE( p->vConfigs );
+        p->vNexts.pArray = p->vTruths.pArray = NULL;
+        p->pBins = NULL;
+    }
     Vec_WrdFreeP( &p->vConfigs );
     Vec_IntFreeP( &p->vTemp1 );
     Vec_IntFreeP( &p->vTemp2 );
@@ -368,6 +477,10 @@ void If_DsdManFree( If_DsdMan_t * p, int fVerbose )
     ABC_FREE( p->pCellStr );
     ABC_FREE( p->pStore );
     ABC_FREE( p->pBins );
+#ifndef _WIN32
+    if ( p->pMapped )
+        munmap( p->pMapped, p->nMapped );
+#endif
     ABC_FREE( p );
 }
 void If_DsdManDumpDsd( If_DsdMan_t * p, int Support )
@@ -426,9 +539,6 @@ void If_DsdManDumpAll( If_DsdMan_t * p, int Support )
         fprintf( pFile, "\n" );
 //        printf( "    " );
 //        Dau_DsdPrintFromTruth( pRes, p->nVars );
-#ifdef PIF_MULTITHREAD //ymc
-        free(pRes);
-#endif
     }
     fclose( pFile );
 }
@@ -461,7 +571,7 @@ void If_DsdManHashProfile( If_DsdMan_t * p )
     for ( i = 0; i < p->nBins; i++ )
     {
         Counter = 0;
-        for ( pSpot = p->pBins + i; *pSpot; pSpot = (unsigned *)Vec_IntEntryP(&p->vNexts, pObj->Id), Counter++ )
+        for ( pSpot = p->pBins + i; *pSpot; pSpot = (unsigned *)If_DsdObjNextP(p, pObj), Counter++ )
              pObj = If_DsdVecObj( &p->vObjs, *pSpot );
 //        if ( Counter > 5 )
 //            printf( "%d ", Counter );
@@ -920,42 +1030,67 @@ static inline unsigned If_DsdObjHashKey( If_DsdMan_t * p, int Type, int * pLits,
         uHash += truthId * s_Primes[i & 0xF];
     return uHash % p->nBins;
 }
-unsigned * If_DsdObjHashLookup( If_DsdMan_t * p, int Type, int * pLits, int nLits, int truthId )
+// looks up the local table only; does not touch the statistics, so it is safe to call on a shared base
+static inline unsigned * If_DsdObjHashLookupInt( If_DsdMan_t * p, int Type, int * pLits, int nLits, int truthId )
 {
     If_DsdObj_t * pObj;
     unsigned * pSpot = p->pBins + If_DsdObjHashKey(p, Type, pLits, nLits, truthId);
-    for ( ; *pSpot; pSpot = (unsigned *)Vec_IntEntryP(&p->vNexts, pObj->Id) )
+    for ( ; *pSpot; pSpot = (unsigned *)If_DsdObjNextP(p, pObj) )
     {
         pObj = If_DsdVecObj( &p->vObjs, *pSpot );
         if ( If_DsdObjType(pObj) == Type && 
              If_DsdObjFaninNum(pObj) == nLits && 
              !memcmp(pObj->pFans, pLits, sizeof(int)*If_DsdObjFaninNum(pObj)) &&
              truthId == If_DsdObjTruthId(p, pObj) )
+            return pSpot;
+    }
+    return pSpot;
+}
+unsigned * If_DsdObjHashLookup( If_DsdMan_t * p, int Type, int * pLits, int nLits, int truthId )
+{
+    unsigned * pSpot;
+    // overlays check the base first; a hit returns the (never written) spot of the base table
+    if ( p->pBase && (Type != IF_DSD_PRIME || truthId < p->nTtsBase[nLits]) )
+    {
+        pSpot = If_DsdObjHashLookupInt( p->pBase, Type, pLits, nLits, truthId );
+        if ( *pSpot )
         {
             p->nUniqueHits++;
             return pSpot;
         }
     }
-    p->nUniqueMisses++;
+    pSpot = If_DsdObjHashLookupInt( p, Type, pLits, nLits, truthId );
+    if ( *pSpot )
+        p->nUniqueHits++;
+    else
+        p->nUniqueMisses++;
     return pSpot;
 }
 static void If_DsdObjHashResize( If_DsdMan_t * p )
 {
     If_DsdObj_t * pObj;
     unsigned * pSpot;
-    int i, Prev = p->nUniqueMisses;
+    int i;
     p->nBins = Abc_PrimeCudd( 2 * p->nBins );
     p->pBins = ABC_REALLOC( unsigned, p->pBins, p->nBins );
     memset( p->pBins, 0, sizeof(unsigned) * p->nBins );
-    Vec_IntFill( &p->vNexts, Vec_PtrSize(&p->vObjs), 0 );
-    If_DsdVecForEachNode( &p->vObjs, pObj, i )
+    Vec_IntFill( &p->vNexts, Vec_PtrSize(&p->vObjs) - p->nObjsBase, 0 );
+    If_DsdVecForEachObjStart( &p->vObjs, pObj, i, Abc_MaxInt(2, p->nObjsBase) )
     {
-        pSpot = If_DsdObjHashLookup( p, pObj->Type, (int *)pObj->pFans, pObj->nFans, If_DsdObjTruthId(p, pObj) );
+        pSpot = If_DsdObjHashLookupInt( p, pObj->Type, (int *)pObj->pFans, pObj->nFans, If_DsdObjTruthId(p, pObj) );
         assert( *pSpot == 0 );
         *pSpot = pObj->Id;
     }
-    assert( p->nUniqueMisses - Prev == Vec_PtrSize(&p->vObjs) - 2 );
-    p->nUniqueMisses = Prev;
+}
+static inline int If_DsdManTruthInsert( If_DsdMan_t * p, int nVars, word * pTruth )
+{
+    if ( p->pBase )
+    {
+        int * pSpot = Vec_MemHashLookup( p->pBase->vTtMem[nVars], pTruth );
+        if ( *pSpot != -1 )
+            return *pSpot;
+    }
+    return p->nTtsBase[nVars] + Vec_MemHashInsert( p->vTtMem[nVars], pTruth );
 }
 
 int If_DsdObjCreate( If_DsdMan_t * p, int Type, int * pLits, int nLits, int truthId )
@@ -993,19 +1128,69 @@ int If_DsdObjCreate( If_DsdMan_t * p, int Type, int * pLits, int nLits, int trut
         If_DsdVecObjSetMark( &p->vObjs, pObj->Id );
     return pObj->Id;
 }
+static inline void * If_DsdMemDup( void * pData, size_t nBytes )
+{
+    void * pRes = ABC_ALLOC( char, nBytes ? nBytes : 1 );
+    memcpy( pRes, pData, nBytes );
+    return pRes;
+}
+// before the first update of a memory-mapped manager, copies the arrays 
+// that can grow to the heap; the objects stay in the (private) image
+static void If_DsdManMaterialize( If_DsdMan_t * p )
+{
+    int v, k, nPage;
+    if ( !p->fMappedVecs )
+        return;
+    p->pBins = (unsigned *)If_DsdMemDup( p->pBins, sizeof(unsigned) * p->nBins );
+    p->vNexts.pArray  = (int *)If_DsdMemDup( p->vNexts.pArray,  sizeof(int) * Vec_IntSize(&p->vNexts) );
+    p->vTruths.pArray = (int *)If_DsdMemDup( p->vTruths.pArray, sizeof(int) * Vec_IntSize(&p->vTruths) );
+    for ( v = 3; v <= p->nVars; v++ )
+    {
+        Vec_Mem_t * vTtMem = p->vTtMem[v];
+        nPage = vTtMem->nEntrySize << vTtMem->LogPageSze;
+        for ( k = 0; k <= vTtMem->iPage; k++ )
+        {
+            word * pPage = ABC_ALLOC( word, nPage );
+            memcpy( pPage, vTtMem->ppPages[k], sizeof(word) * Abc_MinInt(nPage, vTtMem->nEntrySize * (vTtMem->nEntries - (k << vTtMem->LogPageSze))) );
+            vTtMem->ppPages[k] = pPage;
+        }
+        vTtMem->vTable->pArray = (int *)If_DsdMemDup( vTtMem->vTable->pArray, sizeof(int) * Vec_IntSize(vTtMem->vTable) );
+        vTtMem->vNexts->pArray = (int *)If_DsdMemDup( vTtMem->vNexts->pArray, sizeof(int) * Vec_IntSize(vTtMem->vNexts) );
+        for ( k = 0; k < Vec_PtrSize(p->vTtDecs[v]); k++ )
+            Vec_PtrWriteEntry( p->vTtDecs[v], k, Vec_IntAllocArrayCopy(p->pDecsMapped[v][k].pArray, p->pDecsMapped[v][k].nSize) );
+        ABC_FREE( p->pDecsMapped[v] );
+    }
+    if ( p->vConfigs )
+        p->vConfigs->pArray = (word *)If_DsdMemDup( p->vConfigs->pArray, sizeof(word) * Vec_WrdSize(p->vConfigs) );
+    p->fMappedVecs = 0;
+}
 int If_DsdObjFindOrAdd( If_DsdMan_t * p, int Type, int * pLits, int nLits, word * pTruth )
 {
-    int PrevSize       = (Type == IF_DSD_PRIME) ? Vec_MemEntryNum( p->vTtMem[nLits] ) : -1;   
-    int objId, truthId = (Type == IF_DSD_PRIME) ? Vec_MemHashInsert(p->vTtMem[nLits], pTruth) : -1;
-    unsigned * pSpot = If_DsdObjHashLookup( p, Type, pLits, nLits, truthId );
+    int PrevSize, objId, truthId;
+    unsigned * pSpot;
 //abctime clk;
+    if ( p->fMappedVecs )
+    {
+        // the image is used in place until something new is added
+        truthId = (Type == IF_DSD_PRIME) ? *Vec_MemHashLookup(p->vTtMem[nLits], pTruth) : -1;
+        if ( Type != IF_DSD_PRIME || truthId >= 0 )
+        {
+            pSpot = If_DsdObjHashLookup( p, Type, pLits, nLits, truthId );
+            if ( *pSpot )
+                return (int)*pSpot;
+        }
+        If_DsdManMaterialize( p );
+    }
+    PrevSize = (Type == IF_DSD_PRIME) ? Vec_MemEntryNum( p->vTtMem[nLits] ) : -1;   
+    truthId  = (Type == IF_DSD_PRIME) ? If_DsdManTruthInsert(p, nLits, pTruth) : -1;
+    pSpot    = If_DsdObjHashLookup( p, Type, pLits, nLits, truthId );
     if ( *pSpot )
         return (int)*pSpot;
 //clk = Abc_Clock();
-    if ( p->LutSize && truthId >= 0 && truthId == Vec_PtrSize(p->vTtDecs[nLits]) )
+    if ( p->LutSize && truthId >= 0 && truthId == p->nTtsBase[nLits] + Vec_PtrSize(p->vTtDecs[nLits]) )
     {
         Vec_Int_t * vSets = Dau_DecFindSets_int( pTruth, nLits, p->pSched );
-        assert( truthId == Vec_MemEntryNum(p->vTtMem[nLits])-1 );
+        assert( truthId == p->nTtsBase[nLits] + Vec_MemEntryNum(p->vTtMem[nLits])-1 );
         Vec_PtrPush( p->vTtDecs[nLits], vSets );
 //        Dau_DecPrintSets( vSets, nLits );
     }
@@ -1032,7 +1217,7 @@ int If_DsdObjFindOrAdd( If_DsdMan_t * p, int Type, int * pLits, int nLits, word
 //p->timeCheck += Abc_Clock() - clk;
     *pSpot = Vec_PtrSize( &p->vObjs );
     objId = If_DsdObjCreate( p, Type, pLits, nLits, truthId );
-    if ( Vec_PtrSize(&p->vObjs) > p->nBins )
+    if ( Vec_PtrSize(&p->vObjs) - p->nObjsBase > p->nBins )
         If_DsdObjHashResize( p );
     return objId;
 }
@@ -1055,7 +1240,9 @@ void If_DsdManSave( If_DsdMan_t * p, char * pFileName )
     Vec_Int_t * vSets;
     word * pTruth; 
     int i, v, Num;
-    FILE * pFile = fopen( pFileName ? pFileName : p->pStore, "wb" );
+    FILE * pFile;
+    assert( p->pBase == NULL );
+    pFile = fopen( pFileName ? pFileName : p->pStore, "wb" );
     if ( pFile == NULL )
     {
         printf( "Writing DSD manager file \"%s\" has failed.\n", pFileName ? pFileName : p->pStore );
@@ -1122,6 +1309,11 @@ If_DsdMan_t * If_DsdManLoad( char * pFileName )
         return NULL;
     }
     RetValue = fread( pBuffer, 4, 1, pFile );
+    if ( !strncmp(pBuffer, DSD_VERSION_MMAP, strlen(DSD_VERSION_MMAP)) )
+    {
+        fclose( pFile );
+        return If_DsdManLoadMmap( pFileName, 0 );
+    }
     if ( strncmp(pBuffer, DSD_VERSION, strlen(DSD_VERSION)) )
     {
         printf( "Unrecognized format of file \"%s\".\n", pFileName );
@@ -1201,6 +1393,296 @@ If_DsdMan_t * If_DsdManLoad( char * pFileName )
     fclose( pFile );
     return p;
 }
+
+/**Function*************************************************************
+
+  Synopsis    [Saving/loading memory-mapped DSD manager.]
+
+  Description [The image stores the objects, the hash tables, the truth
+  tables, the decompositions and the configs exactly as they are used in
+  memory, with object IDs instead of pointers. Loading maps the file and
+  only rebuilds the table of object pointers. Arrays keep pointing into 
+  the image until the first update (see If_DsdManMaterialize).]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static void If_DsdImagePad( FILE * pFile, size_t nBytes )
+{
+    word Zero = 0;
+    if ( nBytes & 7 )
+        fwrite( &Zero, 8 - (nBytes & 7), 1, pFile );
+}
+static void If_DsdImageWrite( FILE * pFile, void * pData, size_t nBytes )
+{
+    if ( nBytes )
+        fwrite( pData, nBytes, 1, pFile );
+    If_DsdImagePad( pFile, nBytes );
+}
+static inline void * If_DsdImageNext( char ** ppCur, size_t nBytes )
+{
+    void * pRes = *ppCur;
+    *ppCur += (nBytes + 7) & ~(size_t)7;
+    return pRes;
+}
+static inline Vec_Int_t * If_DsdImageVecInt( Vec_Int_t * p, int * pArray, int nSize )
+{
+    p->pArray = pArray;
+    p->nSize  = p->nCap = nSize;
+    return p;
+}
+// advances over the next padded section if it fits into the image
+static inline int If_DsdImageSkip( char ** ppCur, char * pEnd, size_t nBytes )
+{
+    size_t nPadded = (nBytes + 7) & ~(size_t)7;
+    if ( nPadded < nBytes || nPadded > (size_t)(pEnd - *ppCur) )
+        return 0;
+    *ppCur += nPadded;
+    return 1;
+}
+// checks the header and the layout of the image before it is used; returns the reason of failure
+static char * If_DsdImageCheck( char * pMapped, size_t nMapped )
+{
+    If_DsdImage_t * pImage = (If_DsdImage_t *)pMapped;
+    char * pCur = pMapped + sizeof(If_DsdImage_t), * pEnd = pMapped + nMapped;
+    If_DsdObj_t * pObj;
+    int i, k, v, * pBegs;
+    if ( pImage->nVars < 3 || pImage->nVars > DAU_MAX_VAR )
+        return "the number of variables is out of range";
+    if ( pImage->LutSize < 0 || pImage->LutSize > pImage->nVars )
+        return "the LUT size is out of range";
+    if ( pImage->nObjs < 2 || pImage->nBins <= 0 || pImage->nConfigs < 0 || pImage->nCellStr < 0 )
+        return "the header is corrupted";
+    for ( i = 0; i < pImage->nObjs; i++ )
+    {
+        pObj = (If_DsdObj_t *)pCur;
+        if ( (size_t)(pEnd - pCur) < sizeof(If_DsdObj_t) || (int)pObj->Id != i || (int)pObj->nFans > pImage->nVars ||
+             !If_DsdImageSkip(&pCur, pEnd, sizeof(word) * If_DsdObjWordNum(pObj->nFans)) )
+            return "the objects are corrupted";
+        for ( k = 0; k < (int)pObj->nFans; k++ )
+            if ( Abc_Lit2Var(pObj->pFans[k]) >= i )
+                return "the objects are corrupted";
+    }
+    if ( !If_DsdImageSkip(&pCur, pEnd, sizeof(unsigned) * (size_t)pImage->nBins) ||
+         !If_DsdImageSkip(&pCur, pEnd, sizeof(int) * (size_t)pImage->nObjs) ||
+         !If_DsdImageSkip(&pCur, pEnd, sizeof(int) * (size_t)pImage->nObjs) )
+        return "the file is truncated";
+    for ( v = 3; v <= pImage->nVars; v++ )
+    {
+        if ( pImage->nTts[v] < 0 || pImage->nTables[v] < 0 || pImage->nDecs[v] < 0 || pImage->nDecInts[v] < 0 )
+            return "the header is corrupted";
+        if ( !If_DsdImageSkip(&pCur, pEnd, sizeof(word) * Abc_TtWordNum(v) * (size_t)pImage->nTts[v]) ||
+             !If_DsdImageSkip(&pCur, pEnd, sizeof(int) * (size_t)pImage->nTables[v]) ||
+             !If_DsdImageSkip(&pCur, pEnd, sizeof(int) * (size_t)pImage->nTts[v]) )
+            return "the file is truncated";
+        pBegs = (int *)pCur;
+        if ( !If_DsdImageSkip(&pCur, pEnd, sizeof(int) * ((size_t)pImage->nDecs[v] + 1)) ||
+             !If_DsdImageSkip(&pCur, pEnd, sizeof(int) * (size_t)pImage->nDecInts[v]) )
+            return "the file is truncated";
+        for ( i = 0; i < pImage->nDecs[v]; i++ )
+            if ( pBegs[i] < 0 || pBegs[i] > pBegs[i+1] || pBegs[i+1] > pImage->nDecInts[v] )
+                return "the decompositions are corrupted";
+    }
+    if ( !If_DsdImageSkip(&pCur, pEnd, sizeof(word) * (size_t)pImage->nConfigs) ||
+         !If_DsdImageSkip(&pCur, pEnd, (size_t)pImage->nCellStr) )
+        return "the file is truncated";
+    if ( pCur != pEnd )
+        return "the file size does not match the header";
+    return NULL;
+}
+void If_DsdManSaveMmap( If_DsdMan_t * p, char * pFileName )
+{
+    If_DsdImage_t Image, * pImage = &Image;
+    If_DsdObj_t * pObj; 
+    Vec_Int_t * vSets;
+    word * pTruth; 
+    int i, v, Num;
+    FILE * pFile;
+    assert( p->pBase == NULL );
+    pFile = fopen( pFileName ? pFileName : p->pStore, "wb" );
+    if ( pFile == NULL )
+    {
+        printf( "Writing DSD manager file \"%s\" has failed.\n", pFileName ? pFileName : p->pStore );
+        return;
+    }
+    memset( pImage, 0, sizeof(If_DsdImage_t) );
+    memcpy( pImage->pMagic, DSD_VERSION_MMAP, strlen(DSD_VERSION_MMAP) );
+    pImage->nVars        = p->nVars;
+    pImage->LutSize      = p->LutSize;
+    pImage->nObjs        = Vec_PtrSize(&p->vObjs);
+    If_DsdVecForEachObj( &p->vObjs, pObj, i )
+        pImage->nObjWords += If_DsdObjWordNum( pObj->nFans );
+    pImage->nBins        = p->nBins;
+    pImage->nConfigWords = p->nConfigWords;
+    pImage->nTtBits      = p->nTtBits;
+    pImage->nConfigs     = p->vConfigs ? Vec_WrdSize(p->vConfigs) : 0;
+    pImage->nCellStr     = p->pCellStr ? strlen(p->pCellStr) : 0;
+    for ( v = 3; v <= p->nVars; v++ )
+    {
+        pImage->nTts[v]    = Vec_MemEntryNum( p->vTtMem[v] );
+        pImage->nTables[v] = Vec_IntSize( p->vTtMem[v]->vTable );
+        pImage->nDecs[v]   = Vec_PtrSize( p->vTtDecs[v] );
+        Vec_PtrForEachEntry( Vec_Int_t *, p->vTtDecs[v], vSets, i )
+            pImage->nDecInts[v] += Vec_IntSize( vSets );
+    }
+    If_DsdImageWrite( pFile, pImage, sizeof(If_DsdImage_t) );
+    If_DsdVecForEachObj( &p->vObjs, pObj, i )
+        fwrite( pObj, sizeof(word) * If_DsdObjWordNum(pObj->nFans), 1, pFile );
+    If_DsdImageWrite( pFile, p->pBins, sizeof(unsigned) * p->nBins );
+    If_DsdImageWrite( pFile, Vec_IntArray(&p->vNexts), sizeof(int) * pImage->nObjs );
+    If_DsdImageWrite( pFile, Vec_IntArray(&p->vTruths), sizeof(int) * pImage->nObjs );
+    for ( v = 3; v <= p->nVars; v++ )
+    {
+        Vec_MemForEachEntry( p->vTtMem[v], pTruth, i )
+            fwrite( pTruth, sizeof(word) * Vec_MemEntrySize(p->vTtMem[v]), 1, pFile );
+        If_DsdImageWrite( pFile, Vec_IntArray(p->vTtMem[v]->vTable), sizeof(int) * pImage->nTables[v] );
+        If_DsdImageWrite( pFile, Vec_IntArray(p->vTtMem[v]->vNexts), sizeof(int) * pImage->nTts[v] );
+        // decompositions are stored as begin offsets followed by the sets
+        Num = 0;
+        Vec_PtrForEachEntry( Vec_Int_t *, p->vTtDecs[v], vSets, i )
+        {
+            fwrite( &Num, 4, 1, pFile );
+            Num += Vec_IntSize( vSets );
+        }
+        fwrite( &Num, 4, 1, pFile );
+        If_DsdImagePad( pFile, sizeof(int) * (pImage->nDecs[v] + 1) );
+        Vec_PtrForEachEntry( Vec_Int_t *, p->vTtDecs[v], vSets, i )
+            fwrite( Vec_IntArray(vSets), sizeof(int) * Vec_IntSize(vSets), 1, pFile );
+        If_DsdImagePad( pFile, sizeof(int) * pImage->nDecInts[v] );
+    }
+    If_DsdImageWrite( pFile, p->vConfigs ? Vec_WrdArray(p->vConfigs) : NULL, sizeof(word) * pImage->nConfigs );
+    If_DsdImageWrite( pFile, p->pCellStr, pImage->nCellStr );
+    fclose( pFile );
+}
+If_DsdMan_t * If_DsdManLoadMmap( char * pFileName, int fVerbose )
+{
+#ifdef _WIN32
+    printf( "Memory-mapped DSD manager is not supported on this platform.\n" );
+    return NULL;
+#else
+    If_DsdMan_t * p;
+    If_DsdImage_t * pImage;
+    If_DsdObj_t * pObj; 
+    Vec_Int_t * vSets;
+    struct stat Stat;
+    abctime clk = Abc_Clock();
+    char * pMapped, * pCur, * pError;
+    int i, v, * pBegs, * pSets;
+    int fd = open( pFileName, O_RDONLY );
+    if ( fd == -1 || fstat(fd, &Stat) == -1 || Stat.st_size < (off_t)sizeof(If_DsdImage_t) )
+    {
+        printf( "Reading DSD manager file \"%s\" has failed.\n", pFileName );
+        if ( fd != -1 )
+            close( fd );
+        return NULL;
+    }
+    // private writable mapping: marks and counters may be updated in place
+    pMapped = (char *)mmap( NULL, Stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+    close( fd );
+    if ( pMapped == (char *)MAP_FAILED )
+    {
+        printf( "Mapping DSD manager file \"%s\" has failed.\n", pFileName );
+        return NULL;
+    }
+    pImage = (If_DsdImage_t *)pMapped;
+    if ( strncmp(pImage->pMagic, DSD_VERSION_MMAP, strlen(DSD_VERSION_MMAP)) )
+    {
+        printf( "Unrecognized format of file \"%s\".\n", pFileName );
+        munmap( pMapped, Stat.st_size );
+        return NULL;
+    }
+    if ( (pError = If_DsdImageCheck(pMapped, Stat.st_size)) )
+    {
+        printf( "Reading DSD manager file \"%s\" has failed: %s.\n", pFileName, pError );
+        munmap( pMapped, Stat.st_size );
+        return NULL;
+    }
+    p = ABC_CALLOC( If_DsdMan_t, 1 );
+    p->pStore       = Abc_UtilStrsav( pFileName );
+    p->nVars        = pImage->nVars;
+    p->LutSize      = pImage->LutSize;
+    p->nWords       = Abc_TtWordNum( p->nVars );
+    p->pMem         = Mem_FlexStart();
+    p->nConfigWords = pImage->nConfigWords;
+    p->nTtBits      = pImage->nTtBits;
+    p->pMapped      = pMapped;
+    p->nMapped      = Stat.st_size;
+    p->fMappedVecs  = 1;
+    pCur = pMapped + sizeof(If_DsdImage_t);
+    // object pointers are the only data derived at load time
+    Vec_PtrGrow( &p->vObjs, pImage->nObjs );
+    for ( i = 0; i < pImage->nObjs; i++ )
+    {
+        pObj = (If_DsdObj_t *)pCur;
+        assert( (int)pObj->Id == i );
+        Vec_PtrPush( &p->vObjs, pObj );
+        pCur += sizeof(word) * If_DsdObjWordNum( pObj->nFans );
+    }
+    p->nBins = pImage->nBins;
+    p->pBins = (unsigned *)If_DsdImageNext( &pCur, sizeof(unsigned) * p->nBins );
+    If_DsdImageVecInt( &p->vNexts,  (int *)If_DsdImageNext(&pCur, sizeof(int) * pImage->nObjs), pImage->nObjs );
+    If_DsdImageVecInt( &p->vTruths, (int *)If_DsdImageNext(&pCur, sizeof(int) * pImage->nObjs), pImage->nObjs );
+    p->vTemp1   = Vec_IntAlloc( 32 );
+    p->vTemp2   = Vec_IntAlloc( 32 );
+    p->pTtElems = If_ManDsdTtElems();
+    for ( v = 3; v <= p->nVars; v++ )
+    {
+        Vec_Mem_t * vTtMem = p->vTtMem[v] = Vec_MemAlloc( Abc_TtWordNum(v), 12 );
+        word * pTts = (word *)If_DsdImageNext( &pCur, sizeof(word) * vTtMem->nEntrySize * pImage->nTts[v] );
+        vTtMem->nEntries   = pImage->nTts[v];
+        vTtMem->iPage      = vTtMem->nEntries ? (vTtMem->nEntries - 1) >> vTtMem->LogPageSze : -1;
+        vTtMem->nPageAlloc = vTtMem->iPage + 1;
+        vTtMem->ppPages    = ABC_ALLOC( word *, Abc_MaxInt(vTtMem->nPageAlloc, 1) );
+        for ( i = 0; i <= vTtMem->iPage; i++ )
+            vTtMem->ppPages[i] = pTts + ((size_t)vTtMem->nEntrySize << vTtMem->LogPageSze) * i;
+        vTtMem->vTable = If_DsdImageVecInt( ABC_ALLOC(Vec_Int_t, 1), (int *)If_DsdImageNext(&pCur, sizeof(int) * pImage->nTables[v]), pImage->nTables[v] );
+        vTtMem->vNexts = If_DsdImageVecInt( ABC_ALLOC(Vec_Int_t, 1), (int *)If_DsdImageNext(&pCur, sizeof(int) * pImage->nTts[v]), pImage->nTts[v] );
+        pBegs = (int *)If_DsdImageNext( &pCur, sizeof(int) * (pImage->nDecs[v] + 1) );
+        pSets = (int *)If_DsdImageNext( &pCur, sizeof(int) * pImage->nDecInts[v] );
+        p->vTtDecs[v] = Vec_PtrAlloc( pImage->nDecs[v] );
+        p->pDecsMapped[v] = ABC_ALLOC( Vec_Int_t, Abc_MaxInt(pImage->nDecs[v], 1) );
+        for ( i = 0; i < pImage->nDecs[v]; i++ )
+        {
+            vSets = If_DsdImageVecInt( p->pDecsMapped[v] + i, pSets + pBegs[i], pBegs[i+1] - pBegs[i] );
+            Vec_PtrPush( p->vTtDecs[v], vSets );
+        }
+    }
+    if ( pImage->nConfigs )
+    {
+        p->vConfigs = ABC_ALLOC( Vec_Wrd_t, 1 );
+        p->vConfigs->pArray = (word *)If_DsdImageNext( &pCur, sizeof(word) * pImage->nConfigs );
+        p->vConfigs->nSize  = p->vConfigs->nCap = pImage->nConfigs;
+    }
+    if ( pImage->nCellStr )
+    {
+        p->pCellStr = ABC_CALLOC( char, pImage->nCellStr + 1 );
+        memcpy( p->pCellStr, If_DsdImageNext(&pCur, pImage->nCellStr), pImage->nCellStr );
+    }
+    assert( pCur == pMapped + p->nMapped );
+    for ( v = 2; v < p->nVars; v++ )
+        p->pSched[v] = Extra_GreyCodeSchedule( v );
+    if ( p->LutSize )
+    p->pSat     = If_ManSatBuildXY( p->LutSize );
+    p->vCover   = Vec_IntAlloc( 0 );
+    if ( fVerbose )
+    {
+        long nPageSize = sysconf( _SC_PAGESIZE );
+        size_t k, nPages = (p->nMapped + nPageSize - 1) / nPageSize, nResident = 0;
+        unsigned char * pResident = ABC_CALLOC( unsigned char, nPages );
+        if ( mincore( pMapped, p->nMapped, pResident ) == 0 )
+            for ( k = 0; k < nPages; k++ )
+                nResident += (pResident[k] & 1);
+        ABC_FREE( pResident );
+        printf( "Mapped %d objects from \"%s\": image = %.2f MB, resident = %.2f MB, heap = %.2f MB.  ", 
+            Vec_PtrSize(&p->vObjs), pFileName, 1.0*p->nMapped/(1<<20), 1.0*nResident*nPageSize/(1<<20), 
+            1.0*sizeof(void *)*Vec_PtrCap(&p->vObjs)/(1<<20) );
+        Abc_PrintTime( 1, "Time", Abc_Clock() - clk );
+    }
+    return p;
+#endif
+}
 void If_DsdManMerge( If_DsdMan_t * p, If_DsdMan_t * pNew )
 {
     If_DsdObj_t * pObj; 
@@ -1219,6 +1701,7 @@ void If_DsdManMerge( If_DsdMan_t * p, If_DsdMan_t * pNew )
     }
     assert( p->nTtBits == pNew->nTtBits );
     assert( p->nConfigWords == pNew->nConfigWords );
+    If_DsdManMaterialize( p );
     if ( If_DsdManHasMarks(p) != If_DsdManHasMarks(pNew) )
         printf( "Warning! Old manager has %smarks while new manager has %smarks.\n", 
             If_DsdManHasMarks(p) ? "" : "no ", If_DsdManHasMarks(pNew) ? "" : "no " );
@@ -1248,6 +1731,37 @@ void If_DsdManMerge( If_DsdMan_t * p, If_DsdMan_t * pNew )
     if ( p->vConfigs && pNew->vConfigs )
         Vec_WrdShrink( p->vConfigs, p->nConfigWords * Vec_PtrSize(&p->vObjs) );
 }
+// adds the structures found in the overlay to its base; the overlay is not freed
+void If_DsdManMergeOverlay( If_DsdMan_t * p, If_DsdMan_t * pOver )
+{
+    If_DsdObj_t * pObj; 
+    Vec_Int_t * vMap;
+    int pFanins[DAU_MAX_VAR];
+    int i, k, iFanin, Id, nObjsOld = Vec_PtrSize(&p->vObjs);
+    assert( pOver->pBase == p );
+    assert( pOver->nObjsBase <= Vec_PtrSize(&p->vObjs) );
+    vMap = Vec_IntStartNatural( Vec_PtrSize(&pOver->vObjs) );
+    If_DsdVecForEachObjStart( &pOver->vObjs, pObj, i, pOver->nObjsBase )
+    {
+        If_DsdObjForEachFaninLit( &pOver->vObjs, pObj, iFanin, k )
+            pFanins[k] = Abc_Lit2LitV( Vec_IntArray(vMap), iFanin );
+        Id = If_DsdObjFindOrAdd( p, pObj->Type, pFanins, pObj->nFans, pObj->Type == IF_DSD_PRIME ? If_DsdObjTruth(pOver, pObj) : NULL );
+        if ( pObj->fMark )
+            If_DsdVecObjSetMark( &p->vObjs, Id );
+        Vec_IntWriteEntry( vMap, i, Id );
+    }
+    // extend the configurations to the added objects, as If_DsdManMerge does
+    // (adding an object has already copied a memory-mapped image)
+    if ( p->vConfigs && Vec_PtrSize(&p->vObjs) > nObjsOld )
+    {
+        Vec_WrdFillExtra( p->vConfigs, p->nConfigWords * Vec_PtrSize(&p->vObjs), 0 );
+        if ( pOver->vConfigs )
+            Vec_IntForEachEntryStart( vMap, Id, i, pOver->nObjsBase )
+                if ( Id >= nObjsOld && p->nConfigWords * (i + 1) <= Vec_WrdSize(pOver->vConfigs) )
+                    memcpy( Vec_WrdEntryP(p->vConfigs, p->nConfigWords * Id), Vec_WrdEntryP(pOver->vConfigs, p->nConfigWords * i), sizeof(word) * p->nConfigWords );
+    }
+    Vec_IntFree( vMap );
+}
 void If_DsdManCleanOccur( If_DsdMan_t * p, int fVerbose )
 {
     If_DsdObj_t * pObj; 
@@ -1259,6 +1773,7 @@ void If_DsdManCleanMarks( If_DsdMan_t * p, int fVerbose )
 {
     If_DsdObj_t * pObj; 
     int i;
+    If_DsdManMaterialize( p );
     ABC_FREE( p->pCellStr );
     Vec_WrdFreeP( &p->vConfigs );
     If_DsdVecForEachObj( &p->vObjs, pObj, i )
@@ -1427,15 +1942,11 @@ void If_DsdManComputeTruthPtr( If_DsdMan_t * p, int iDsd, unsigned char * pPermL
         If_DsdManComputeTruth_rec( p, iDsd, pRes, pPermLits, &nSupp );
     assert( nSupp == If_DsdVecLitSuppSize(&p->vObjs, iDsd) );
 }
+// the result is valid until the next call; each mapping thread has its own overlay manager
 word * If_DsdManComputeTruth( If_DsdMan_t * p, int iDsd, unsigned char * pPermLits )
 {
-#ifndef PIF_MULTITHREAD //ymc
-    word * pRes = p->pTtElems[DAU_MAX_VAR];
-#else
-    word * pRes = (word*) malloc(sizeof(word)*DAU_MAX_WORD);
-#endif
-    If_DsdManComputeTruthPtr( p, iDsd, pPermLits, pRes );
-    return pRes;
+    If_DsdManComputeTruthPtr( p, iDsd, pPermLits, p->pTtRes );
+    return p->pTtRes;
 }
 
 /**Function*************************************************************
@@ -1620,7 +2131,7 @@ int If_DsdManOperation( If_DsdMan_t * p, int Type, int * pLits, int nLits, unsig
     {
         char pCanonPerm[DAU_MAX_VAR];
         int i, uCanonPhase, pFirsts[DAU_MAX_VAR];
-        uCanonPhase = Abc_TtCanonicize( pTruth, nLits, pCanonPerm );
+        uCanonPhase = Abc_TtCanonicizeCache( pTruth, nLits, pCanonPerm );
         fCompl = ((uCanonPhase >> nLits) & 1);
         nSSize = If_DsdManComputeFirstArray( p, pLits, nLits, pFirsts );
         for ( j = i = 0; i < nLits; i++ )
@@ -1893,7 +2404,7 @@ unsigned If_DsdManCheckPrime( If_DsdMan_t * p, int iFirst, unsigned uMaskNot, If
     int i, v, set, LimitOut, SizeIn, SizeOut, pSSizes[DAU_MAX_VAR], pFirsts[DAU_MAX_VAR];
     int truthId = If_DsdObjTruthId(p, pObj);
     int nFans = If_DsdObjFaninNum(pObj);
-    Vec_Int_t * vSets = (Vec_Int_t *)Vec_PtrEntry(p->vTtDecs[pObj->nFans], truthId);
+    Vec_Int_t * vSets = If_DsdManTtDecs(p, pObj->nFans, truthId);
 if ( fVerbose )
 printf( "\n" );
 if ( fVerbose )
@@ -2035,9 +2546,6 @@ unsigned If_DsdManCheckXY( If_DsdMan_t * p, int iDsd, int LutSize, int fDerive,
 //            If_DsdManPrintOne( stdout, p, Abc_Lit2Var(iDsd), NULL, 1 );
 //            Dau_DecPrintSet( uSet, nVars, 1 );
         }
-#ifdef PIF_MULTITHREAD //ymc
-        free(pRes);
-#endif
 //        p->timeCheck2 += Abc_Clock() - clk;
     }
     return uSet;
@@ -2091,7 +2599,6 @@ int If_DsdManCompute( If_DsdMan_t * p, word * pTruth, int nLeaves, unsigned char
     assert( nSupp == nLeaves );
     // verify the result
 //clk = Abc_Clock();
-//ymc: If_DsdManComputeTruth is not thread-safe!!!!!!
     word* pRes = If_DsdManComputeTruth( p, iDsd, pPerm );
 //p->timeVerify += Abc_Clock() - clk;
     if ( !Abc_TtEqual(pRes, pTruth, nWords) )
@@ -2106,10 +2613,8 @@ int If_DsdManCompute( If_DsdMan_t * p, word * pTruth, int nLeaves, unsigned char
         printf( "\n" );
     }
 
-#ifdef PIF_MULTITHREAD //ymc
-    free(pRes);
-#endif
-    If_DsdVecObjIncRef( &p->vObjs, Abc_Lit2Var(iDsd) );
+    if ( Abc_Lit2Var(iDsd) >= p->nObjsBase ) // base objects are shared read-only
+        If_DsdVecObjIncRef( &p->vObjs, Abc_Lit2Var(iDsd) );
     assert( If_DsdVecLitSuppSize(&p->vObjs, iDsd) == nLeaves );
     return iDsd;
 }
@@ -2456,10 +2961,6 @@ void If_DsdManTune( If_DsdMan_t * p, int LutSize, int fFast, int fAdd, int fSpec
         {
             pTruth = If_DsdManComputeTruth( p, Abc_Var2Lit(i, 0), NULL );
             Value = If_ManSatCheckXYall( pSat, LutSize, pTruth, nVars, vLits );
-#ifdef PIF_MULTITHREAD //ymc
-            free(pTruth);
-#endif
-
         }
         if ( Value )
             continue;
@@ -2523,6 +3024,7 @@ void Id_DsdManTuneStr1( If_DsdMan_t * p, char * pStruct, int nConfls, int fVerbo
     If_DsdVecForEachObj( &p->vObjs, pObj, i )
         if ( i >= p->nObjsPrev )
             pObj->fMark = 0;
+    If_DsdManMaterialize( p );
     if ( p->vConfigs == NULL )
         p->vConfigs = Vec_WrdStart( p->nConfigWords * Vec_PtrSize(&p->vObjs) );
     else
@@ -2542,9 +3044,6 @@ void Id_DsdManTuneStr1( If_DsdMan_t * p, char * pStruct, int nConfls, int fVerbo
             printf( "%6d : %2d ", i, nVars );
         pConfig = Vec_WrdEntryP( p->vConfigs, p->nConfigWords * i );
         Value = Ifn_NtkMatch( pNtk, pTruth, nVars, nConfls, fVerbose, fVeryVerbose, pConfig );
-#ifdef PIF_MULTITHREAD //ymc
-        free(pTruth);
-#endif
         if ( fVeryVerbose )
             printf( "\n" );
         if ( Value == 0 )
@@ -2672,6 +3171,7 @@ void Id_DsdManTuneStr( If_DsdMan_t * p, char * pStruct, int nConfls, int nProcs,
     If_DsdVecForEachObj( &p->vObjs, pObj, i )
         if ( i >= p->nObjsPrev )
             pObj->fMark = 0;
+    If_DsdManMaterialize( p );
     if ( p->vConfigs == NULL )
         p->vConfigs = Vec_WrdStart( p->nConfigWords * Vec_PtrSize(&p->vObjs) );
     else
@@ -2807,6 +3307,7 @@ void Id_DsdManTuneThresh( If_DsdMan_t * p, int fUnate, int fThresh, int fThreshH
     If_DsdVecForEachObj( &p->vObjs, pObj, i )
         if ( i >= p->nObjsPrev )
             pObj->fMark = 0;
+    If_DsdManMaterialize( p );
     if ( p->vConfigs == NULL )
         p->vConfigs = Vec_WrdStart( Vec_PtrSize(&p->vObjs) );
     else
@@ -2851,6 +3352,417 @@ void Id_DsdManTuneThresh( If_DsdMan_t * p, int fUnate, int fThresh, int fThreshH
 
 #endif // ABC_USE_CUDD are used
 
+/**Function*************************************************************
+
+  Synopsis    [Parallel tuning engine.]
+
+  Description [Runs the per-object checks of If_DsdManTune() and
+  Id_DsdManTuneThresh() on several threads. The objects are handed out
+  in chunks; each thread works on a shallow copy of the manager with its
+  own scratch vectors, truth table and SAT solver, and records the outcome
+  of each object in a separate array, which is applied to the marks by the
+  calling thread after all chunks are finished. The finished prefix of this
+  array is periodically saved into a checkpoint file, from which an
+  interrupted run is resumed.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+#define IF_DSD_TUNE_CHUNK      256     // objects per work item
+#define IF_DSD_TUNE_THR_MAX     64     // the max number of threads
+#define IF_DSD_TUNE_PROGRESS    10     // seconds between progress reports
+#define IF_DSD_TUNE_CKPT        60     // seconds between checkpoints
+#define IF_DSD_TUNE_VERSION "dsdckpt1"
+
+// the checks performed
+#define IF_DSD_TUNE_LUT          0     // decomposition into two LUTs (If_DsdManTune)
+#define IF_DSD_TUNE_UNATE        1     // unateness (Id_DsdManTuneThresh)
+#define IF_DSD_TUNE_THRESH       2     // threshold functions
+#define IF_DSD_TUNE_THRESH_H     3     // threshold functions (heuristic)
+
+// the outcome of the check
+#define IF_DSD_RES_NONE          0     // not checked yet
+#define IF_DSD_RES_KEEP          1     // the object is not changed
+#define IF_DSD_RES_CLEAR         2     // the mark is removed (the config is reset)
+#define IF_DSD_RES_SET           3     // the mark is set
+
+typedef struct If_DsdTune_t_ If_DsdTune_t;
+struct If_DsdTune_t_
+{
+    If_DsdMan_t *   p;             // the manager (read-only while tuning)
+    int             Mode;          // the check performed
+    int             LutSize;       // the LUT size
+    int             fFast;         // skip the SAT-based check
+    int             fAdd;          // only recheck the marked objects
+    int             iStart;        // the first object to check
+    int             iFirst;        // the first object checked in this run
+    int             nObjs;         // the number of objects
+    word            Sign;          // the signature of the manager
+    char *          pFileName;     // the checkpoint file
+    char *          pRes;          // the outcome for each object
+    char *          pDone;         // the finished chunks
+    int             nChunks;       // the number of chunks
+    int             iChunkNext;    // the next chunk to hand out
+    int             iChunkDone;    // the chunks below are finished
+    int             nDone;         // the number of finished objects
+    int             nDoneStart;    // the number of objects finished before this run
+    int             nMarked;       // the number of marked objects
+    time_t          timeStart;     // the start of this run
+    time_t          timeProgress;  // the last progress report
+    time_t          timeCkpt;      // the last checkpoint
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_t Mutex;         // protects the counters above
+#endif
+};
+
+typedef struct If_DsdTuneThr_t_ If_DsdTuneThr_t;
+struct If_DsdTuneThr_t_
+{
+    If_DsdTune_t *  pTune;         // the shared data
+    If_DsdMan_t     Man;           // the copy of the manager with private scratch
+    Vec_Int_t *     vLits;         // literals of the SAT solver
+    word            pTruth[DAU_MAX_WORD]; // the truth table of the object
+    int             nChecked;      // statistics
+    abctime         clkTotal;      // statistics
+};
+
+static word If_DsdTuneSign( If_DsdMan_t * p )
+{
+    If_DsdObj_t * pObj; int i;
+    word Sign = 0x9E3779B97F4A7C15;
+    If_DsdVecForEachObj( &p->vObjs, pObj, i )
+    {
+        Sign ^= (word)(pObj->Type | (pObj->nSupp << 3) | (pObj->fMark << 8) | (pObj->nFans << 9)) + ((word)If_DsdObjTruthId(p, pObj) << 16);
+        Sign *= 0x100000001B3;
+    }
+    return Sign;
+}
+static void If_DsdTuneHeader( If_DsdTune_t * pTune, int * pHead )
+{
+    pHead[0] = pTune->Mode;
+    pHead[1] = pTune->LutSize;
+    pHead[2] = pTune->fFast;
+    pHead[3] = pTune->fAdd;
+    pHead[4] = pTune->iStart;
+    pHead[5] = pTune->nObjs;
+}
+static void If_DsdTuneCkptWrite( If_DsdTune_t * pTune, int fVerbose )
+{
+    int pHead[6], iDone = Abc_MinInt( pTune->iFirst + pTune->iChunkDone * IF_DSD_TUNE_CHUNK, pTune->nObjs );
+    char * pFileTemp = ABC_ALLOC( char, strlen(pTune->pFileName) + 5 );
+    FILE * pFile;
+    sprintf( pFileTemp, "%s.tmp", pTune->pFileName );
+    pFile = fopen( pFileTemp, "wb" );
+    if ( pFile == NULL )
+    {
+        printf( "Cannot open checkpoint file \"%s\" for writing.\n", pFileTemp );
+        ABC_FREE( pFileTemp );
+        return;
+    }
+    If_DsdTuneHeader( pTune, pHead );
+    fwrite( IF_DSD_TUNE_VERSION, 1, 8, pFile );
+    fwrite( pHead, sizeof(int), 6, pFile );
+    fwrite( &pTune->Sign, sizeof(word), 1, pFile );
+    fwrite( &iDone, sizeof(int), 1, pFile );
+    fwrite( pTune->pRes + pTune->iStart, 1, iDone - pTune->iStart, pFile );
+    fclose( pFile );
+    // replace the old checkpoint only when the new one is complete
+    remove( pTune->pFileName );
+    if ( rename( pFileTemp, pTune->pFileName ) )
+        printf( "Cannot rename checkpoint file \"%s\" into \"%s\".\n", pFileTemp, pTune->pFileName );
+    else if ( fVerbose )
+        printf( "Saved checkpoint with %d objects into file \"%s\".\n", iDone - pTune->iStart, pTune->pFileName );
+    ABC_FREE( pFileTemp );
+}
+static int If_DsdTuneCkptRead( If_DsdTune_t * pTune )
+{
+    char pBuffer[8];
+    int pHead[6], pHeadFile[6], iDone = -1, RetValue = 0;
+    word Sign = 0;
+    FILE * pFile = fopen( pTune->pFileName, "rb" );
+    if ( pFile == NULL )
+        return pTune->iStart;
+    If_DsdTuneHeader( pTune, pHead );
+    RetValue += fread( pBuffer, 1, 8, pFile );
+    RetValue += fread( pHeadFile, sizeof(int), 6, pFile );
+    RetValue += fread( &Sign, sizeof(word), 1, pFile );
+    RetValue += fread( &iDone, sizeof(int), 1, pFile );
+    if ( RetValue != 16 || strncmp(pBuffer, IF_DSD_TUNE_VERSION, 8) || memcmp(pHead, pHeadFile, sizeof(int) * 6) || Sign != pTune->Sign || 
+         iDone < pTune->iStart || iDone > pTune->nObjs || (int)fread(pTune->pRes + pTune->iStart, 1, iDone - pTune->iStart, pFile) != iDone - pTune->iStart )
+    {
+        printf( "Checkpoint file \"%s\" does not match the current library or parameters and is ignored.\n", pTune->pFileName );
+        memset( pTune->pRes, IF_DSD_RES_NONE, pTune->nObjs );
+        iDone = pTune->iStart;
+    }
+    fclose( pFile );
+    return iDone;
+}
+static void If_DsdTunePrintProgress( If_DsdTune_t * pTune, time_t timeNow )
+{
+    int nAll  = pTune->nObjs - pTune->iStart;
+    int nDone = pTune->nDone - pTune->nDoneStart;
+    int timeElapsed = (int)(timeNow - pTune->timeStart);
+    int timeLeft = nDone ? (int)((double)timeElapsed * (nAll - pTune->nDone) / nDone) : -1;
+    printf( "Checked %9d / %9d objects (%5.1f %%).  Marked = %8d.  Elapsed = %6d sec.  ETA = ", 
+        pTune->nDone, nAll, 100.0 * pTune->nDone / Abc_MaxInt(nAll, 1), pTune->nMarked, timeElapsed );
+    if ( timeLeft >= 0 )
+        printf( "%6d sec.\n", timeLeft );
+    else
+        printf( "   n/a\n" );
+    fflush( stdout );
+}
+static int If_DsdTuneObj( If_DsdTuneThr_t * pThr, int i )
+{
+    extern int Extra_ThreshCheck( word * t, int nVars, int * pW );
+    extern int Extra_ThreshHeuristic( word * t, int nVars, int * pW );
+    If_DsdTune_t * pTune = pThr->pTune;
+    If_DsdMan_t * p = &pThr->Man;
+    If_DsdObj_t * pObj = If_DsdVecObj( &p->vObjs, i );
+    int nVars = If_DsdObjSuppSize(pObj), Value = 0, pW[16];
+    if ( pTune->Mode == IF_DSD_TUNE_LUT )
+    {
+        if ( nVars <= pTune->LutSize )
+            return IF_DSD_RES_KEEP;
+        if ( pTune->fAdd && !pObj->fMark )
+            return IF_DSD_RES_KEEP;
+        if ( If_DsdManCheckXY(p, Abc_Var2Lit(i, 0), pTune->LutSize, 0, 0, 0, 0) )
+            return IF_DSD_RES_CLEAR;
+        if ( !pTune->fFast )
+        {
+            If_DsdManComputeTruthPtr( p, Abc_Var2Lit(i, 0), NULL, pThr->pTruth );
+            Value = If_ManSatCheckXYall( p->pSat, pTune->LutSize, pThr->pTruth, nVars, pThr->vLits );
+        }
+        return Value ? IF_DSD_RES_CLEAR : IF_DSD_RES_SET;
+    }
+    if ( nVars > 8 )
+        return IF_DSD_RES_KEEP;
+    If_DsdManComputeTruthPtr( p, Abc_Var2Lit(i, 0), NULL, pThr->pTruth );
+    if ( pTune->Mode == IF_DSD_TUNE_UNATE )
+        Value = Abc_TtIsUnate( pThr->pTruth, nVars );
+#ifdef ABC_USE_CUDD
+    else if ( pTune->Mode == IF_DSD_TUNE_THRESH )
+        Value = Extra_ThreshCheck( pThr->pTruth, nVars, pW );
+    else if ( pTune->Mode == IF_DSD_TUNE_THRESH_H )
+        Value = Extra_ThreshHeuristic( pThr->pTruth, nVars, pW );
+#endif
+    return Value ? IF_DSD_RES_SET : IF_DSD_RES_CLEAR;
+}
+// finishes the previous chunk (if any) and returns the next one (or -1)
+static int If_DsdTuneNext( If_DsdTune_t * pTune, int iChunkPrev )
+{
+    int i, iChunk = -1;
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_lock( &pTune->Mutex );
+#endif
+    if ( iChunkPrev >= 0 )
+    {
+        int iBeg = pTune->iFirst + iChunkPrev * IF_DSD_TUNE_CHUNK;
+        int iEnd = Abc_MinInt( iBeg + IF_DSD_TUNE_CHUNK, pTune->nObjs );
+        time_t timeNow = time( NULL );
+        for ( i = iBeg; i < iEnd; i++ )
+            pTune->nMarked += (pTune->pRes[i] == IF_DSD_RES_SET);
+        pTune->nDone += iEnd - iBeg;
+        pTune->pDone[iChunkPrev] = 1;
+        while ( pTune->iChunkDone < pTune->nChunks && pTune->pDone[pTune->iChunkDone] )
+            pTune->iChunkDone++;
+        if ( timeNow - pTune->timeProgress >= IF_DSD_TUNE_PROGRESS )
+        {
+            If_DsdTunePrintProgress( pTune, timeNow );
+            pTune->timeProgress = timeNow;
+        }
+        if ( pTune->pFileName && timeNow - pTune->timeCkpt >= IF_DSD_TUNE_CKPT )
+        {
+            If_DsdTuneCkptWrite( pTune, 0 );
+            pTune->timeCkpt = timeNow;
+        }
+    }
+    if ( pTune->iChunkNext < pTune->nChunks )
+        iChunk = pTune->iChunkNext++;
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_unlock( &pTune->Mutex );
+#endif
+    return iChunk;
+}
+static void * If_DsdTuneWorker( void * pArg )
+{
+    If_DsdTuneThr_t * pThr = (If_DsdTuneThr_t *)pArg;
+    If_DsdTune_t * pTune = pThr->pTune;
+    int i, iBeg, iEnd, iChunk = -1;
+    while ( (iChunk = If_DsdTuneNext(pTune, iChunk)) >= 0 )
+    {
+        abctime clk = Abc_Clock();
+        iBeg = pTune->iFirst + iChunk * IF_DSD_TUNE_CHUNK;
+        iEnd = Abc_MinInt( iBeg + IF_DSD_TUNE_CHUNK, pTune->nObjs );
+        for ( i = iBeg; i < iEnd; i++ )
+            pTune->pRes[i] = (char)If_DsdTuneObj( pThr, i );
+        pThr->nChecked += iEnd - iBeg;
+        pThr->clkTotal += Abc_Clock() - clk;
+    }
+    return NULL;
+}
+static void If_DsdManTuneRun( If_DsdMan_t * p, int Mode, int LutSize, int fFast, int fAdd, int iStart, int nProcs, char * pFileName, int fVerbose )
+{
+    If_DsdTune_t Tune, * pTune = &Tune;
+    If_DsdTuneThr_t * pThrs;
+    int i, Res, nFound = 0;
+    abctime clk = Abc_Clock();
+#ifdef ABC_USE_PTHREADS
+    pthread_t WorkerThread[IF_DSD_TUNE_THR_MAX];
+    int fStarted[IF_DSD_TUNE_THR_MAX] = {0};
+    nProcs = Abc_MinInt( Abc_MaxInt(nProcs, 1), IF_DSD_TUNE_THR_MAX );
+#else
+    nProcs = 1;
+#endif
+    memset( pTune, 0, sizeof(If_DsdTune_t) );
+    pTune->p         = p;
+    pTune->Mode      = Mode;
+    pTune->LutSize   = LutSize;
+    pTune->fFast     = fFast;
+    pTune->fAdd      = fAdd;
+    pTune->iStart    = iStart;
+    pTune->nObjs     = Vec_PtrSize(&p->vObjs);
+    pTune->pFileName = pFileName;
+    pTune->pRes      = ABC_CALLOC( char, pTune->nObjs + 1 );
+    if ( pFileName )
+    {
+        pTune->Sign   = If_DsdTuneSign( p );
+        pTune->iFirst = If_DsdTuneCkptRead( pTune );
+        if ( pTune->iFirst > iStart )
+        {
+            for ( i = iStart; i < pTune->iFirst; i++ )
+                pTune->nMarked += (pTune->pRes[i] == IF_DSD_RES_SET);
+            printf( "Resuming from checkpoint \"%s\" with %d checked objects (out of %d).\n", pFileName, pTune->iFirst - iStart, pTune->nObjs - iStart );
+        }
+    }
+    else
+        pTune->iFirst = iStart;
+    pTune->nDone = pTune->nDoneStart = pTune->iFirst - iStart;
+    pTune->nChunks = (pTune->nObjs - pTune->iFirst + IF_DSD_TUNE_CHUNK - 1) / IF_DSD_TUNE_CHUNK;
+    pTune->pDone = ABC_CALLOC( char, pTune->nChunks + 1 );
+    pTune->timeStart = pTune->timeProgress = pTune->timeCkpt = time( NULL );
+    // prepare the thread data
+    pThrs = ABC_CALLOC( If_DsdTuneThr_t, nProcs );
+    for ( i = 0; i < nProcs; i++ )
+    {
+        pThrs[i].pTune = pTune;
+        pThrs[i].Man = *p;
+        pThrs[i].Man.vTemp1 = Vec_IntAlloc( 100 );
+        pThrs[i].Man.vTemp2 = Vec_IntAlloc( 100 );
+        pThrs[i].Man.pSat = (Mode == IF_DSD_TUNE_LUT && !fFast) ? If_ManSatBuildXY( LutSize ) : NULL;
+        pThrs[i].vLits = Vec_IntAlloc( 1000 );
+    }
+    // the calling thread is worker 0
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_init( &pTune->Mutex, NULL );
+    // a worker that fails to start is skipped; its chunks go to the others
+    for ( i = 1; i < nProcs; i++ )
+        fStarted[i] = !pthread_create( WorkerThread + i, NULL, If_DsdTuneWorker, (void *)(pThrs + i) );
+    If_DsdTuneWorker( pThrs );
+    for ( i = 1; i < nProcs; i++ )
+        if ( fStarted[i] )
+            pthread_join( WorkerThread[i], NULL );
+    pthread_mutex_destroy( &pTune->Mutex );
+#else
+    If_DsdTuneWorker( pThrs );
+#endif
+    assert( pTune->iChunkDone == pTune->nChunks );
+    if ( pFileName )
+        If_DsdTuneCkptWrite( pTune, fVerbose );
+    // apply the results
+    for ( i = iStart; i < pTune->nObjs; i++ )
+    {
+        Res = pTune->pRes[i];
+        assert( Res != IF_DSD_RES_NONE );
+        if ( Res == IF_DSD_RES_SET )
+        {
+            If_DsdVecObjSetMark( &p->vObjs, i );
+            nFound++;
+        }
+        else if ( Res == IF_DSD_RES_CLEAR && Mode == IF_DSD_TUNE_LUT )
+            If_DsdVecObjClearMark( &p->vObjs, i );
+        else if ( Res == IF_DSD_RES_CLEAR )
+            Vec_WrdWriteEntry( p->vConfigs, i, 0 );
+    }
+    if ( fVerbose )
+    {
+        for ( i = 0; i < nProcs; i++ )
+        {
+            printf( "Thread %2d : Checked = %9d.  ", i, pThrs[i].nChecked );
+            Abc_PrintTime( 1, "Time", pThrs[i].clkTotal );
+        }
+        printf( "Checked %d objects using %d thread%s.  Marked = %d.  ", pTune->nObjs - iStart, nProcs, nProcs > 1 ? "s" : "", nFound );
+        Abc_PrintTime( 1, "Time", Abc_Clock() - clk );
+    }
+    for ( i = 0; i < nProcs; i++ )
+    {
+        Vec_IntFree( pThrs[i].Man.vTemp1 );
+        Vec_IntFree( pThrs[i].Man.vTemp2 );
+        if ( pThrs[i].Man.pSat )
+            If_ManSatUnbuild( pThrs[i].Man.pSat );
+        Vec_IntFree( pThrs[i].vLits );
+    }
+    ABC_FREE( pThrs );
+    ABC_FREE( pTune->pDone );
+    ABC_FREE( pTune->pRes );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Parallel versions of If_DsdManTune() and Id_DsdManTuneThresh().]
+
+  Description [Produce the same marks as the serial versions. If the
+  checkpoint file is given, the run is resumed from it when it matches
+  the library and the parameters, and it is updated during the run.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_DsdManTunePar( If_DsdMan_t * p, int LutSize, int fFast, int fAdd, int fSpec, int nProcs, char * pFileName, int fVerbose )
+{
+    If_DsdObj_t * pObj;
+    int i;
+    if ( !fAdd || !LutSize )
+        If_DsdVecForEachObj( &p->vObjs, pObj, i )
+            pObj->fMark = 0;
+    if ( LutSize == 0 )
+        return;
+    If_DsdManTuneRun( p, IF_DSD_TUNE_LUT, LutSize, fFast, fAdd, 0, nProcs, pFileName, fVerbose );
+    if ( fVerbose )
+        If_DsdManPrintDistrib( p );
+}
+#ifdef ABC_USE_CUDD
+void Id_DsdManTuneThreshPar( If_DsdMan_t * p, int fUnate, int fThresh, int fThreshHeuristic, int nProcs, char * pFileName, int fVerbose )
+{
+    If_DsdObj_t * pObj;
+    int i, Mode = fUnate ? IF_DSD_TUNE_UNATE : fThresh ? IF_DSD_TUNE_THRESH : IF_DSD_TUNE_THRESH_H;
+    abctime clk = Abc_Clock();
+    assert( fUnate + fThresh + fThreshHeuristic == 1 );
+    // the heuristic uses the global BDD manager
+    if ( fThreshHeuristic )
+        nProcs = 1;
+    if ( p->nObjsPrev > 0 )
+        printf( "Starting the tuning process from object %d (out of %d).\n", p->nObjsPrev, Vec_PtrSize(&p->vObjs) );
+    // clean the attributes
+    If_DsdVecForEachObj( &p->vObjs, pObj, i )
+        if ( i >= p->nObjsPrev )
+            pObj->fMark = 0;
+    If_DsdManMaterialize( p );
+    if ( p->vConfigs == NULL )
+        p->vConfigs = Vec_WrdStart( Vec_PtrSize(&p->vObjs) );
+    else
+        Vec_WrdFillExtra( p->vConfigs, Vec_PtrSize(&p->vObjs), 0 );
+    If_DsdManTuneRun( p, Mode, 0, 0, 0, p->nObjsPrev, nProcs, pFileName, fVerbose );
+    p->nObjsPrev = 0;
+    p->LutSize = 0;
+    printf( "Finished matching %d functions. ", Vec_PtrSize(&p->vObjs) );
+    Abc_PrintTime( 1, "Time", Abc_Clock() - clk );
+}
+#endif // ABC_USE_CUDD are used
+
 ////////////////////////////////////////////////////////////////////////
 ///                       END OF FILE                                ///
 ////////////////////////////////////////////////////////////////////////
@@ -29,8 +29,8 @@ ABC_NAMESPACE_IMPL_START
 
 static If_Obj_t * If_ManSetupObj( If_Man_t * p );
 
-static void       If_ManCutSetRecycle( If_Man_t * p, If_Set_t * pSet ) { pSet->pNext = p->pFreeList; p->pFreeList = pSet;                            }
-static If_Set_t * If_ManCutSetFetch( If_Man_t * p )                    { If_Set_t * pTemp = p->pFreeList; p->pFreeList = p->pFreeList->pNext; return pTemp; }
+static void       If_ManCutSetRecycle( If_Man_t * p, If_Set_t * pSet ) { pSet->pNext = p->pFreeList; p->pFreeList = pSet; p->nSetsUsed--;             }
+static If_Set_t * If_ManCutSetFetch( If_Man_t * p )                    { If_Set_t * pTemp = p->pFreeList; assert( pTemp ); p->pFreeList = p->pFreeList->pNext; p->nSetsFetched++; p->nSetsPeak = Abc_MaxInt( p->nSetsPeak, ++p->nSetsUsed ); return pTemp; }
 
 ////////////////////////////////////////////////////////////////////////
 ///                     FUNCTION DEFINITIONS                         ///
@@ -56,6 +56,10 @@ If_Man_t * If_ManStart( If_Par_t * pPars )
     memset( p, 0, sizeof(If_Man_t) );
     p->pPars    = pPars;
     p->fEpsilon = pPars->Epsilon;
+    pPars->nCutsMergedAll = 0;
+    pPars->timeMapAll = 0;
+    if ( pPars->vCutCosts )
+        Vec_IntClear( pPars->vCutCosts );
     // allocate arrays for nodes
     p->vCis     = Vec_PtrAlloc( 100 );
     p->vCos     = Vec_PtrAlloc( 100 );
@@ -71,6 +75,10 @@ If_Man_t * If_ManStart( If_Par_t * pPars )
             p->vTtMem[v] = Vec_MemAllocForTT( v, pPars->fUseTtPerm );
         for ( v = 0; v < 6; v++ )
             p->vTtMem[v] = p->vTtMem[6];
+        for ( v = 6; v <= Abc_MaxInt(6,p->pPars->nLutSize); v++ )
+            p->pTtStores[v] = If_TtStoreStart( p->vTtMem[v] );
+        for ( v = 0; v < 6; v++ )
+            p->pTtStores[v] = p->pTtStores[6];
         if ( p->pPars->fDelayOpt || pPars->nGateSize > 0 )
         {
             for ( v = 6; v <= Abc_MaxInt(6,p->pPars->nLutSize); v++ )
@@ -89,8 +97,10 @@ If_Man_t * If_ManStart( If_Par_t * pPars )
     p->nPermWords  = p->pPars->fUsePerm? If_CutPermWords( p->pPars->nLutSize ) : 0;
     p->nObjBytes   = sizeof(If_Obj_t) + sizeof(int) * (p->pPars->nLutSize + p->nPermWords);
     p->nCutBytes   = sizeof(If_Cut_t) + sizeof(int) * (p->pPars->nLutSize + p->nPermWords);
-    p->nSetBytes   = sizeof(If_Set_t) + (sizeof(If_Cut_t *) + p->nCutBytes) * (p->pPars->nCutsMax + 1);
+    p->nCutsMax    = p->pPars->nCutsMax;
+    p->nSetBytes   = sizeof(If_Set_t) + (sizeof(If_Cut_t *) + p->nCutBytes) * (p->nCutsMax + 1);
     p->pMemObj     = Mem_FixedStart( p->nObjBytes );
+    p->nCutsLimit  = p->nCutsMax;
     // report expected memory usage
     if ( p->pPars->fVerbose )
         Abc_Print( 1, "K = %d. Memory (bytes): Truth = %4d. Cut = %4d. Obj = %4d. Set = %4d. CutMin = %s\n", 
@@ -213,6 +223,7 @@ void If_ManStop( If_Man_t * p )
 {
     extern void If_ManCacheAnalize( If_Man_t * p );
     int i;
+    If_CutDbStop( p );
     if ( p->pPars->fVerbose && p->vCutData )
         If_ManCacheAnalize( p );
     if ( p->pPars->fVerbose && p->pPars->fTruth )
@@ -224,6 +235,9 @@ void If_ManStop( If_Man_t * p )
             nMemTotal += (int)Vec_MemMemory(p->vTtMem[i]);
         printf( "Unique truth tables = %d   Memory = %.2f MB   ", nUnique, 1.0 * nMemTotal / (1<<20) ); 
         Abc_PrintTime( 1, "Time", p->timeCache[4] );
+        for ( i = 6; i <= Abc_MaxInt(6,p->pPars->nLutSize); i++ )
+            If_TtStorePrintStats( p->pTtStores[i], i );
+        Abc_TtCachePrintStats();
         if ( p->nCacheMisses )
         {
             printf( "Cache hits = %d. Cache misses = %d  (%.2f %%)\n", p->nCacheHits, p->nCacheMisses, 100.0 * p->nCacheMisses / (p->nCacheHits + p->nCacheMisses) ); 
@@ -275,6 +289,8 @@ void If_ManStop( If_Man_t * p )
     Vec_PtrFreeP( &p->vVisited );
     if ( p->vPairHash )
         Hash_IntManStop( p->vPairHash );
+    for ( i = 6; i <= Abc_MaxInt(6,p->pPars->nLutSize); i++ )
+        If_TtStoreStop( p->pTtStores[i] );
     for ( i = 6; i <= Abc_MaxInt(6,p->pPars->nLutSize); i++ )
         Vec_MemHashFree( p->vTtMem[i] );
     for ( i = 6; i <= Abc_MaxInt(6,p->pPars->nLutSize); i++ )
@@ -489,7 +505,7 @@ void If_ManSetupSet( If_Man_t * p, If_Set_t * pSet )
     char * pArray;
     int i;
     pSet->nCuts = 0;
-    pSet->nCutsMax = p->pPars->nCutsMax;
+    pSet->nCutsMax = p->nCutsMax;
     pSet->ppCuts = (If_Cut_t **)(pSet + 1);
     pArray = (char *)pSet->ppCuts + sizeof(If_Cut_t *) * (pSet->nCutsMax+1);
     for ( i = 0; i <= pSet->nCutsMax; i++ )
@@ -575,7 +591,7 @@ void If_ManSetupCiCutSets( If_Man_t * p )
     {
         pObj->pCutSet = (If_Set_t *)((char *)p->pMemCi + i * (sizeof(If_Set_t) + sizeof(void *)));
         pObj->pCutSet->nCuts = 1;
-        pObj->pCutSet->nCutsMax = p->pPars->nCutsMax;
+        pObj->pCutSet->nCutsMax = p->nCutsMax;
         pObj->pCutSet->ppCuts = (If_Cut_t **)(pObj->pCutSet + 1);
         pObj->pCutSet->ppCuts[0] = &pObj->CutBest;
     }
@@ -600,7 +616,7 @@ If_Set_t * If_ManSetupNodeCutSet( If_Man_t * p, If_Obj_t * pObj )
 //    If_ManSetupSet( p, pObj->pCutSet );
     pObj->pCutSet = If_ManCutSetFetch( p );
     pObj->pCutSet->nCuts = 0;
-    pObj->pCutSet->nCutsMax = p->pPars->nCutsMax;
+    pObj->pCutSet->nCutsMax = p->nCutsLimit;
     return pObj->pCutSet;
 }
 
@@ -694,6 +710,7 @@ void If_ManSetupSetAll( If_Man_t * p, int nCrossCut )
     int i, nCutSets;
     nCutSets = 128 + nCrossCut;
     p->pFreeList = p->pMemAnd = pCutSet = (If_Set_t *)ABC_ALLOC( char, nCutSets * p->nSetBytes );
+    p->nSetsAlloc = nCutSets;
     for ( i = 0; i < nCutSets; i++ )
     {
         If_ManSetupSet( p, pCutSet );
@@ -716,6 +733,122 @@ void If_ManSetupSetAll( If_Man_t * p, int nCrossCut )
 
 }
 
+/**Function*************************************************************
+
+  Synopsis    [Returns the memory used by the mapper in bytes.]
+
+  Description [Counts the objects, the cutsets and the truth tables.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+double If_ManMemoryUsage( If_Man_t * p )
+{
+    double Memory = 1.0 * Mem_FixedReadMemUsage( p->pMemObj );
+    int i;
+    Memory += 1.0 * If_ManCiNum(p) * (sizeof(If_Set_t) + sizeof(void *));
+    Memory += 1.0 * p->nSetsAlloc * p->nSetBytes;
+    if ( p->pPars->fTruth )
+        for ( i = 6; i <= Abc_MaxInt(6,p->pPars->nLutSize); i++ )
+            Memory += If_TtStoreMemory( p->pTtStores[i] );
+    return Memory;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Fits the cutsets into the memory limit.]
+
+  Description [Reduces the number of cuts per node until the cutsets 
+  of the cross cut fit into the memory left after the objects. Returns 
+  0 if they do not fit even with two cuts per node.]
+               
+  SideEffects [Changes the number of cuts and the size of the cutset 
+  of the manager; the parameters of the caller are not changed.]
+
+  SeeAlso     []
+
+***********************************************************************/
+int If_ManMemoryFitCuts( If_Man_t * p, int nCrossCut )
+{
+    double Limit = 1.0 * p->pPars->nMemLimit * (1<<20);
+    double Fixed = If_ManMemoryUsage( p );
+    int nCutsMax = p->nCutsMax;
+    assert( p->nSetsAlloc == 0 );
+    if ( p->pPars->nMemLimit == 0 )
+        return 1;
+    while ( Fixed + 1.0 * (128 + nCrossCut) * p->nSetBytes > Limit )
+    {
+        if ( p->nCutsMax == 2 )
+        {
+            Abc_Print( 1, "The mapper needs %.2f MB for %d objects and at least %.2f MB for %d cutsets, which exceeds the memory limit (%d MB).\n",
+                Fixed / (1<<20), If_ManObjNum(p), 1.0 * (128 + nCrossCut) * p->nSetBytes / (1<<20), 128 + nCrossCut, p->pPars->nMemLimit );
+            return 0;
+        }
+        p->nCutsMax--;
+        p->nSetBytes = sizeof(If_Set_t) + (sizeof(If_Cut_t *) + p->nCutBytes) * (p->nCutsMax + 1);
+    }
+    p->nCutsLimit = p->nCutsMax;
+    if ( p->nCutsMax < nCutsMax )
+        Abc_Print( 0, "Reduced the number of cuts per node from %d to %d to meet the memory limit (%d MB).\n",
+            nCutsMax, p->nCutsMax, p->pPars->nMemLimit );
+    return 1;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Reduces the cuts used if the memory limit is exceeded.]
+
+  Description [Called during and between the mapping rounds. The cutsets 
+  are allocated once, so only the truth tables keep growing, and they 
+  cannot be freed. Fewer cuts per node slow down their growth. The cuts 
+  are reduced again only if the memory keeps growing after that.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_ManMemoryCheck( If_Man_t * p )
+{
+    double Limit = 1.0 * p->pPars->nMemLimit * (1<<20);
+    double Memory;
+    if ( p->pPars->nMemLimit == 0 || p->nCutsLimit == 2 )
+        return;
+    Memory = If_ManMemoryUsage( p );
+    if ( Memory <= Limit || Memory <= p->MemReduced + Limit / 16 )
+        return;
+    p->MemReduced = Memory;
+    p->nCutsLimit = Abc_MaxInt( 2, p->nCutsLimit / 2 );
+    Abc_Print( 0, "The mapper uses %.2f MB, exceeding the memory limit (%d MB). Reduced the number of cuts per node to %d.\n",
+        Memory / (1<<20), p->pPars->nMemLimit, p->nCutsLimit );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Reports the memory usage of the mapper.]
+
+  Description [The free list is a stack, so a cutset never used before 
+  is fetched only when all the recycled ones are in use. Thus the peak 
+  number of cutsets in use is the number of fresh fetches, and the other 
+  fetches are served by recycled cutsets.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_ManMemoryPrintStats( If_Man_t * p )
+{
+    Abc_Print( 1, "Cutsets: Alloc = %d  Peak = %d (%.2f MB)  Fetched = %.0f  Recycled = %.0f (%.2f %%)  Memory = %.2f MB",
+        p->nSetsAlloc, p->nSetsPeak, 1.0 * p->nSetsPeak * p->nSetBytes / (1<<20), (double)p->nSetsFetched, (double)(p->nSetsFetched - p->nSetsPeak),
+        p->nSetsFetched ? 100.0 * (p->nSetsFetched - p->nSetsPeak) / p->nSetsFetched : 0.0, If_ManMemoryUsage(p) / (1<<20) );
+    if ( p->pPars->nMemLimit )
+        Abc_Print( 1, "  Limit = %d MB", p->pPars->nMemLimit );
+    Abc_Print( 1, "\n" );
+}
+
 ////////////////////////////////////////////////////////////////////////
 ///                       END OF FILE                                ///
 ////////////////////////////////////////////////////////////////////////
@@ -150,28 +150,20 @@ int * If_CutArrTimeProfile( If_Man_t * p, If_Cut_t * pCut )
 
 /**Function*************************************************************
 
-  Synopsis    [Finds the best cut for the given node.]
+  Synopsis    [Prepares the node for cut enumeration.]
 
-  Description [Mapping modes: delay (0), area flow (1), area (2).]
+  Description [Updates the fanout estimate, dereferences the best cut
+  in the area recovery modes and fetches the cutset of the node.]
                
   SideEffects []
 
   SeeAlso     []
 
 ***********************************************************************/
-void If_ObjPerformMappingAnd( If_Man_t * p, If_Obj_t * pObj, int Mode, int fPreprocess, int fFirst )
+If_Set_t * If_ObjPerformMappingAndStart( If_Man_t * p, If_Obj_t * pObj, int Mode )
 {
-    If_Set_t * pCutSet;
-    If_Cut_t * pCut0, * pCut1, * pCut;
-    If_Cut_t * pCut0R, * pCut1R;
-    int fFunc0R, fFunc1R;
-    int i, k, v, iCutDsd, fChange;
-    int fSave0 = p->pPars->fDelayOpt || p->pPars->fDelayOptLut || p->pPars->fDsdBalance || p->pPars->fUserRecLib || p->pPars->fUserSesLib || 
-        p->pPars->fUseDsdTune || p->pPars->fUseCofVars || p->pPars->fUseAndVars || p->pPars->fUse34Spec || p->pPars->pLutStruct || p->pPars->pFuncCell2;
-    int fUseAndCut = (p->pPars->nAndDelay > 0) || (p->pPars->nAndArea > 0);
     assert( !If_ObjIsAnd(pObj->pFanin0) || pObj->pFanin0->pCutSet->nCuts > 0 );
     assert( !If_ObjIsAnd(pObj->pFanin1) || pObj->pFanin1->pCutSet->nCuts > 0 );
-
     // prepare
     if ( Mode == 0 )
         pObj->EstRefs = (float)pObj->nRefs;
@@ -180,9 +172,64 @@ void If_ObjPerformMappingAnd( If_Man_t * p, If_Obj_t * pObj, int Mode, int fPrep
     // deref the selected cut
     if ( Mode && pObj->nRefs > 0 )
         If_CutAreaDeref( p, If_ObjCutBest(pObj) );
-
     // prepare the cutset
-    pCutSet = If_ManSetupNodeCutSet( p, pObj );
+    return If_ManSetupNodeCutSet( p, pObj );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Selects the best cut after the cuts are enumerated.]
+
+  Description []
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static void If_ObjPerformMappingAndBest( If_Man_t * p, If_Obj_t * pObj, If_Set_t * pCutSet, int fPreprocess )
+{
+    // update the best cut
+    if ( !fPreprocess || pCutSet->ppCuts[0]->Delay <= pObj->Required + p->fEpsilon )
+    {
+        If_CutCopy( p, If_ObjCutBest(pObj), pCutSet->ppCuts[0] );
+        if ( p->pPars->fUserRecLib || p->pPars->fUserSesLib )
+            assert(If_ObjCutBest(pObj)->Cost < IF_COST_MAX && If_ObjCutBest(pObj)->Delay < ABC_INFINITY);
+    }
+    // add the trivial cut to the set
+    if ( !pObj->fSkipCut && If_ObjCutBest(pObj)->nLeaves > 1 )
+    {
+        If_ManSetupCutTriv( p, pCutSet->ppCuts[pCutSet->nCuts++], pObj->Id );
+        assert( pCutSet->nCuts <= pCutSet->nCutsMax+1 );
+    }
+//    if ( If_ObjCutBest(pObj)->nLeaves == 0 )
+//        p->nBestCutSmall[0]++;
+//    else if ( If_ObjCutBest(pObj)->nLeaves == 1 )
+//        p->nBestCutSmall[1]++;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Enumerates the cuts of the node and selects the best one.]
+
+  Description [Returns the number of merged cuts. Does not use the cutset 
+  memory manager, so in the delay mode, when truth tables are not computed, 
+  the nodes of one level can be processed concurrently.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+int If_ObjPerformMappingAndCuts( If_Man_t * p, If_Obj_t * pObj, If_Set_t * pCutSet, int Mode, int fPreprocess, int fFirst )
+{
+    If_Cut_t * pCut0, * pCut1, * pCut;
+    If_Cut_t * pCut0R, * pCut1R;
+    int fFunc0R, fFunc1R;
+    int i, k, v, iCutDsd, fChange, nCutsMerged = 0;
+    int fSave0 = p->pPars->fDelayOpt || p->pPars->fDelayOptLut || p->pPars->fDsdBalance || p->pPars->fUserRecLib || p->pPars->fUserSesLib || 
+        p->pPars->fUseDsdTune || p->pPars->fUseCofVars || p->pPars->fUseAndVars || p->pPars->fUse34Spec || p->pPars->pLutStruct || p->pPars->pFuncCell2;
+    int fUseAndCut = (p->pPars->nAndDelay > 0) || (p->pPars->nAndArea > 0);
 
     // get the current assigned best cut
     pCut = If_ObjCutBest(pObj);
@@ -228,6 +275,12 @@ void If_ObjPerformMappingAnd( If_Man_t * p, If_Obj_t * pObj, int Mode, int fPrep
         if ( !fPreprocess )
             If_CutCopy( p, pCutSet->ppCuts[pCutSet->nCuts++], pCut );
     }
+    else if ( p->pCutDb && Mode == 0 && If_CutDbLoadCuts( p, pObj, pCutSet ) )
+    {
+        // the TFI is unchanged since the cuts were saved
+        If_ObjPerformMappingAndBest( p, pObj, pCutSet, fPreprocess );
+        return 0;
+    }
 
     // generate cuts
     If_ObjForEachCut( pObj->pFanin0, pCut0, i )
@@ -266,8 +319,7 @@ void If_ObjPerformMappingAnd( If_Man_t * p, If_Obj_t * pObj, int Mode, int fPrep
         }
         if ( pObj->fSpec && pCut->nLeaves == (unsigned)p->pPars->nLutSize )
             continue;
-        p->nCutsMerged++;
-        p->nCutsTotal++;
+        nCutsMerged++;
         // check if this cut is contained in any of the available cuts
         if ( !p->pPars->fSkipCutFilter && If_CutFilter( pCutSet, pCut, fSave0 ) )
             continue;
@@ -460,28 +512,35 @@ void If_ObjPerformMappingAnd( If_Man_t * p, If_Obj_t * pObj, int Mode, int fPrep
     } 
     assert( pCutSet->nCuts > 0 );
 //    If_CutVerifyCuts( pCutSet, !p->pPars->fUseTtPerm );
+    If_ObjPerformMappingAndBest( p, pObj, pCutSet, fPreprocess );
+    // the nodes mapped concurrently are different, so are their entries
+    if ( p->pPars->vCutCosts )
+        Vec_IntAddToEntry( p->pPars->vCutCosts, pObj->Id, nCutsMerged );
+    return nCutsMerged;
+}
 
-    // update the best cut
-    if ( !fPreprocess || pCutSet->ppCuts[0]->Delay <= pObj->Required + p->fEpsilon )
-    {
-        If_CutCopy( p, If_ObjCutBest(pObj), pCutSet->ppCuts[0] );
-        if ( p->pPars->fUserRecLib || p->pPars->fUserSesLib )
-            assert(If_ObjCutBest(pObj)->Cost < IF_COST_MAX && If_ObjCutBest(pObj)->Delay < ABC_INFINITY);
-    }
-    // add the trivial cut to the set
-    if ( !pObj->fSkipCut && If_ObjCutBest(pObj)->nLeaves > 1 )
-    {
-        If_ManSetupCutTriv( p, pCutSet->ppCuts[pCutSet->nCuts++], pObj->Id );
-        assert( pCutSet->nCuts <= pCutSet->nCutsMax+1 );
-    }
-//    if ( If_ObjCutBest(pObj)->nLeaves == 0 )
-//        p->nBestCutSmall[0]++;
-//    else if ( If_ObjCutBest(pObj)->nLeaves == 1 )
-//        p->nBestCutSmall[1]++;
+/**Function*************************************************************
 
+  Synopsis    [Finishes the node after cut enumeration.]
+
+  Description [References the best cut in the area recovery modes, 
+  calls the user function and recycles the cutsets no longer needed.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_ObjPerformMappingAndStop( If_Man_t * p, If_Obj_t * pObj, int Mode )
+{
+    If_Cut_t * pCut;
+    int i;
     // ref the selected cut
     if ( Mode && pObj->nRefs > 0 )
         If_CutAreaRef( p, If_ObjCutBest(pObj) );
+    // save the cuts of the first round
+    if ( p->pCutDb )
+        If_CutDbSaveCuts( p, pObj );
     if ( If_ObjCutBest(pObj)->fUseless )
         Abc_Print( 1, "The best cut is useless.\n" );
     // call the user specified function for each cut
@@ -492,6 +551,28 @@ void If_ObjPerformMappingAnd( If_Man_t * p, If_Obj_t * pObj, int Mode, int fPrep
     If_ManDerefNodeCutSet( p, pObj );
 }
 
+/**Function*************************************************************
+
+  Synopsis    [Finds the best cut for the given node.]
+
+  Description [Mapping modes: delay (0), area flow (1), area (2).]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_ObjPerformMappingAnd( If_Man_t * p, If_Obj_t * pObj, int Mode, int fPreprocess, int fFirst )
+{
+    If_Set_t * pCutSet;
+    int nCutsMerged;
+    pCutSet = If_ObjPerformMappingAndStart( p, pObj, Mode );
+    nCutsMerged = If_ObjPerformMappingAndCuts( p, pObj, pCutSet, Mode, fPreprocess, fFirst );
+    p->nCutsMerged += nCutsMerged;
+    p->nCutsTotal  += nCutsMerged;
+    If_ObjPerformMappingAndStop( p, pObj, Mode );
+}
+
 /**Function*************************************************************
 
   Synopsis    [Finds the best cut for the choice node.]
@@ -606,6 +687,8 @@ int If_ManPerformMappingRound( If_Man_t * p, int nCutsUsed, int Mode, int fPrepr
     // set the cut number
     p->nCutsUsed   = nCutsUsed;
     p->nCutsMerged = 0;
+    if ( p->pPars->vCutCosts )
+        Vec_IntFillExtra( p->pPars->vCutCosts, If_ManObjNum(p), 0 );
     // make sure the visit counters are all zero
     If_ManForEachNode( p, pObj, i )
         assert( pObj->nVisits == pObj->nVisitsCopy );
@@ -642,12 +725,18 @@ int If_ManPerformMappingRound( If_Man_t * p, int nCutsUsed, int Mode, int fPrepr
         }
 //        Tim_ManPrint( p->pManTim );
     }
+    else if ( If_ManPerformMappingRoundPar( p, Mode, fPreprocess, fFirst ) )
+    {
+        // the nodes were mapped level by level using several threads
+    }
     else
     {
         pProgress = Extra_ProgressBarStart( stdout, If_ManObjNum(p) );
         If_ManForEachNode( p, pObj, i )
         {
             Extra_ProgressBarUpdate( pProgress, i, pLabel );
+            if ( p->pPars->nMemLimit && (i & 0xFFF) == 0 )
+                If_ManMemoryCheck( p );
             If_ObjPerformMappingAnd( p, pObj, Mode, fPreprocess, fFirst );
             if ( pObj->fRepr )
                 If_ObjPerformMappingChoice( p, pObj, Mode, fPreprocess );
@@ -672,6 +761,11 @@ int If_ManPerformMappingRound( If_Man_t * p, int nCutsUsed, int Mode, int fPrepr
 //    Abc_Print( 1, "Max number of cuts = %d. Average number of cuts = %5.2f.\n", 
 //        p->nCutsMax, 1.0 * p->nCutsMerged / If_ManAndNum(p) );
     }
+    // use fewer cuts in the next rounds if the memory limit is exceeded
+    If_ManMemoryCheck( p );
+    // report the cost of cut enumeration to the caller
+    p->pPars->nCutsMergedAll += p->nCutsMerged;
+    p->pPars->timeMapAll += Abc_Clock() - clk;
     return 1;
 }
 
@@ -0,0 +1,420 @@
+/**CFile****************************************************************
+
+  FileName    [ifPar.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [FPGA mapping based on priority cuts.]
+
+  Synopsis    [Level-synchronous parallel cut enumeration.]
+
+  Author      [ymc]
+
+  Affiliation []
+
+  Date        [Ver. 1.0. Started - October 17, 2026.]
+
+  Revision    [$Id: ifPar.c,v 1.00 2026/10/17 00:00:00 ymc Exp $]
+
+***********************************************************************/
+
+#include "if.h"
+
+#ifdef ABC_USE_PTHREADS
+
+#ifdef _WIN32
+#include "../lib/pthread.h"
+#else
+#include <pthread.h>
+#endif
+
+#endif
+
+ABC_NAMESPACE_IMPL_START
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+// The fanins of a node are on lower levels, so the nodes of one level
+// can enumerate their cuts concurrently. Fetching and recycling cutsets
+// (the shared memory manager and the visit counters) is done serially
+// before and after each level, in the same order as the serial round.
+// Only the delay rounds are parallel: area recovery references and
+// dereferences the cones of the best cuts, which depends on the order.
+// Truth tables are hashed in the concurrent store (ifTtStore.c); each
+// worker gets a copy of the manager with its own truth table scratch.
+
+#define IF_PAR_THR_MAX 64
+
+typedef struct If_ParMan_t_ If_ParMan_t;
+typedef struct If_ParThr_t_ If_ParThr_t;
+
+struct If_ParThr_t_
+{
+    If_ParMan_t *      pMan;          // the parallel manager
+    If_Man_t *         pIfMan;        // the manager used by this thread
+    int                iThread;       // the thread number
+    int                fStarted;      // the thread is running (otherwise its share is mapped by thread 0)
+    int                nCutsMerged;   // the number of merged cuts
+};
+
+struct If_ParMan_t_
+{
+    If_Man_t *         p;             // the mapping manager
+    int                Mode;          // the mapping mode
+    int                fPreprocess;   // preprocessing round
+    int                fFirst;        // first round
+    int                nThreads;      // the number of threads
+    If_Obj_t **        ppNodes;       // the nodes of the current level
+    int                nNodes;        // the number of nodes of the current level
+    If_ParThr_t        Thr[IF_PAR_THR_MAX];
+#ifdef ABC_USE_PTHREADS
+    int                iLevelCur;     // the current level (incremented to start the workers)
+    int                nThrStarted;   // the workers that are running
+    int                nThrDone;      // the workers that finished the current level
+    int                fStop;         // the workers should exit
+    pthread_mutex_t    Mutex;
+    pthread_cond_t     CondStart;
+    pthread_cond_t     CondDone;
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+/**Function*************************************************************
+
+  Synopsis    [Returns 1 if the round can be mapped in parallel.]
+
+  Description [The users of truth tables other than the store (DSDs,
+  cached decompositions, ISOPs, LUT structures), the user callbacks,
+  choices and boxes use shared state of the manager. The cutsets are
+  allocated for the parallel round only by If_ManPerformMapping().]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static int If_ManParIsSupported( If_Man_t * p, int Mode )
+{
+    If_Par_t * pPars = p->pPars;
+#ifndef ABC_USE_PTHREADS
+    return 0;
+#endif
+    if ( pPars->nThreads < 2 || Mode != 0 )
+        return 0;
+    if ( p->pManTim != NULL || p->nChoices > 0 || pPars->bIsPif || pPars->fLiftLeaves )
+        return 0;
+    if ( pPars->fUseTtPerm || pPars->pFuncCost || pPars->pFuncUser || pPars->pFuncCell || pPars->pFuncCell2 || pPars->pLutStruct )
+        return 0;
+    if ( pPars->fUseDsd || pPars->fUseDsdTune || pPars->fUseAndVars || pPars->fUseCofVars || pPars->fUse34Spec || pPars->fLut6Filter )
+        return 0;
+    if ( pPars->fDelayOpt || pPars->fDsdBalance || pPars->fUserRecLib || pPars->fUserSesLib || pPars->fDelayOptLut || pPars->nGateSize > 0 )
+        return 0;
+    return 1;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Computes the max number of cutsets used by the parallel round.]
+
+  Description [The cutsets of all nodes of a level are fetched before
+  the level is mapped, and the cutset of a node is recycled after the
+  level of its last fanout, so the cross cut differs from the one of the
+  topological order (If_ManCrossCut).]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+int If_ManCrossCutLevel( If_Man_t * p )
+{
+    If_Obj_t * pObj, * pFanin;
+    int * pLastUse, * pDiff;
+    int i, k, nLevels = 0, nCutSize = 0, nCutSizeMax = 0;
+    If_ManForEachNode( p, pObj, i )
+        nLevels = Abc_MaxInt( nLevels, (int)pObj->Level );
+    pLastUse = ABC_ALLOC( int, If_ManObjNum(p) );
+    pDiff    = ABC_CALLOC( int, nLevels + 2 );
+    If_ManForEachNode( p, pObj, i )
+        pLastUse[pObj->Id] = (int)pObj->Level;
+    If_ManForEachNode( p, pObj, i )
+    {
+        pFanin = If_ObjFanin0(pObj);
+        if ( If_ObjIsAnd(pFanin) )
+            pLastUse[pFanin->Id] = Abc_MaxInt( pLastUse[pFanin->Id], (int)pObj->Level );
+        pFanin = If_ObjFanin1(pObj);
+        if ( If_ObjIsAnd(pFanin) )
+            pLastUse[pFanin->Id] = Abc_MaxInt( pLastUse[pFanin->Id], (int)pObj->Level );
+    }
+    // the cutset of a node is alive from its level to the level of the last fanout
+    If_ManForEachNode( p, pObj, i )
+    {
+        pDiff[pObj->Level]++;
+        pDiff[pLastUse[pObj->Id] + 1]--;
+    }
+    for ( k = 0; k <= nLevels; k++ )
+    {
+        nCutSize += pDiff[k];
+        nCutSizeMax = Abc_MaxInt( nCutSizeMax, nCutSize );
+    }
+    ABC_FREE( pLastUse );
+    ABC_FREE( pDiff );
+    return nCutSizeMax;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Enumerates the cuts of the share of the level.]
+
+  Description [Thread i takes the nodes i, i + nThreads, etc.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static void If_ManParMapShare( If_ParThr_t * pThr )
+{
+    If_ParMan_t * pMan = pThr->pMan;
+    If_Obj_t * pObj;
+    int i;
+    for ( i = pThr->iThread; i < pMan->nNodes; i += pMan->nThreads )
+    {
+        pObj = pMan->ppNodes[i];
+        pThr->nCutsMerged += If_ObjPerformMappingAndCuts( pThr->pIfMan, pObj, pObj->pCutSet, pMan->Mode, pMan->fPreprocess, pMan->fFirst );
+    }
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Duplicates the manager for a worker thread.]
+
+  Description [The copy shares everything with the original except the
+  truth table scratch and the statistics.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static If_Man_t * If_ManParDup( If_Man_t * p )
+{
+    If_Man_t * pNew = ABC_ALLOC( If_Man_t, 1 );
+    memcpy( pNew, p, sizeof(If_Man_t) );
+    pNew->timeCache[4] = 0;
+    if ( p->pPars->fTruth )
+    {
+        pNew->puTemp[0] = ABC_ALLOC( unsigned, 8 * p->nTruth6Words[p->pPars->nLutSize] );
+        pNew->puTemp[1] = pNew->puTemp[0] + p->nTruth6Words[p->pPars->nLutSize]*2;
+        pNew->puTemp[2] = pNew->puTemp[1] + p->nTruth6Words[p->pPars->nLutSize]*2;
+        pNew->puTemp[3] = pNew->puTemp[2] + p->nTruth6Words[p->pPars->nLutSize]*2;
+        pNew->puTempW   = ABC_ALLOC( word, p->nTruth6Words[p->pPars->nLutSize] );
+    }
+    return pNew;
+}
+static void If_ManParDupFree( If_Man_t * p, If_Man_t * pNew )
+{
+    p->timeCache[4] += pNew->timeCache[4];
+    if ( p->pPars->fTruth )
+    {
+        ABC_FREE( pNew->puTemp[0] );
+        ABC_FREE( pNew->puTempW );
+    }
+    ABC_FREE( pNew );
+}
+
+#ifdef ABC_USE_PTHREADS
+
+/**Function*************************************************************
+
+  Synopsis    [Worker thread.]
+
+  Description [Waits for the next level, maps its share, reports back.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static void * If_ManParWorkerThread( void * pArg )
+{
+    If_ParThr_t * pThr = (If_ParThr_t *)pArg;
+    If_ParMan_t * pMan = pThr->pMan;
+    int iLevel = 0;
+    while ( 1 )
+    {
+        pthread_mutex_lock( &pMan->Mutex );
+        while ( pMan->iLevelCur == iLevel && !pMan->fStop )
+            pthread_cond_wait( &pMan->CondStart, &pMan->Mutex );
+        iLevel = pMan->iLevelCur;
+        if ( pMan->fStop )
+        {
+            pthread_mutex_unlock( &pMan->Mutex );
+            return NULL;
+        }
+        pthread_mutex_unlock( &pMan->Mutex );
+        If_ManParMapShare( pThr );
+        pthread_mutex_lock( &pMan->Mutex );
+        if ( ++pMan->nThrDone == pMan->nThrStarted )
+            pthread_cond_signal( &pMan->CondDone );
+        pthread_mutex_unlock( &pMan->Mutex );
+    }
+    assert( 0 );
+    return NULL;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Maps the nodes of one level using all threads.]
+
+  Description []
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static void If_ManParMapLevel( If_ParMan_t * pMan )
+{
+    int i;
+    pthread_mutex_lock( &pMan->Mutex );
+    pMan->nThrDone = 0;
+    pMan->iLevelCur++;
+    pthread_cond_broadcast( &pMan->CondStart );
+    pthread_mutex_unlock( &pMan->Mutex );
+    // the main thread takes share 0 and the shares of the workers that did not start
+    If_ManParMapShare( pMan->Thr );
+    for ( i = 1; i < pMan->nThreads; i++ )
+        if ( !pMan->Thr[i].fStarted )
+            If_ManParMapShare( pMan->Thr + i );
+    pthread_mutex_lock( &pMan->Mutex );
+    while ( pMan->nThrDone < pMan->nThrStarted )
+        pthread_cond_wait( &pMan->CondDone, &pMan->Mutex );
+    pthread_mutex_unlock( &pMan->Mutex );
+}
+
+#endif
+
+/**Function*************************************************************
+
+  Synopsis    [Performs one delay-oriented mapping round in parallel.]
+
+  Description [Returns 0 if the round cannot be parallelized; the caller
+  then maps it serially. The result is the same as that of the serial
+  round. Levels with fewer nodes than threads are mapped serially.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+int If_ManPerformMappingRoundPar( If_Man_t * p, int Mode, int fPreprocess, int fFirst )
+{
+#ifndef ABC_USE_PTHREADS
+    return 0;
+#else
+    If_ParMan_t * pMan;
+    pthread_t WorkerThread[IF_PAR_THR_MAX];
+    If_Obj_t * pObj, ** ppNodes;
+    int * pLevStarts;
+    int i, k, nLevels, nNodes, nCutsMerged = 0;
+    if ( !If_ManParIsSupported( p, Mode ) )
+        return 0;
+    // sort the nodes by level (counting sort keeps the topological order in a level)
+    nLevels = 0;
+    If_ManForEachNode( p, pObj, i )
+        nLevels = Abc_MaxInt( nLevels, (int)pObj->Level );
+    pLevStarts = ABC_CALLOC( int, nLevels + 2 );
+    If_ManForEachNode( p, pObj, i )
+        pLevStarts[pObj->Level + 1]++;
+    for ( k = 1; k <= nLevels + 1; k++ )
+        pLevStarts[k] += pLevStarts[k-1];
+    nNodes = pLevStarts[nLevels + 1];
+    ppNodes = ABC_ALLOC( If_Obj_t *, Abc_MaxInt(nNodes, 1) );
+    If_ManForEachNode( p, pObj, i )
+        ppNodes[pLevStarts[pObj->Level]++] = pObj;
+    // restore the level starts
+    for ( k = nLevels + 1; k > 0; k-- )
+        pLevStarts[k] = pLevStarts[k-1];
+    pLevStarts[0] = 0;
+    // start the threads
+    pMan = ABC_CALLOC( If_ParMan_t, 1 );
+    pMan->p           = p;
+    pMan->Mode        = Mode;
+    pMan->fPreprocess = fPreprocess;
+    pMan->fFirst      = fFirst;
+    pMan->nThreads    = Abc_MinInt( p->pPars->nThreads, IF_PAR_THR_MAX );
+    pthread_mutex_init( &pMan->Mutex, NULL );
+    pthread_cond_init( &pMan->CondStart, NULL );
+    pthread_cond_init( &pMan->CondDone, NULL );
+    for ( i = 0; i < pMan->nThreads; i++ )
+    {
+        pMan->Thr[i].pMan = pMan;
+        pMan->Thr[i].pIfMan = i ? If_ManParDup( p ) : p;
+        pMan->Thr[i].iThread = i;
+    }
+    for ( i = 1; i < pMan->nThreads; i++ )
+    {
+        pMan->Thr[i].fStarted = !pthread_create( WorkerThread + i, NULL, If_ManParWorkerThread, (void *)(pMan->Thr + i) );
+        pMan->nThrStarted += pMan->Thr[i].fStarted;
+    }
+    // map the levels
+    for ( k = 0; k <= nLevels; k++ )
+    {
+        int iBeg = pLevStarts[k], iEnd = pLevStarts[k+1];
+        if ( iBeg == iEnd )
+            continue;
+        // the workers are idle between the levels
+        if ( p->pPars->nMemLimit )
+            If_ManMemoryCheck( p );
+        for ( i = iBeg; i < iEnd; i++ )
+            If_ObjPerformMappingAndStart( p, ppNodes[i], Mode );
+        if ( iEnd - iBeg < pMan->nThreads )
+        {
+            for ( i = iBeg; i < iEnd; i++ )
+                nCutsMerged += If_ObjPerformMappingAndCuts( p, ppNodes[i], ppNodes[i]->pCutSet, Mode, fPreprocess, fFirst );
+        }
+        else
+        {
+            pMan->ppNodes = ppNodes + iBeg;
+            pMan->nNodes  = iEnd - iBeg;
+            If_ManParMapLevel( pMan );
+        }
+        for ( i = iBeg; i < iEnd; i++ )
+            If_ObjPerformMappingAndStop( p, ppNodes[i], Mode );
+    }
+    // stop the threads
+    pthread_mutex_lock( &pMan->Mutex );
+    pMan->fStop = 1;
+    pthread_cond_broadcast( &pMan->CondStart );
+    pthread_mutex_unlock( &pMan->Mutex );
+    for ( i = 1; i < pMan->nThreads; i++ )
+        if ( pMan->Thr[i].fStarted )
+            pthread_join( WorkerThread[i], NULL );
+    for ( i = 0; i < pMan->nThreads; i++ )
+        nCutsMerged += pMan->Thr[i].nCutsMerged;
+    for ( i = 1; i < pMan->nThreads; i++ )
+        If_ManParDupFree( p, pMan->Thr[i].pIfMan );
+    p->nCutsMerged += nCutsMerged;
+    p->nCutsTotal  += nCutsMerged;
+    pthread_cond_destroy( &pMan->CondStart );
+    pthread_cond_destroy( &pMan->CondDone );
+    pthread_mutex_destroy( &pMan->Mutex );
+    ABC_FREE( pMan );
+    ABC_FREE( pLevStarts );
+    ABC_FREE( ppNodes );
+    return 1;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
+
+
+ABC_NAMESPACE_IMPL_END
@@ -0,0 +1,235 @@
+/**CFile****************************************************************
+
+  FileName    [ifPif.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [FPGA mapping based on priority cuts.]
+
+  Synopsis    [Timing board shared by the parts mapped by pif.]
+
+  Author      [ymc]
+  
+  Affiliation []
+
+  Date        [Ver. 1.0. Started - October 17, 2026.]
+
+  Revision    [$Id: ifPif.c,v 1.00 2026/10/17 00:00:00 ymc Exp $]
+
+***********************************************************************/
+
+#include "if.h"
+
+ABC_NAMESPACE_IMPL_START
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+// The parts of a pif run exchange timing through the board in rounds.
+// While a round is mapped, the parts read only what was committed at the
+// end of the previous round, and write only their own slots (or the global
+// required time, with an atomic max), so the result of a round does not
+// depend on the order in which the parts are mapped.
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+/**Function*************************************************************
+
+  Synopsis    [Starts the board.]
+
+  Description [Boundary signals are the cut-caused POs (nArrSlots). Their
+  consumers are the cut-caused PIs (nReqSlots); pReq2Arr gives the signal
+  read by each consumer.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+If_PifBoard_t * If_PifBoardStart( int nParts, int nArrSlots, int nReqSlots, int * pReq2Arr )
+{
+    If_PifBoard_t * p;
+    int i;
+    p = ABC_CALLOC( If_PifBoard_t, 1 );
+    p->nParts    = nParts;
+    p->pPartDelays = ABC_CALLOC( float, Abc_MaxInt(nParts, 1) );
+    p->nArrSlots = nArrSlots;
+    p->nReqSlots = nReqSlots;
+    p->pReq2Arr  = ABC_ALLOC( int, Abc_MaxInt(nReqSlots, 1) );
+    p->pArrs     = ABC_CALLOC( float, Abc_MaxInt(nArrSlots, 1) );
+    p->pArrsNext = ABC_CALLOC( float, Abc_MaxInt(nArrSlots, 1) );
+    p->pReqs     = ABC_ALLOC( float, Abc_MaxInt(nArrSlots, 1) );
+    p->pReqsNext = ABC_ALLOC( float, Abc_MaxInt(nReqSlots, 1) );
+    for ( i = 0; i < nReqSlots; i++ )
+    {
+        assert( pReq2Arr[i] >= 0 && pReq2Arr[i] < nArrSlots );
+        p->pReq2Arr[i]  = pReq2Arr[i];
+        p->pReqsNext[i] = IF_FLOAT_LARGE;
+    }
+    for ( i = 0; i < nArrSlots; i++ )
+        p->pReqs[i] = IF_FLOAT_LARGE;
+    return p;
+}
+void If_PifBoardStop( If_PifBoard_t * p )
+{
+    ABC_FREE( p->pPartDelays );
+    ABC_FREE( p->pReq2Arr );
+    ABC_FREE( p->pArrs );
+    ABC_FREE( p->pArrsNext );
+    ABC_FREE( p->pReqs );
+    ABC_FREE( p->pReqsNext );
+    ABC_FREE( p );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Makes the values published in this round visible.]
+
+  Description [Called between the rounds, when no part is being mapped.
+  The required time of a boundary signal is the tightest over its consumers.
+  The parts not mapped in this round keep their delay.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_PifBoardCommit( If_PifBoard_t * p )
+{
+    int i;
+    for ( i = 0; i < p->nParts; i++ )
+        If_PifBoardUpdateMaxReq( p, (int)p->pPartDelays[i] );
+    p->MaxReqTime = p->MaxReqTimeNext;
+    p->MaxReqTimeNext = 0;
+    memcpy( p->pArrs, p->pArrsNext, sizeof(float) * p->nArrSlots );
+    for ( i = 0; i < p->nArrSlots; i++ )
+        p->pReqs[i] = IF_FLOAT_LARGE;
+    for ( i = 0; i < p->nReqSlots; i++ )
+    {
+        p->pReqs[p->pReq2Arr[i]] = Abc_MinFloat( p->pReqs[p->pReq2Arr[i]], p->pReqsNext[i] );
+        p->pReqsNext[i] = IF_FLOAT_LARGE;
+    }
+    p->nRounds++;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Lock-free max-reduction of the global required time.]
+
+  Description []
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_PifBoardUpdateMaxReq( If_PifBoard_t * p, int ReqTime )
+{
+#if defined(__GNUC__) || defined(__clang__)
+    int Old = __atomic_load_n( &p->MaxReqTimeNext, __ATOMIC_RELAXED );
+    while ( Old < ReqTime && !__atomic_compare_exchange_n( &p->MaxReqTimeNext, &Old, ReqTime, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) );
+#else
+    if ( p->MaxReqTimeNext < ReqTime )
+        p->MaxReqTimeNext = ReqTime;
+#endif
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Reads the arrival times of the cut-caused PIs.]
+
+  Description [pCiSlots gives the consumer slot of each CI, or -1.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_PifBoardReadArrivals( If_PifBoard_t * p, int * pCiSlots, int nCis, float * pTimesArr )
+{
+    int i;
+    for ( i = 0; i < nCis; i++ )
+        if ( pCiSlots[i] >= 0 )
+            pTimesArr[i] = p->pArrs[p->pReq2Arr[pCiSlots[i]]];
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Required time of a cut-caused PO.]
+
+  Description [The committed requirement of the consumers, if any, but not 
+  later than the local required time nor earlier than the arrival time.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+float If_PifBoardCoRequired( If_PifBoard_t * p, int iSlot, float RequiredGlo, float ArrTime )
+{
+    float Required = RequiredGlo;
+    if ( iSlot >= 0 && p->pReqs[iSlot] < IF_FLOAT_LARGE )
+        Required = Abc_MinFloat( Required, p->pReqs[iSlot] );
+    return Abc_MaxFloat( Required, ArrTime );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Publishes the timing of the boundary of one part.]
+
+  Description [Delay of the part, arrival times of the cut-caused POs and 
+  required times of the cut-caused PIs. Each slot has a single writer.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_PifBoardPublish( If_Man_t * pIfMan )
+{
+    If_PifBoard_t * p = pIfMan->pPars->pPifBoard;
+    If_Obj_t * pObj;
+    int i;
+    if ( pIfMan->pPars->iThreadId >= 0 && pIfMan->pPars->iThreadId < p->nParts )
+        p->pPartDelays[pIfMan->pPars->iThreadId] = pIfMan->RequiredGlo;
+    if ( pIfMan->pPars->pPifCoSlots )
+        If_ManForEachCo( pIfMan, pObj, i )
+            if ( pIfMan->pPars->pPifCoSlots[i] >= 0 )
+                p->pArrsNext[pIfMan->pPars->pPifCoSlots[i]] = If_ObjArrTime(If_ObjFanin0(pObj));
+    if ( pIfMan->pPars->pPifCiSlots )
+        If_ManForEachCi( pIfMan, pObj, i )
+            if ( pIfMan->pPars->pPifCiSlots[i] >= 0 )
+                p->pReqsNext[pIfMan->pPars->pPifCiSlots[i]] = pObj->Required;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Publishes the timing of a part that is not mapped.]
+
+  Description [Used for a part whose mapping is reused from an earlier run:
+  its delay and the arrival times of its cut-caused POs, as recorded then.
+  Its cut-caused PIs do not constrain the parts driving them.]
+               
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_PifBoardPublishPart( If_PifBoard_t * p, int iPart, float Delay, int * pCoSlots, float * pCoArrs, int nCos )
+{
+    int i;
+    if ( iPart >= 0 && iPart < p->nParts )
+        p->pPartDelays[iPart] = Delay;
+    for ( i = 0; i < nCos; i++ )
+        if ( pCoSlots[i] >= 0 )
+            p->pArrsNext[pCoSlots[i]] = pCoArrs[i];
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
+
+ABC_NAMESPACE_IMPL_END
@@ -350,7 +350,7 @@ int If_ManPerformMappingSeq( If_Man_t * p )
     p->vLatchOrder = If_ManCollectLatches( p );
 
     // set parameters
-    p->nCutsUsed = p->pPars->nCutsMax;
+    p->nCutsUsed = p->nCutsMax;
     p->nAttempts = 0;
     p->nMaxIters = 50;
     p->Period    = (int)p->RequiredGlo;
@@ -159,31 +159,11 @@ float If_CutDelay( If_Man_t * p, If_Obj_t * pObj, If_Cut_t * pCut )
             }
             else
             {
+                //ymc: arrival times of cut-caused PIs are set from the pif timing board
                 If_CutForEachLeaf( p, pCut, pLeaf, i )
                 {
-                    if(p->pPars->bIsPif)
-                    {
-                        if(pLeaf->Type == IF_CI && pLeaf->pFanin0 && If_ObjCutBest(pLeaf)->Delay == 0)
-                        {
-                            Abc_Obj_t* pCutCausedPo = (Abc_Obj_t*) pLeaf->pFanin0;
-                            assert(Abc_ObjIsPo(pCutCausedPo));
-                            assert(pCutCausedPo->fMarkA);
-                            If_Obj_t* pIfObj = (If_Obj_t*) (Abc_ObjFanin0(pCutCausedPo)->pCopy);     
-                            if(pIfObj && If_ObjCutBest(pIfObj)->Delay)
-                            {
-                                //printf("Transfer delay for cut-caused PI: %f->%f\n", If_ObjCutBest(pLeaf)->Delay, If_ObjCutBest(pIfObj)->Delay);
-                                If_ObjCutBest(pLeaf)->Delay = If_ObjCutBest(pIfObj)->Delay;
-                            }
-
-                        }
-                        DelayCur = If_ObjCutBest(pLeaf)->Delay + 1.0;
-                        Delay = IF_MAX( Delay, DelayCur );
-                    }
-                    else
-                    {
-                        DelayCur = If_ObjCutBest(pLeaf)->Delay + 1.0;
-                        Delay = IF_MAX( Delay, DelayCur );
-                    }
+                    DelayCur = If_ObjCutBest(pLeaf)->Delay + 1.0;
+                    Delay = IF_MAX( Delay, DelayCur );
                 }
             }
         }
@@ -352,17 +332,9 @@ void If_ManComputeRequired( If_Man_t * p )
         // get the global required times
         p->RequiredGlo = If_ManDelayMax( p, 0 );
 
-        //ymc
+        //ymc: the global required time of this round; the parts read the one of the previous round
         if(p->pPars->bIsPif)
-        {
-            //printf("thread[%d]: curReqTime: %f;\tgloReqTime: %d\n", p->pPars->iThreadId, p->RequiredGlo, *(p->pPars->piMaxReqTime));
-            if(p->RequiredGlo > *(p->pPars->piMaxReqTime))
-                *(p->pPars->piMaxReqTime) = p->RequiredGlo;
-#if 0 //cancel global relaxation
-            else if(p->RequiredGlo < *(p->pPars->piMaxReqTime)*(p->pPars->factor))
-                p->RequiredGlo = *(p->pPars->piMaxReqTime);
-#endif
-        }
+            If_PifBoardUpdateMaxReq( p->pPars->pPifBoard, (int)p->RequiredGlo );
 
         // consider the case when the required times are given
         if ( p->pPars->pTimesReq && !p->pPars->fAreaOnly )
@@ -443,12 +415,13 @@ void If_ManComputeRequired( If_Man_t * p )
 #if 1
                 if(p->pPars->bIsPif)
                 {
+                    float MaxReqTime = Abc_MaxFloat( p->RequiredGlo, (float)p->pPars->pPifBoard->MaxReqTime );
                     If_ManForEachCo( p, pObj, i )
                     {
                         if(pObj->fCompl1) //ymc: Cut-caused POs are not allowed to relax reqTime
-                            If_ObjFanin0(pObj)->Required = p->RequiredGlo;
+                            If_ObjFanin0(pObj)->Required = If_PifBoardCoRequired( p->pPars->pPifBoard, p->pPars->pPifCoSlots ? p->pPars->pPifCoSlots[i] : -1, p->RequiredGlo, If_ObjArrTime(If_ObjFanin0(pObj)) );
                         else
-                            If_ObjFanin0(pObj)->Required = *(p->pPars->piMaxReqTime); 
+                            If_ObjFanin0(pObj)->Required = MaxReqTime; 
                     }
                 }
                 else
@@ -469,6 +442,9 @@ void If_ManComputeRequired( If_Man_t * p )
                 continue;
             If_CutPropagateRequired( p, pObj, If_ObjCutBest(pObj), pObj->Required );
         }
+        //ymc
+        if ( p->pPars->bIsPif )
+            If_PifBoardPublish( p );
     }
     else
     {
@@ -79,7 +79,7 @@ void If_CutRotatePins( If_Man_t * p, If_Cut_t * pCut )
     }
     Abc_TtCopy( p->puTempW, If_CutTruthWR(p, pCut), p->nTruth6Words[pCut->nLeaves], 0 );
     If_CutTruthPermute( p->puTempW, If_CutLeaveNum(pCut), pCut->nLeaves, p->nTruth6Words[pCut->nLeaves], PinDelays, If_CutLeaves(pCut) );
-    truthId        = Vec_MemHashInsert( p->vTtMem[pCut->nLeaves], p->puTempW );
+    truthId        = If_TtStoreInsert( p->pTtStores[pCut->nLeaves], p->puTempW );
     pCut->iCutFunc = Abc_Var2Lit( truthId, If_CutTruthIsCompl(pCut) );
     assert( (p->puTempW[0] & 1) == 0 );
 }
@@ -122,7 +122,7 @@ int If_CutComputeTruth( If_Man_t * p, If_Cut_t * pCut, If_Cut_t * pCut0, If_Cut_
         }
     }
     PrevSize       = Vec_MemEntryNum( p->vTtMem[pCut->nLeaves] );   
-    truthId        = Vec_MemHashInsert( p->vTtMem[pCut->nLeaves], pTruth );
+    truthId        = If_TtStoreInsert( p->pTtStores[pCut->nLeaves], pTruth );
     pCut->iCutFunc = Abc_Var2Lit( truthId, fCompl );
     assert( (pTruth[0] & 1) == 0 );
 #ifdef IF_TRY_NEW
@@ -226,7 +226,7 @@ if ( fVerbose )
     // compute canonical form
 if ( p->pPars->fVerbose )
 clk = Abc_Clock();
-    p->uCanonPhase = Abc_TtCanonicize( pTruth, pCut->nLeaves, p->pCanonPerm );
+    p->uCanonPhase = Abc_TtCanonicizeCache( pTruth, pCut->nLeaves, p->pCanonPerm );
 if ( p->pPars->fVerbose )
 p->timeCache[3] += Abc_Clock() - clk;
     for ( v = 0; v < (int)pCut->nLeaves; v++ )
@@ -247,7 +247,7 @@ p->timeCache[3] += Abc_Clock() - clk;
     assert( Vec_IntSize(p->vTtOccurs[pCut->nLeaves]) == Vec_MemEntryNum(p->vTtMem[pCut->nLeaves]) );
     // hash function
     fCompl         = ((p->uCanonPhase >> pCut->nLeaves) & 1);
-    truthId        = Vec_MemHashInsert( p->vTtMem[pCut->nLeaves], pTruth );
+    truthId        = If_TtStoreInsert( p->pTtStores[pCut->nLeaves], pTruth );
     pCut->iCutFunc = Abc_Var2Lit( truthId, fCompl );
     // count how many time this truth table is used
     if ( Vec_IntSize(p->vTtOccurs[pCut->nLeaves]) < Vec_MemEntryNum(p->vTtMem[pCut->nLeaves]) )
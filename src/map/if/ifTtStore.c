@@ -0,0 +1,374 @@
+/**CFile****************************************************************
+
+  FileName    [ifTtStore.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [FPGA mapping based on priority cuts.]
+
+  Synopsis    [Sharded concurrent hash table of cut truth tables.]
+
+  Author      [ymc]
+
+  Affiliation []
+
+  Date        [Ver. 1.0. Started - October 17, 2026.]
+
+  Revision    [$Id: ifTtStore.c,v 1.00 2026/10/17 00:00:00 ymc Exp $]
+
+***********************************************************************/
+
+#include "if.h"
+
+#ifdef ABC_USE_PTHREADS
+
+#ifdef _WIN32
+#include "../lib/pthread.h"
+#else
+#include <pthread.h>
+#endif
+
+#endif
+
+ABC_NAMESPACE_IMPL_START
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+// The truth tables stay in the pages of Vec_Mem_t, so the truth IDs and
+// If_CutTruthWR() are unchanged; the store replaces the hash table of
+// Vec_Mem_t. The tables are stored in the canonical phase (the first bit
+// is 0, the phase is the complemented attribute of iCutFunc), and the
+// functions with less than 6 inputs share the 64-bit table of 6 inputs.
+//
+// The hash table is split into shards by the hash value. A shard is an
+// open-addressing table of truth IDs, whose slots are written once and
+// published with release semantics, so lookups take no locks. Inserts
+// lock the shard, and appending to Vec_Mem_t takes one more lock. When a
+// shard grows, the new table is published and the old one is retired
+// (freed with the store) since readers may still be probing it. The page
+// pointers of Vec_Mem_t are preallocated, so they never move.
+
+#define IF_TT_SHARD_LOG   6           // 64 shards
+#define IF_TT_SLOTS_INIT  256         // initial slots per shard
+#define IF_TT_PAGE_MAX    (1 << 14)   // max pages of Vec_Mem_t
+
+typedef struct If_TtTable_t_ If_TtTable_t;
+struct If_TtTable_t_
+{
+    int                nSlots;        // the number of slots (power of 2)
+    If_TtTable_t *     pPrev;         // the retired table
+    int                pSlots[0];     // truth IDs (-1 is empty)
+};
+
+typedef struct If_TtShard_t_ If_TtShard_t;
+struct If_TtShard_t_
+{
+    If_TtTable_t *     pTable;        // the current table
+    int                nEntries;      // the number of entries
+    word               nLookups;      // the number of lookups
+    word               nHits;         // the number of lookups finding the entry
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_t    Mutex;         // serializes the inserts
+#endif
+};
+
+struct If_TtStore_t_
+{
+    Vec_Mem_t *        vMem;          // the truth tables
+    int                nWords;        // the number of words in a truth table
+    If_TtShard_t *     pShards;       // the shards
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_t    Mutex;         // serializes appending to vMem
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+/**Function*************************************************************
+
+  Synopsis    [Hash function of a truth table.]
+
+  Description [The low bits select the shard, the others the slot.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static inline unsigned If_TtStoreHash( word * pTruth, int nWords )
+{
+    word Key = 0;
+    int i;
+    for ( i = 0; i < nWords; i++ )
+        Key = (Key ^ pTruth[i]) * ABC_CONST(0x9E3779B97F4A7C15);
+    return (unsigned)(Key >> 32) ^ (unsigned)Key;
+}
+// the counters are approximate when the store is used concurrently
+static inline void If_TtStoreCount( word * pCounter )
+{
+    __atomic_store_n( pCounter, __atomic_load_n(pCounter, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED );
+}
+static inline If_TtTable_t * If_TtTableAlloc( int nSlots )
+{
+    If_TtTable_t * pTable = (If_TtTable_t *)ABC_ALLOC( char, sizeof(If_TtTable_t) + sizeof(int) * nSlots );
+    pTable->nSlots = nSlots;
+    pTable->pPrev  = NULL;
+    memset( pTable->pSlots, 0xFF, sizeof(int) * nSlots );
+    return pTable;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Looks up the truth table in one table of a shard.]
+
+  Description [Returns the truth ID or -1. Safe without locking.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static inline int If_TtTableLookup( If_TtStore_t * p, If_TtTable_t * pTable, unsigned Hash, word * pTruth )
+{
+    int i, Id, Mask = pTable->nSlots - 1;
+    for ( i = (Hash >> IF_TT_SHARD_LOG) & Mask; ; i = (i + 1) & Mask )
+    {
+        Id = __atomic_load_n( pTable->pSlots + i, __ATOMIC_ACQUIRE );
+        if ( Id == -1 )
+            return -1;
+        if ( !memcmp( Vec_MemReadEntry(p->vMem, Id), pTruth, sizeof(word) * p->nWords ) )
+            return Id;
+    }
+    return -1;
+}
+static inline void If_TtTableAdd( If_TtTable_t * pTable, unsigned Hash, int Id )
+{
+    int i, Mask = pTable->nSlots - 1;
+    for ( i = (Hash >> IF_TT_SHARD_LOG) & Mask; pTable->pSlots[i] != -1; i = (i + 1) & Mask );
+    __atomic_store_n( pTable->pSlots + i, Id, __ATOMIC_RELEASE );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Doubles the table of the shard.]
+
+  Description [Called with the shard locked.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static void If_TtShardResize( If_TtStore_t * p, If_TtShard_t * pShard )
+{
+    If_TtTable_t * pOld = pShard->pTable;
+    If_TtTable_t * pNew = If_TtTableAlloc( 2 * pOld->nSlots );
+    int i, Id;
+    for ( i = 0; i < pOld->nSlots; i++ )
+        if ( (Id = pOld->pSlots[i]) != -1 )
+            If_TtTableAdd( pNew, If_TtStoreHash(Vec_MemReadEntry(p->vMem, Id), p->nWords), Id );
+    pNew->pPrev = pOld;
+    __atomic_store_n( &pShard->pTable, pNew, __ATOMIC_RELEASE );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Starts the store on top of the truth table memory.]
+
+  Description [Hashes the entries already in vMem (constant and
+  variable) and takes over from the hash table of vMem.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+If_TtStore_t * If_TtStoreStart( Vec_Mem_t * vMem )
+{
+    If_TtStore_t * p;
+    word * pTruth;
+    int i, nShards = (1 << IF_TT_SHARD_LOG);
+    p = ABC_CALLOC( If_TtStore_t, 1 );
+    p->vMem    = vMem;
+    p->nWords  = Vec_MemEntrySize( vMem );
+    p->pShards = ABC_CALLOC( If_TtShard_t, nShards );
+    for ( i = 0; i < nShards; i++ )
+    {
+        p->pShards[i].pTable = If_TtTableAlloc( IF_TT_SLOTS_INIT );
+#ifdef ABC_USE_PTHREADS
+        pthread_mutex_init( &p->pShards[i].Mutex, NULL );
+#endif
+    }
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_init( &p->Mutex, NULL );
+#endif
+    // the page pointers should not move under the readers
+    if ( vMem->nPageAlloc < IF_TT_PAGE_MAX )
+    {
+        vMem->ppPages = ABC_REALLOC( word *, vMem->ppPages, IF_TT_PAGE_MAX );
+        vMem->nPageAlloc = IF_TT_PAGE_MAX;
+    }
+    Vec_MemHashFree( vMem );
+    Vec_MemForEachEntry( vMem, pTruth, i )
+    {
+        unsigned Hash = If_TtStoreHash( pTruth, p->nWords );
+        If_TtShard_t * pShard = p->pShards + (Hash & (nShards - 1));
+        If_TtTableAdd( pShard->pTable, Hash, i );
+        pShard->nEntries++;
+    }
+    return p;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Stops the store.]
+
+  Description [Does not free the truth table memory.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_TtStoreStop( If_TtStore_t * p )
+{
+    If_TtTable_t * pTable, * pPrev;
+    int i;
+    if ( p == NULL )
+        return;
+    for ( i = 0; i < (1 << IF_TT_SHARD_LOG); i++ )
+    {
+        for ( pTable = p->pShards[i].pTable; pTable; pTable = pPrev )
+        {
+            pPrev = pTable->pPrev;
+            ABC_FREE( pTable );
+        }
+#ifdef ABC_USE_PTHREADS
+        pthread_mutex_destroy( &p->pShards[i].Mutex );
+#endif
+    }
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_destroy( &p->Mutex );
+#endif
+    ABC_FREE( p->pShards );
+    ABC_FREE( p );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Returns the ID of the truth table, adding it if new.]
+
+  Description [The truth table should be in the canonical phase. Can be
+  called concurrently; the IDs of new tables are then assigned in the
+  order the threads add them.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+int If_TtStoreInsert( If_TtStore_t * p, word * pTruth )
+{
+    unsigned Hash = If_TtStoreHash( pTruth, p->nWords );
+    If_TtShard_t * pShard = p->pShards + (Hash & ((1 << IF_TT_SHARD_LOG) - 1));
+    int Id;
+    If_TtStoreCount( &pShard->nLookups );
+    Id = If_TtTableLookup( p, __atomic_load_n(&pShard->pTable, __ATOMIC_ACQUIRE), Hash, pTruth );
+    if ( Id >= 0 )
+    {
+        If_TtStoreCount( &pShard->nHits );
+        return Id;
+    }
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_lock( &pShard->Mutex );
+#endif
+    // another thread may have added it in the meantime
+    Id = If_TtTableLookup( p, pShard->pTable, Hash, pTruth );
+    if ( Id >= 0 )
+        If_TtStoreCount( &pShard->nHits );
+    else
+    {
+        if ( 2 * (pShard->nEntries + 1) > pShard->pTable->nSlots )
+            If_TtShardResize( p, pShard );
+#ifdef ABC_USE_PTHREADS
+        pthread_mutex_lock( &p->Mutex );
+#endif
+        Id = Vec_MemEntryNum( p->vMem );
+        if ( (Id >> p->vMem->LogPageSze) >= IF_TT_PAGE_MAX )
+        {
+            printf( "If_TtStoreInsert(): The truth table memory is exhausted.\n" );
+            fflush( stdout );
+            abort();
+        }
+        Vec_MemPush( p->vMem, pTruth );
+#ifdef ABC_USE_PTHREADS
+        pthread_mutex_unlock( &p->Mutex );
+#endif
+        If_TtTableAdd( pShard->pTable, Hash, Id );
+        pShard->nEntries++;
+    }
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_unlock( &pShard->Mutex );
+#endif
+    return Id;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Returns the memory used by the store in bytes.]
+
+  Description [Includes the pages of the truth tables and the shard
+  tables, retired ones too.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+double If_TtStoreMemory( If_TtStore_t * p )
+{
+    If_TtTable_t * pTable;
+    double Memory = Vec_MemMemory( p->vMem ) + sizeof(If_TtStore_t) + sizeof(If_TtShard_t) * (1 << IF_TT_SHARD_LOG);
+    int i;
+    for ( i = 0; i < (1 << IF_TT_SHARD_LOG); i++ )
+        for ( pTable = p->pShards[i].pTable; pTable; pTable = pTable->pPrev )
+            Memory += sizeof(If_TtTable_t) + sizeof(int) * pTable->nSlots;
+    return Memory;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Reports the statistics of the store.]
+
+  Description []
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void If_TtStorePrintStats( If_TtStore_t * p, int nVars )
+{
+    word nLookups = 0, nHits = 0;
+    double Memory = If_TtStoreMemory( p );
+    int i, nEntries = Vec_MemEntryNum( p->vMem );
+    for ( i = 0; i < (1 << IF_TT_SHARD_LOG); i++ )
+    {
+        nLookups += p->pShards[i].nLookups;
+        nHits    += p->pShards[i].nHits;
+    }
+    printf( "Truth store %2d: Entries = %8d  Lookups = %10.0f  Hit rate = %6.2f %%  Bytes/entry = %8.2f  Memory = %7.2f MB\n",
+        nVars, nEntries, (double)nLookups, nLookups ? 100.0 * nHits / nLookups : 0.0,
+        nEntries ? Memory / nEntries : 0.0, Memory / (1<<20) );
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
+
+
+ABC_NAMESPACE_IMPL_END
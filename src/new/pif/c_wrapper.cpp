@@ -74,7 +74,10 @@ int test_yaig()
 	return 0;
 }
 
-Abc_Ntk_t* pif(Abc_Ntk_t* pNtk, uint32_t nParts, uint32_t sCluster, char* libFileName, char* dirName)
+//the parts of the last pif -E run, for the next one, freed by pifStop()
+static PifEcoCache* s_pEcoCache = NULL;
+
+Abc_Ntk_t* pif(Abc_Ntk_t* pNtk, uint32_t nParts, uint32_t sCluster, uint32_t nThreads, uint32_t nIters, char* libFileName, char* dirName, char* dumpFormat, int fCalibrate, uint32_t nFringe, int fEco)
 {
 #ifdef PIF_MULTITHREAD
 	ylog("PIF_MULTITHREAD is on\n");
@@ -86,18 +89,26 @@ Abc_Ntk_t* pif(Abc_Ntk_t* pNtk, uint32_t nParts, uint32_t sCluster, char* libFil
 	gettimeofday(&t1, NULL);
 
 	shared_ptr<PartNtk> spPN = make_shared<PartNtk>(pNtk, nParts, sCluster, libFileName, dirName);
-
+	if (!spPN->loadDsdLib())
+		return NULL;
+
+	spPN->setNThreads(nThreads);
+	spPN->setDumpFormat(dumpFormat);
+	spPN->setCalibrate(fCalibrate);
+	spPN->setFringe(nFringe);
+	spPN->setNIters(nIters);
+	if (fEco)
+	{
+		if (s_pEcoCache == NULL)
+			s_pEcoCache = new PifEcoCache;
+		spPN->setEcoCache(s_pEcoCache);
+	}
 	spPN->partOriginNtk();
-<<<<<<< HEAD
-	if (sCluster != 0)
-		exit(0);
-	//spPN->startThread();
-=======
-//	spPN->startThread();
-	ylog("Now calling the serialMap()\n");
->>>>>>> parent of 78fef875 (try Openmp!)
-	spPN->serialMap();
+	ylog("Now calling the iterativeMap() with %u threads\n", nThreads);
+	spPN->iterativeMap();
+	spPN->reportPartCosts();
 	spPN->mergeMappedSubNtk();
+	spPN->saveEcoCache();
 
 	gettimeofday(&t2, NULL);
    	time = t2.tv_sec - t1.tv_sec + (t2.tv_usec - t1.tv_usec)/1000000.0;
@@ -108,6 +119,13 @@ Abc_Ntk_t* pif(Abc_Ntk_t* pNtk, uint32_t nParts, uint32_t sCluster, char* libFil
 	
 }
 
+//called when the Abc frame is stopped, while the networks can still be deleted
+void pifStop()
+{
+	delete s_pEcoCache;
+	s_pEcoCache = NULL;
+}
+
 } //for namespace
 
 extern "C" int ymc_hello_wrapper()
@@ -127,7 +145,12 @@ extern "C" int ymc_test_yaig_wrapper()
 	return ymc::test_yaig();
 }
 
-extern "C" Abc_Ntk_t* ymc_pif_wrapper(Abc_Ntk_t* pNtk, uint32_t nParts, uint32_t sCluster, char* libFileName, char* dirName)
+extern "C" Abc_Ntk_t* ymc_pif_wrapper(Abc_Ntk_t* pNtk, uint32_t nParts, uint32_t sCluster, uint32_t nThreads, uint32_t nIters, char* libFileName, char* dirName, char* dumpFormat, int fCalibrate, uint32_t nFringe, int fEco)
+{
+	return ymc::pif(pNtk, nParts, sCluster, nThreads, nIters, libFileName, dirName, dumpFormat, fCalibrate, nFringe, fEco);
+}
+
+extern "C" void ymc_pif_stop_wrapper()
 {
-	return ymc::pif(pNtk, nParts, sCluster, libFileName, dirName);
+	ymc::pifStop();
 }
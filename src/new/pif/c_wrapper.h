@@ -15,7 +15,7 @@ namespace ymc {
 int hello();
 // int try_metis(); comment metis by zli
 int test_yaig();
-Abc_Ntk_t* pif(Abc_Ntk_t* pNtk, uint32_t nParts, uint32_t sCluster, char* libFileName, char* dirName);
+Abc_Ntk_t* pif(Abc_Ntk_t* pNtk, uint32_t nParts, uint32_t sCluster, uint32_t nThreads, uint32_t nIters, char* libFileName, char* dirName, char* dumpFormat, int fCalibrate, uint32_t nFringe, int fEco);
 
 
 
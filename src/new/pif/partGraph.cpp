@@ -0,0 +1,472 @@
+#include "partNtkFuncs.h"
+#include <queue>
+#include <random>
+#include <tuple>
+
+namespace ymc{
+
+/**Function*************************************************************
+
+  Synopsis    [Multilevel k-way partitioning of MetisGraph.]
+
+  Description [Heavy-edge coarsening, greedy graph growing on the coarsest
+  graph, then balancing and FM refinement while projecting back. Works on
+  the same CSR arrays and node/edge weights that used to be given to METIS.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+
+//one level of the multilevel hierarchy, in the same CSR layout as Graph
+class KwayGraph {
+public:
+	int32_t nNodes;
+	vector<int32_t> vIndices; //size: N+1
+	vector<int32_t> vAdj;
+	vector<int64_t> vAdjWeights;
+	vector<int32_t> vNodeWeights;
+	vector<int32_t> vCoarseMap; //nodeId -> nodeId in the next coarser level
+
+	int64_t totalWeight() const { return accumulate(vNodeWeights.begin(), vNodeWeights.end(), (int64_t)0); }
+	int32_t maxNodeWeight() const { return *max_element(vNodeWeights.begin(), vNodeWeights.end()); }
+};
+
+static int32_t kwayMatchHeavyEdges(KwayGraph& g, int64_t maxNodeWeight, mt19937& rng)
+{
+	vector<int32_t> vOrder(g.nNodes);
+	iota(vOrder.begin(), vOrder.end(), 0);
+	shuffle(vOrder.begin(), vOrder.end(), rng);
+	vector<int32_t> vMatch(g.nNodes, -1);
+	int32_t nCoarse = 0;
+	g.vCoarseMap.assign(g.nNodes, -1);
+	for(auto u : vOrder)
+	{
+		if(vMatch[u] != -1)
+			continue;
+		int32_t best = u;
+		int64_t bestWeight = -1;
+		for(int32_t e = g.vIndices[u]; e < g.vIndices[u + 1]; e++)
+		{
+			int32_t v = g.vAdj[e];
+			if(v == u || vMatch[v] != -1)
+				continue;
+			if(g.vNodeWeights[u] + g.vNodeWeights[v] > maxNodeWeight)
+				continue;
+			if(g.vAdjWeights[e] > bestWeight)
+			{
+				bestWeight = g.vAdjWeights[e];
+				best = v;
+			}
+		}
+		vMatch[u] = best;
+		vMatch[best] = u;
+		g.vCoarseMap[u] = g.vCoarseMap[best] = nCoarse++;
+	}
+	return nCoarse;
+}
+
+static void kwayContract(const KwayGraph& g, int32_t nCoarse, KwayGraph& c)
+{
+	//fine nodes of each coarse node
+	vector<int32_t> vFirst(nCoarse + 1, 0), vMembers(g.nNodes);
+	for(int32_t u = 0; u < g.nNodes; u++)
+		vFirst[g.vCoarseMap[u] + 1]++;
+	partial_sum(vFirst.begin(), vFirst.end(), vFirst.begin());
+	vector<int32_t> vFill(vFirst.begin(), vFirst.end() - 1);
+	for(int32_t u = 0; u < g.nNodes; u++)
+		vMembers[vFill[g.vCoarseMap[u]]++] = u;
+
+	c.nNodes = nCoarse;
+	c.vNodeWeights.assign(nCoarse, 0);
+	c.vIndices.assign(1, 0);
+	c.vAdj.clear();
+	c.vAdjWeights.clear();
+	c.vAdj.reserve(g.vAdj.size());
+	c.vAdjWeights.reserve(g.vAdj.size());
+	vector<int32_t> vSlot(nCoarse, -1);
+	for(int32_t cu = 0; cu < nCoarse; cu++)
+	{
+		int32_t iBeg = c.vAdj.size();
+		for(int32_t k = vFirst[cu]; k < vFirst[cu + 1]; k++)
+		{
+			int32_t u = vMembers[k];
+			c.vNodeWeights[cu] += g.vNodeWeights[u];
+			for(int32_t e = g.vIndices[u]; e < g.vIndices[u + 1]; e++)
+			{
+				int32_t cv = g.vCoarseMap[g.vAdj[e]];
+				if(cv == cu)
+					continue;
+				if(vSlot[cv] == -1)
+				{
+					vSlot[cv] = c.vAdj.size();
+					c.vAdj.push_back(cv);
+					c.vAdjWeights.push_back(g.vAdjWeights[e]);
+				}
+				else
+					c.vAdjWeights[vSlot[cv]] += g.vAdjWeights[e];
+			}
+		}
+		for(int32_t e = iBeg; e < c.vAdj.size(); e++)
+			vSlot[c.vAdj[e]] = -1;
+		c.vIndices.push_back(c.vAdj.size());
+	}
+}
+
+static int64_t kwayComputeCut(const KwayGraph& g, const vector<int32_t>& vPart)
+{
+	int64_t cut = 0;
+	for(int32_t u = 0; u < g.nNodes; u++)
+		for(int32_t e = g.vIndices[u]; e < g.vIndices[u + 1]; e++)
+			if(vPart[u] != vPart[g.vAdj[e]])
+				cut += g.vAdjWeights[e];
+	return cut / 2;
+}
+
+//grow nParts-1 parts one after another from random seeds, always adding the node most connected to the part
+static void kwayGrowPartition(const KwayGraph& g, int32_t nParts, mt19937& rng, vector<int32_t>& vPart)
+{
+	vPart.assign(g.nNodes, nParts - 1);
+	vector<char> vAssigned(g.nNodes, 0);
+	vector<int64_t> vConn(g.nNodes, 0);
+	int64_t total = g.totalWeight(), assigned = 0;
+	for(int32_t p = 0; p < nParts - 1; p++)
+	{
+		int64_t target = (total - assigned) / (nParts - p);
+		int64_t partWeight = 0;
+		priority_queue<pair<int64_t, int32_t>> queue;
+		while(partWeight < target)
+		{
+			int32_t u = -1;
+			while(!queue.empty())
+			{
+				auto top = queue.top();
+				queue.pop();
+				if(!vAssigned[top.second] && top.first == vConn[top.second])
+				{
+					u = top.second;
+					break;
+				}
+			}
+			if(u == -1) //new seed
+			{
+				int32_t start = rng() % g.nNodes;
+				for(int32_t k = 0; k < g.nNodes && u == -1; k++)
+					if(!vAssigned[(start + k) % g.nNodes])
+						u = (start + k) % g.nNodes;
+				if(u == -1)
+					break;
+			}
+			if(partWeight > 0 && partWeight + g.vNodeWeights[u] - target > target - partWeight)
+				break;
+			vAssigned[u] = 1;
+			vPart[u] = p;
+			partWeight += g.vNodeWeights[u];
+			for(int32_t e = g.vIndices[u]; e < g.vIndices[u + 1]; e++)
+			{
+				int32_t v = g.vAdj[e];
+				if(vAssigned[v])
+					continue;
+				vConn[v] += g.vAdjWeights[e];
+				queue.push(make_pair(vConn[v], v));
+			}
+		}
+		assigned += partWeight;
+		fill(vConn.begin(), vConn.end(), 0);
+	}
+}
+
+class KwayRefiner {
+public:
+	KwayRefiner(const KwayGraph& g, int32_t nParts, int64_t maxPartWeight, vector<int32_t>& vPart):
+		m_g(g), m_nParts(nParts), m_maxPartWeight(maxPartWeight), m_vPart(vPart), m_vConn(nParts, 0)
+	{
+		m_vPartWeights.assign(nParts, 0);
+		for(int32_t u = 0; u < g.nNodes; u++)
+			m_vPartWeights[vPart[u]] += g.vNodeWeights[u];
+	}
+	void balance();
+	int64_t refine(int32_t nPasses, int32_t nNoGain);
+
+private:
+	int64_t bestMove(int32_t u, int32_t& to, bool fBalance);
+	void move(int32_t u, int32_t to)
+	{
+		m_vPartWeights[m_vPart[u]] -= m_g.vNodeWeights[u];
+		m_vPartWeights[to] += m_g.vNodeWeights[u];
+		m_vPart[u] = to;
+	}
+
+	const KwayGraph& m_g;
+	int32_t m_nParts;
+	int64_t m_maxPartWeight;
+	vector<int32_t>& m_vPart;
+	vector<int64_t> m_vPartWeights;
+	vector<int64_t> m_vConn; //scratch: connection of one node to each part
+	vector<int32_t> m_vTouched;
+};
+
+//gain of the best feasible move of u to an adjacent part (to = -1 if none).
+//With fBalance, u leaves an overweight part and any lighter part is feasible.
+int64_t KwayRefiner::bestMove(int32_t u, int32_t& to, bool fBalance)
+{
+	int32_t from = m_vPart[u];
+	int32_t w = m_g.vNodeWeights[u];
+	for(int32_t e = m_g.vIndices[u]; e < m_g.vIndices[u + 1]; e++)
+	{
+		int32_t p = m_vPart[m_g.vAdj[e]];
+		if(m_vConn[p] == 0)
+			m_vTouched.push_back(p);
+		m_vConn[p] += m_g.vAdjWeights[e];
+	}
+	int64_t connFrom = m_vConn[from];
+	int64_t gain = 0;
+	to = -1;
+	for(auto p : m_vTouched)
+	{
+		if(p == from)
+			continue;
+		if(fBalance ? (m_vPartWeights[p] + w >= m_vPartWeights[from]) : (m_vPartWeights[p] + w > m_maxPartWeight || m_vPartWeights[from] - w <= 0))
+			continue;
+		int64_t g = m_vConn[p] - connFrom;
+		if(to == -1 || g > gain || (g == gain && m_vPartWeights[p] < m_vPartWeights[to]))
+		{
+			gain = g;
+			to = p;
+		}
+	}
+	for(auto p : m_vTouched)
+		m_vConn[p] = 0;
+	m_vTouched.clear();
+	if(fBalance && to == -1) //not adjacent to a lighter part: go to the lightest one
+	{
+		int32_t lightest = min_element(m_vPartWeights.begin(), m_vPartWeights.end()) - m_vPartWeights.begin();
+		if(m_vPartWeights[lightest] + w < m_vPartWeights[from])
+		{
+			to = lightest;
+			gain = -connFrom;
+		}
+	}
+	return gain;
+}
+
+//move the nodes with the smallest loss out of the overweight parts
+void KwayRefiner::balance()
+{
+	for(int32_t p = 0; p < m_nParts; p++)
+	{
+		if(m_vPartWeights[p] <= m_maxPartWeight)
+			continue;
+		priority_queue<tuple<int64_t, int32_t, int32_t>> queue;
+		int32_t to;
+		for(int32_t u = 0; u < m_g.nNodes; u++)
+			if(m_vPart[u] == p)
+			{
+				int64_t gain = bestMove(u, to, true);
+				if(to != -1)
+					queue.push(make_tuple(gain, u, to));
+			}
+		while(m_vPartWeights[p] > m_maxPartWeight && !queue.empty())
+		{
+			int32_t u = get<1>(queue.top());
+			queue.pop();
+			bestMove(u, to, true);
+			if(to != -1)
+				move(u, to);
+		}
+	}
+}
+
+//k-way FM: move the node with the highest gain, lock it, and roll back to the best cut of the pass
+int64_t KwayRefiner::refine(int32_t nPasses, int32_t nNoGain)
+{
+	int64_t cut = kwayComputeCut(m_g, m_vPart);
+	vector<char> vLocked(m_g.nNodes, 0);
+	vector<pair<int32_t, int32_t>> vMoves; //(node, from)
+	for(int32_t pass = 0; pass < nPasses; pass++)
+	{
+		priority_queue<tuple<int64_t, int32_t, int32_t>> queue;
+		int32_t to;
+		for(int32_t u = 0; u < m_g.nNodes; u++)
+		{
+			int64_t gain = bestMove(u, to, false);
+			if(to != -1)
+				queue.push(make_tuple(gain, u, to));
+		}
+		int64_t cutBest = cut;
+		size_t nMovesBest = 0;
+		int32_t nFails = 0;
+		vMoves.clear();
+		while(!queue.empty() && nFails < nNoGain)
+		{
+			int64_t gain;
+			int32_t u, toOld;
+			tie(gain, u, toOld) = queue.top();
+			queue.pop();
+			if(vLocked[u])
+				continue;
+			int64_t gainNew = bestMove(u, to, false);
+			if(to == -1)
+				continue;
+			if(gainNew != gain || to != toOld) //stale entry
+			{
+				queue.push(make_tuple(gainNew, u, to));
+				continue;
+			}
+			vMoves.push_back(make_pair(u, m_vPart[u]));
+			move(u, to);
+			vLocked[u] = 1;
+			cut -= gain;
+			if(cut < cutBest)
+			{
+				cutBest = cut;
+				nMovesBest = vMoves.size();
+				nFails = 0;
+			}
+			else
+				nFails++;
+			for(int32_t e = m_g.vIndices[u]; e < m_g.vIndices[u + 1]; e++)
+			{
+				int32_t v = m_g.vAdj[e];
+				if(vLocked[v])
+					continue;
+				int64_t gainV = bestMove(v, to, false);
+				if(to != -1)
+					queue.push(make_tuple(gainV, v, to));
+			}
+		}
+		while(vMoves.size() > nMovesBest)
+		{
+			move(vMoves.back().first, vMoves.back().second);
+			vMoves.pop_back();
+		}
+		fill(vLocked.begin(), vLocked.end(), 0);
+		cut = cutBest;
+		if(nMovesBest == 0)
+			break;
+	}
+	return cut;
+}
+
+int MetisGraph::partGraphKway(int32_t nParts)
+{
+	struct timeval t1,t2;
+	double time;
+	gettimeofday(&t1, NULL);
+
+	yassert(nParts >= 2);
+	if(m_nNodes < nParts)
+	{
+		Abc_Print(-1, "Cannot split %d nodes into %d parts.\n", m_nNodes, nParts);
+		return -1;
+	}
+	m_nParts = nParts;
+
+	vector<KwayGraph> vLevels;
+	vLevels.reserve(KWAY_MAX_LEVELS + 1);
+	vLevels.emplace_back();
+	KwayGraph& g0 = vLevels[0];
+	g0.nNodes = m_nNodes;
+	g0.vIndices.assign(m_vNodeIndices.begin(), m_vNodeIndices.begin() + m_nNodes + 1);
+	g0.vAdj.assign(m_vEdges.begin(), m_vEdges.begin() + g0.vIndices[m_nNodes]);
+	if(m_vEdgeWeights.empty())
+		g0.vAdjWeights.assign(g0.vAdj.size(), 1);
+	else
+	{
+		//the two directions of an edge may carry different weights: keep the larger one.
+		//In DFS order the smaller id is a fanin, listed first at the larger id.
+		g0.vAdjWeights.assign(m_vEdgeWeights.begin(), m_vEdgeWeights.begin() + g0.vAdj.size());
+		for(int32_t u = 0; u < m_nNodes; u++)
+			for(int32_t e = g0.vIndices[u]; e < g0.vIndices[u + 1]; e++)
+			{
+				int32_t v = g0.vAdj[e];
+				if(v < u)
+					continue;
+				int32_t r = g0.vIndices[v];
+				if(g0.vAdj[r] != u)
+					r++;
+				yassert(r < g0.vIndices[v + 1] && g0.vAdj[r] == u);
+				g0.vAdjWeights[e] = g0.vAdjWeights[r] = max(g0.vAdjWeights[e], g0.vAdjWeights[r]);
+			}
+	}
+	if(m_vNodeWeights.empty())
+		g0.vNodeWeights.assign(m_nNodes, 1);
+	else
+		g0.vNodeWeights.assign(m_vNodeWeights.begin(), m_vNodeWeights.begin() + m_nNodes);
+
+	//coarsening
+	mt19937 rng(0);
+	int64_t total = g0.totalWeight();
+	int32_t nCoarsenTo = KWAY_COARSEN_TO * nParts;
+	int64_t maxNodeWeight = max((int64_t)1, 3 * total / (2 * nCoarsenTo));
+	while(vLevels.back().nNodes > nCoarsenTo && vLevels.size() <= KWAY_MAX_LEVELS)
+	{
+		KwayGraph& fine = vLevels.back();
+		int32_t nCoarse = kwayMatchHeavyEdges(fine, maxNodeWeight, rng);
+		if(nCoarse > fine.nNodes * 19 / 20) //too few matches
+			break;
+		KwayGraph coarse;
+		kwayContract(fine, nCoarse, coarse);
+		vLevels.push_back(std::move(coarse));
+	}
+	ylog("Kway coarsening: %d levels, %d -> %d nodes\n", (int)vLevels.size(), m_nNodes, vLevels.back().nNodes);
+
+	//initial partition on the coarsest graph
+	vector<int32_t> vPart, vPartTry;
+	int64_t cutBest = -1;
+	const KwayGraph& gc = vLevels.back();
+	int64_t maxPartWeight = max(total * (1000 + METIS_UFACTOR) / (1000 * nParts), (total + nParts - 1) / nParts + gc.maxNodeWeight());
+	for(int32_t i = 0; i < KWAY_N_INIT_TRIES; i++)
+	{
+		kwayGrowPartition(gc, nParts, rng, vPartTry);
+		KwayRefiner refiner(gc, nParts, maxPartWeight, vPartTry);
+		refiner.balance();
+		int64_t cut = refiner.refine(KWAY_N_PASSES, KWAY_FM_NO_GAIN);
+		if(cutBest == -1 || cut < cutBest)
+		{
+			cutBest = cut;
+			vPart = vPartTry;
+		}
+	}
+
+	//uncoarsening
+	for(int32_t level = vLevels.size() - 2; level >= 0; level--)
+	{
+		const KwayGraph& g = vLevels[level];
+		vPartTry.resize(g.nNodes);
+		for(int32_t u = 0; u < g.nNodes; u++)
+			vPartTry[u] = vPart[g.vCoarseMap[u]];
+		vPart.swap(vPartTry);
+		maxPartWeight = max(total * (1000 + METIS_UFACTOR) / (1000 * nParts), (total + nParts - 1) / nParts + (level ? g.maxNodeWeight() : 0));
+		KwayRefiner refiner(g, nParts, maxPartWeight, vPart);
+		refiner.balance();
+		cutBest = refiner.refine(KWAY_N_PASSES, KWAY_FM_NO_GAIN);
+	}
+
+	vector<int64_t> vPartWeights(nParts, 0);
+	int32_t nWallCut = 0;
+	m_nCutEdges = 0;
+	for(int32_t u = 0; u < m_nNodes; u++)
+	{
+		m_vPartition[u] = vPart[u];
+		vPartWeights[vPart[u]] += g0.vNodeWeights[u];
+		for(int32_t e = g0.vIndices[u]; e < g0.vIndices[u + 1]; e++)
+			if(u < g0.vAdj[e] && vPart[u] != vPart[g0.vAdj[e]])
+			{
+				m_nCutEdges++;
+				if(g0.vAdjWeights[e] >= WALL_EDGE_WEIGHT)
+					nWallCut++;
+			}
+	}
+	for(int32_t p = 0; p < nParts; p++)
+		ylog("Part %d: weight = %ld\n", p, (long)vPartWeights[p]);
+
+	gettimeofday(&t2, NULL);
+   	time = t2.tv_sec - t1.tv_sec + (t2.tv_usec - t1.tv_usec)/1000000.0;
+   	printf("partGraphKway spent time: %f\n", time);
+	Abc_Print(-2, "nedgecut = %d (weighted = %ld, walls = %d)\n", m_nCutEdges, (long)cutBest, nWallCut);
+	return m_nCutEdges;
+}
+
+} //for namespace
@@ -4,9 +4,10 @@ namespace ymc {
 
 PartNtk::~PartNtk()
 {
+	waitDump();
 	for (auto pNtk : m_vSubNtks)
 	{
-        Abc_NtkCleanMarkA(pNtk);
+        Abc_NtkCleanMarkAB(pNtk); //fMarkB: the copies of the fringes
 		Abc_NtkDelete(pNtk);
 	}
 	for (auto pNtk : m_vSubNtksMapped)
@@ -14,6 +15,11 @@ PartNtk::~PartNtk()
         Abc_NtkCleanMarkA(pNtk);
 		Abc_NtkDelete(pNtk);
 	}
+	for (auto pDsdMan : m_vpDsdOverlays)
+		if (pDsdMan)
+			If_DsdManFree(pDsdMan, 0);
+	if (m_pPifBoard)
+		If_PifBoardStop(m_pPifBoard);
 	/*
 	for (auto pIfPars : m_vpIfPars)
 	{
@@ -24,15 +30,61 @@ PartNtk::~PartNtk()
 	*/
 }
 
+//The library is parsed once and cached in the Abc frame, so repeated pif calls
+//with the same file skip the loading. Without -l, the manager from dsd_load is used;
+//it stays unchanged, so the structures found by pif are dropped (see mergeDsdOverlays()).
+bool PartNtk::loadDsdLib()
+{
+	If_DsdMan_t* pDsdMan;
+	if (m_pDsdLibFile[0] == '\0')
+	{
+		pDsdMan = (If_DsdMan_t*)Abc_FrameReadManDsd();
+		if (pDsdMan == NULL)
+		{
+			printf("No DSD library is given (use -l <file> or dsd_load).\n");
+			return false;
+		}
+		m_fDsdFromFrame = true;
+	}
+	else
+	{
+		pDsdMan = (If_DsdMan_t*)Abc_FrameReadManDsdPif();
+		if (pDsdMan == NULL || strcmp(If_DsdManFileName(pDsdMan), m_pDsdLibFile))
+		{
+			struct timeval t1,t2;
+			double time;
+			gettimeofday(&t1, NULL);
+			pDsdMan = If_DsdManLoad(m_pDsdLibFile);
+			if (pDsdMan == NULL)
+				return false;
+			Abc_FrameSetManDsdPif(pDsdMan);
+			gettimeofday(&t2, NULL);
+			time = t2.tv_sec - t1.tv_sec + (t2.tv_usec - t1.tv_usec)/1000000.0;
+			printf("loadDsdLib spent time: %f\n", time);
+		}
+		else
+			ylog("Reusing the DSD library %s\n", m_pDsdLibFile);
+	}
+	if (!m_fDsdFromFrame)
+		If_DsdManSetNewAsUseless(pDsdMan);
+	m_pDsdMan = pDsdMan;
+	return true;
+}
+
+//Each thread maps with a private overlay of the shared library, see mergeDsdOverlays().
 void PartNtk::setIfPars(If_Par_t* pIfPars, int threadId = 0)
 {
+	yassert(m_pDsdMan);
 	memset(pIfPars, 0, sizeof(If_Par_t));
 	pIfPars->bIsPif = 1;
-	pIfPars->pDsdMan = If_DsdManLoad(m_pDsdLibFile);
-	pIfPars->piMaxReqTime = &m_iMaxReqTime;
+	pIfPars->pDsdMan = If_DsdManStartOverlay(m_pDsdMan);
+	if (m_fDsdFromFrame)
+		If_DsdManSetNewAsUseless(pIfPars->pDsdMan);
+	pIfPars->pPifBoard = m_pPifBoard;
+	pIfPars->pPifCiSlots = m_vvPifCiSlots[threadId].data();
+	pIfPars->pPifCoSlots = m_vvPifCoSlots[threadId].data();
 	pIfPars->factor = 1.0;
 	pIfPars->iThreadId = threadId;
-    If_DsdManSetNewAsUseless(pIfPars->pDsdMan);
 	pIfPars->nLutSize = If_DsdManVarNum(pIfPars->pDsdMan);
 	pIfPars->nCutsMax = 8; 
 	pIfPars->nFlowIters = 1; 
@@ -54,9 +106,15 @@ void PartNtk::init()
 	{
 		m_vSubNtks.resize(m_nParts);
 		m_vSubNtksMapped.resize(m_nParts);
+		m_vpDsdOverlays.resize(m_nParts, NULL);
+		m_vPartMapTime.resize(m_nParts, -1);
+		m_vPartCutsMerged.resize(m_nParts, 0);
+		m_vPartCutsNodeMax.resize(m_nParts, 0);
 	}
 }
 
+//The parts are dealt round-robin to the workers, largest first. A worker maps
+//its own parts from the front and steals from the back of the others.
 void PartNtk::startThread()
 {
 	yassert(m_nParts == m_vSubNtks.size());
@@ -64,22 +122,70 @@ void PartNtk::startThread()
 	double time;
 	gettimeofday(&t1, NULL);
 
+	int nWorkers = max(1, min((int)m_nThreads, (int)m_vPartsToMap.size()));
+	vector<int> vOrder(m_vPartsToMap);
+	if (m_vPartWorkloads.size() == m_nParts)
+		stable_sort(vOrder.begin(), vOrder.end(), [this](int lhs, int rhs){ return m_vPartWorkloads[lhs] > m_vPartWorkloads[rhs]; });
+	else
+		stable_sort(vOrder.begin(), vOrder.end(), [this](int lhs, int rhs){ return Abc_NtkNodeNum(m_vSubNtks[lhs]) > Abc_NtkNodeNum(m_vSubNtks[rhs]); });
+	m_vQueues = vector<deque<int>>(nWorkers);
+	m_vQueueLocks = vector<mutex>(nWorkers);
+	m_vBusyTime = vector<double>(nWorkers, 0);
+	for (int i = 0; i < vOrder.size(); i++)
+		m_vQueues[i % nWorkers].push_back(vOrder[i]);
+
 	vector<thread> vThreads;
-	vThreads.reserve(m_nParts);
-	for (int i = 0; i < m_nParts; i++)
+	vThreads.reserve(nWorkers);
+	for (int i = 0; i < nWorkers; i++)
 		vThreads.push_back(thread(threadWrapper, static_cast<void*>(this), i));
 	for (auto iter = vThreads.begin(); iter != vThreads.end(); ++iter)
 		iter->join();
+	If_PifBoardCommit(m_pPifBoard);
+	mergeDsdOverlays();
 
 	gettimeofday(&t2, NULL);
    	time = t2.tv_sec - t1.tv_sec + (t2.tv_usec - t1.tv_usec)/1000000.0;
+	for (int i = 0; i < nWorkers; i++)
+		printf("Worker %d: busy time: %f\tidle time: %f\n", i, m_vBusyTime[i], time - m_vBusyTime[i]);
    	printf("startThread spent time: %f\n", time);
 }
 
+bool PartNtk::popPart(int iWorker, int& iPart)
+{
+	int nWorkers = m_vQueues.size();
+	for (int k = 0; k < nWorkers; k++)
+	{
+		int iVictim = (iWorker + k) % nWorkers;
+		lock_guard<mutex> lock(m_vQueueLocks[iVictim]);
+		deque<int>& queue = m_vQueues[iVictim];
+		if (queue.empty())
+			continue;
+		if (k == 0) {
+			iPart = queue.front();
+			queue.pop_front();
+		}
+		else {
+			iPart = queue.back();
+			queue.pop_back();
+			ylog("Worker %d steals part %d from worker %d\n", iWorker, iPart, iVictim);
+		}
+		return true;
+	}
+	return false;
+}
+
 void PartNtk::threadWrapper(void* pThis, int id)
 {
 	PartNtk* pPN = static_cast<PartNtk*>(pThis);
-	pPN->threadKernel(id);
+	struct timeval t1,t2;
+	int iPart;
+	while (pPN->popPart(id, iPart))
+	{
+		gettimeofday(&t1, NULL);
+		pPN->threadKernel(iPart);
+		gettimeofday(&t2, NULL);
+		pPN->m_vBusyTime[id] += t2.tv_sec - t1.tv_sec + (t2.tv_usec - t1.tv_usec)/1000000.0;
+	}
 }
 
 void PartNtk::threadKernel(int id)
@@ -89,36 +195,180 @@ void PartNtk::threadKernel(int id)
 	double time;
 	gettimeofday(&t1, NULL);
 
-	If_Par_t ifPars;
-	If_Par_t* pIfPars = &ifPars;
-	setIfPars(pIfPars, id);
-	m_vSubNtksMapped[id] = Abc_NtkIf(m_vSubNtks[id], pIfPars);
-	If_DsdManFree(pIfPars->pDsdMan, 0);
+	mapOnePart(id, id);
 
 	gettimeofday(&t2, NULL);
    	time = t2.tv_sec - t1.tv_sec + (t2.tv_usec - t1.tv_usec)/1000000.0;
    	printf("Thread %d spent time: %f\n", id, time);
 }
 
+void PartNtk::mapOnePart(int iPart, int threadId)
+{
+	If_Par_t ifPars;
+	If_Par_t* pIfPars = &ifPars;
+	setIfPars(pIfPars, threadId);
+	m_vvBoundaryTiming[iPart] = boundaryTiming(iPart);
+	if (m_vSubNtksMapped[iPart])
+		Abc_NtkDelete(m_vSubNtksMapped[iPart]);
+	bool fFirst = m_vPartMapTime[iPart] < 0; //the cost model predicts the first mapping of a part
+	if (fFirst)
+		pIfPars->vCutCosts = Vec_IntAlloc(0);
+	lock_guard<mutex> lock(m_vPartLocks[iPart]); //Abc_NtkIf uses the pCopy fields of the part
+	m_vSubNtksMapped[iPart] = Abc_NtkIf(m_vSubNtks[iPart], pIfPars);
+	m_vpDsdOverlays[iPart] = pIfPars->pDsdMan;
+	if (fFirst)
+	{
+		m_vPartMapTime[iPart] = 1.0 * pIfPars->timeMapAll / CLOCKS_PER_SEC;
+		m_vPartCutsMerged[iPart] = pIfPars->nCutsMergedAll;
+		m_vPartCutsNodeMax[iPart] = Vec_IntSize(pIfPars->vCutCosts) ? Vec_IntFindMax(pIfPars->vCutCosts) : 0;
+		Vec_IntFree(pIfPars->vCutCosts);
+	}
+}
+
 void PartNtk::serialMap()
 {
 	struct timeval t1,t2;
 	double time;
 	ylog("Now in serialMap()\n");
-	for(int i = 0; i < m_nParts; i++)
+	for(auto i : m_vPartsToMap)
 	{
 		gettimeofday(&t1, NULL);
 
-		If_Par_t ifPars;
-		If_Par_t* pIfPars = &ifPars;
-		setIfPars(pIfPars);
-		m_vSubNtksMapped[i] = Abc_NtkIf(m_vSubNtks[i], pIfPars);
-		If_DsdManFree(pIfPars->pDsdMan, 0);
+		mapOnePart(i, i);
 
 		gettimeofday(&t2, NULL);
 	   	time = t2.tv_sec - t1.tv_sec + (t2.tv_usec - t1.tv_usec)/1000000.0;
 	   	printf("thread %d spent time: %f\n", i, time);
 	}
+	If_PifBoardCommit(m_pPifBoard);
+	mergeDsdOverlays();
+}
+
+//Timing at the boundary of a part as committed on the board: the global required
+//time, the arrival times of its cut-caused PIs and the required times of its cut-caused POs.
+vector<float> PartNtk::boundaryTiming(int iPart)
+{
+	vector<float> vTiming;
+	vTiming.push_back(m_pPifBoard->MaxReqTime);
+	for (auto iSlot : m_vvPifCiSlots[iPart])
+		if (iSlot >= 0)
+			vTiming.push_back(m_pPifBoard->pArrs[m_pPifBoard->pReq2Arr[iSlot]]);
+	for (auto iSlot : m_vvPifCoSlots[iPart])
+		if (iSlot >= 0)
+			vTiming.push_back(m_pPifBoard->pReqs[iSlot]);
+	return vTiming;
+}
+
+//All parts are mapped in the first round. After each round, only the parts whose
+//boundary timing changed are re-mapped, until the global delay does not change.
+//The result does not depend on scheduling: during a round a part only reads the
+//board and the DSD library as committed by the previous round, and writes its own
+//board slots and DSD overlay, which are folded in partition order after the round.
+void PartNtk::iterativeMap()
+{
+	struct timeval t1,t2;
+	double time;
+	gettimeofday(&t1, NULL);
+
+	m_vvBoundaryTiming.assign(m_nParts, vector<float>());
+	m_vPartsToMap.clear();
+	for (int i = 0; i < m_nParts; i++)
+	{
+		if (m_vPartReused.empty() || !m_vPartReused[i])
+		{
+			m_vPartsToMap.push_back(i);
+			continue;
+		}
+		//a reused part publishes the timing it had in the previous run
+		PifEcoCache::Part& part = m_pEcoCache->mParts.at(m_vPartFingerprints[i]);
+		If_PifBoardPublishPart(m_pPifBoard, i, part.delay, m_vvPifCoSlots[i].data(), part.vCoArrs.data(), part.vCoArrs.size());
+		m_vvBoundaryTiming[i] = boundaryTiming(i);
+	}
+	int delayPrev = -1;
+	for (int iter = 0; iter < max(1, (int)m_nIters); iter++)
+	{
+		if (m_nThreads > 1)
+			startThread();
+		else
+			serialMap();
+		int delay = m_pPifBoard->MaxReqTime;
+		ylog("Round %d: %d parts mapped, global delay = %d\n", iter, (int)m_vPartsToMap.size(), delay);
+		if (delay == delayPrev)
+			break;
+		delayPrev = delay;
+		m_vPartsToMap.clear();
+		for (int i = 0; i < m_nParts; i++)
+			if (boundaryTiming(i) != m_vvBoundaryTiming[i])
+				m_vPartsToMap.push_back(i);
+		if (m_vPartsToMap.empty())
+			break;
+	}
+
+	gettimeofday(&t2, NULL);
+   	time = t2.tv_sec - t1.tv_sec + (t2.tv_usec - t1.tv_usec)/1000000.0;
+   	printf("iterativeMap spent time: %f\n", time);
+}
+
+//Merge in partition order, so the shared library grows the same way for the same input.
+//The dsd_load manager is not grown, its overlays are only freed.
+void PartNtk::mergeDsdOverlays()
+{
+	int nObjsOld = If_DsdManObjNum(m_pDsdMan);
+	for (auto& pDsdMan : m_vpDsdOverlays)
+	{
+		if (pDsdMan == NULL)
+			continue;
+		if (!m_fDsdFromFrame)
+			If_DsdManMergeOverlay(m_pDsdMan, pDsdMan);
+		If_DsdManFree(pDsdMan, 0);
+		pDsdMan = NULL;
+	}
+	ylog("DSD library grows from %d to %d objs\n", nObjsOld, If_DsdManObjNum(m_pDsdMan));
+}
+
+string PartNtk::costModelFile()
+{
+	char* pDsdFile = If_DsdManFileName(m_pDsdMan);
+	return string(pDsdFile ? pDsdFile : "pif") + ".cost";
+}
+
+//The spread of the measured times shows how well the parts are balanced. With -C, every
+//part of an adaptive partition becomes a sample of the cost model, which is saved for later runs.
+void PartNtk::reportPartCosts()
+{
+	bool fFeatures = m_vPartCutLoads.size() == m_nParts;
+	double timeMax = 0, timeSum = 0;
+	for (int i = 0; i < m_nParts; i++)
+	{
+		int nNodes = Abc_NtkNodeNum(m_vSubNtks[i]);
+		ylog("Part %d: predicted %d, %d nodes, %d cuts merged (at most %d per node), mapped in %f (%.3f us per node)\n", i,
+			fFeatures ? m_vPartWorkloads[i] : -1, nNodes, m_vPartCutsMerged[i], m_vPartCutsNodeMax[i], m_vPartMapTime[i], nNodes ? 1e6 * m_vPartMapTime[i] / nNodes : 0.0);
+		timeMax = max(timeMax, m_vPartMapTime[i]);
+		timeSum += m_vPartMapTime[i];
+	}
+	if (m_nParts > 0 && timeSum > 0)
+		printf("Largest part maps in %.2f times the average part time\n", timeMax * m_nParts / timeSum);
+	if (!m_fCalibrate)
+		return;
+	if (!fFeatures)
+	{
+		printf("The cost model is calibrated on adaptive partitions only (no -N).\n");
+		return;
+	}
+	for (int i = 0; i < m_nParts; i++)
+		if (m_vPartMapTime[i] >= 0) //not reused with -E
+			m_costModel.addSample(m_vPartCutLoads[i], m_vPartNodes[i], 1e6 * m_vPartMapTime[i]);
+	if (!m_costModel.fit())
+	{
+		printf("The cost model cannot be fitted yet.\n");
+		return;
+	}
+	if (!m_costModel.save(costModelFile()))
+	{
+		printf("Cannot write the cost model into %s.\n", costModelFile().c_str());
+		return;
+	}
+	printf("Cost model %s: time(us) = %g * cutLoad + %g * nNodes (%d samples)\n", costModelFile().c_str(), m_costModel.a, m_costModel.b, m_costModel.nSamples);
 }
 
 void PartNtk::partOriginNtk()
@@ -127,39 +377,177 @@ void PartNtk::partOriginNtk()
 	double time;
 	gettimeofday(&t1, NULL);
 
-	if(m_nParts == 0)
+	if (m_pEcoCache)
+	{
+		m_ecoSettings = ecoSettings();
+		if (m_pEcoCache->nParts > 0 && m_pEcoCache->settings != m_ecoSettings)
+		{
+			printf("ECO: the DSD library or the options differ from the previous pif -E run, nothing is reused.\n");
+			m_pEcoCache->clear();
+		}
+	}
+	if(m_pEcoCache && m_pEcoCache->nParts > 0)
+	{
+		MetisGraph graph(m_pOriginNtk, 0);
+		graph.set_nThreads(m_nThreads);
+		graph.set_fringe(m_nFringe, If_DsdManVarNum(m_pDsdMan) - 1);
+		int32_t nReused = graph.reusePartition(m_pEcoCache->mNodeParts, m_pEcoCache->nParts);
+		m_nParts = m_pEcoCache->nParts;
+		ylog("ECO: %d of %d nodes keep their part, nParts = %d\n", nReused, graph.getNodeNum(), m_nParts);
+		init();
+		graph.createSubNtksFromPartition(m_vSubNtks, m_vvCiOrigins, m_vvCoOrigins);
+		graph.getPartition(m_mNodeParts);
+	}
+	else if(m_nParts == 0)
 	{
         	ylog("No nParts specified. Adaptive partitioning routine is used\n");
 		MetisGraph graph(m_pOriginNtk, 0);
 		graph.set_sCluster(m_sCluster);
+		graph.set_nThreads(m_nThreads);
+		graph.set_fringe(m_nFringe, If_DsdManVarNum(m_pDsdMan) - 1);
 		MetisAig aig;
 		aig.bindGraph(&graph);
+		if (m_costModel.load(costModelFile()))
+		{
+			ylog("Cost model %s: time(us) = %g * cutLoad + %g * nNodes (%d samples)\n", costModelFile().c_str(), m_costModel.a, m_costModel.b, m_costModel.nSamples);
+			aig.setCostModel(&m_costModel);
+		}
 		//aig.check();
 		aig.parseAig();
 		m_nParts = aig.partitionAig(); //The Graph is partitioned!
+		m_vPartWorkloads = aig.getPartWorkloads();
+		m_vPartCutLoads = aig.getPartCutLoads();
+		m_vPartNodes = aig.getPartNodes();
 		ylog("After adaptive routine, nParts = %d\n", m_nParts);
 		init(); //allocate memory for member vectors
-		graph.createSubNtksFromPartition(m_vSubNtks);
+		graph.createSubNtksFromPartition(m_vSubNtks, m_vvCiOrigins, m_vvCoOrigins);
+		if (m_pEcoCache)
+			graph.getPartition(m_mNodeParts);
 	}
-	/* comment metis by zli
 	else
 	{
 		ylog("nParts is set to %d\n", m_nParts);
 		MetisGraph graph(m_pOriginNtk, 1);
-		graph.partGraphByMetis(m_nParts);
-		graph.createSubNtksFromPartition(m_vSubNtks);
+		graph.set_nThreads(m_nThreads);
+		graph.set_fringe(m_nFringe, If_DsdManVarNum(m_pDsdMan) - 1);
+		graph.partGraphKway(m_nParts);
+		graph.createSubNtksFromPartition(m_vSubNtks, m_vvCiOrigins, m_vvCoOrigins);
+		if (m_pEcoCache)
+			graph.getPartition(m_mNodeParts);
 	}
-	*/
 
 
 	gettimeofday(&t2, NULL);
    	time = t2.tv_sec - t1.tv_sec + (t2.tv_usec - t1.tv_usec)/1000000.0;
    	printf("partOriginNtk spent time: %f\n", time);
 
-	//Output the partitioned network
-	Abc_NtkWriteVerilog();
+	m_vPartLocks = vector<mutex>(m_nParts);
+	findReusedParts();
+	initPifBoard();
+	startDump();
+}
+
+//A cut-caused PO is one boundary signal of the board, read by the cut-caused PIs
+//pointing to it. Each slot is written by one part only.
+void PartNtk::initPifBoard()
+{
+	int nArrSlots = 0;
+	vector<int> vReq2Arr;
+	m_vvPifCoSlots.assign(m_nParts, vector<int>());
+	m_vvPifCiSlots.assign(m_nParts, vector<int>());
+	for (int iPart = 0; iPart < m_nParts; iPart++)
+		for (auto& origin : m_vvCoOrigins[iPart])
+			m_vvPifCoSlots[iPart].push_back(origin.iCio == -1 ? nArrSlots++ : -1);
+	for (int iPart = 0; iPart < m_nParts; iPart++)
+		for (auto& origin : m_vvCiOrigins[iPart])
+		{
+			int iSlot = -1;
+			if (origin.iPart != -1 && origin.fCo)
+			{
+				iSlot = vReq2Arr.size();
+				vReq2Arr.push_back(m_vvPifCoSlots[origin.iPart][origin.iCio]);
+			}
+			m_vvPifCiSlots[iPart].push_back(iSlot);
+		}
+	if (m_pPifBoard)
+		If_PifBoardStop(m_pPifBoard);
+	m_pPifBoard = If_PifBoardStart(m_nParts, nArrSlots, vReq2Arr.size(), vReq2Arr.data());
+	ylog("Timing board: %d boundary signals, %d cut-caused PIs\n", nArrSlots, (int)vReq2Arr.size());
+}
+
+
+//Abc_NtkDup() does not copy the complemented edges of a logic network.
+static Abc_Ntk_t* Abc_NtkDupMapped(Abc_Ntk_t* pNtk)
+{
+	Abc_Obj_t* pObj;
+	int i;
+	Abc_Ntk_t* pNtkNew = Abc_NtkDup(pNtk);
+	Abc_NtkForEachObj(pNtk, pObj, i)
+		if (pObj->pCopy)
+		{
+			pObj->pCopy->fCompl0 = pObj->fCompl0;
+			pObj->pCopy->fCompl1 = pObj->fCompl1;
+		}
+	return pNtkNew;
+}
+
+//A part is reused if a part of the previous run had the same fingerprint. It is
+//not mapped, and keeps the timing it published then, see iterativeMap().
+void PartNtk::findReusedParts()
+{
+	if (m_pEcoCache == NULL)
+		return;
+	int nReused = 0;
+	m_vPartFingerprints.resize(m_nParts);
+	m_vPartReused.assign(m_nParts, 0);
+	for (int i = 0; i < m_nParts; i++)
+	{
+		m_vPartFingerprints[i] = Abc_NtkPifFingerprint(m_vSubNtks[i]);
+		auto it = m_pEcoCache->mParts.find(m_vPartFingerprints[i]);
+		if (it == m_pEcoCache->mParts.end())
+			continue;
+		yassert(Abc_NtkCiNum(it->second.pNtkMapped) == Abc_NtkCiNum(m_vSubNtks[i]));
+		yassert(Abc_NtkCoNum(it->second.pNtkMapped) == Abc_NtkCoNum(m_vSubNtks[i]));
+		m_vSubNtksMapped[i] = Abc_NtkDupMapped(it->second.pNtkMapped);
+		m_vPartReused[i] = 1;
+		nReused++;
+	}
+	ylog("ECO: %d of %d parts are reused from the previous run\n", nReused, m_nParts);
+}
+
+//The partition and the mapped parts can only be reused with the same library, LUT
+//size and options. The dsd_load manager is identified by its size, pif does not change it.
+string PartNtk::ecoSettings()
+{
+	char* pDsdFile = If_DsdManFileName(m_pDsdMan);
+	char Buffer[1000];
+	snprintf(Buffer, sizeof(Buffer), "%s:%d:%d N=%u s=%u F=%u I=%u", pDsdFile ? pDsdFile : "", If_DsdManVarNum(m_pDsdMan),
+		m_fDsdFromFrame ? If_DsdManObjNum(m_pDsdMan) : -1, m_nParts, m_sCluster, m_nFringe, m_nIters);
+	return string(Buffer);
 }
 
+//Keep what the next pif -E run needs. The committed board holds the delay of every
+//part and the arrival times of the cut-caused POs.
+void PartNtk::saveEcoCache()
+{
+	if (m_pEcoCache == NULL)
+		return;
+	m_pEcoCache->clear();
+	m_pEcoCache->settings = m_ecoSettings;
+	m_pEcoCache->nParts = m_nParts;
+	m_pEcoCache->mNodeParts.swap(m_mNodeParts);
+	for (int i = 0; i < m_nParts; i++)
+	{
+		if (m_vSubNtksMapped[i] == NULL || m_pEcoCache->mParts.count(m_vPartFingerprints[i]))
+			continue;
+		PifEcoCache::Part part;
+		part.pNtkMapped = Abc_NtkDupMapped(m_vSubNtksMapped[i]);
+		part.delay = m_pPifBoard->pPartDelays[i];
+		for (auto iSlot : m_vvPifCoSlots[i])
+			part.vCoArrs.push_back(iSlot >= 0 ? m_pPifBoard->pArrs[iSlot] : 0);
+		m_pEcoCache->mParts[m_vPartFingerprints[i]] = part;
+	}
+}
 
 void PartNtk::mergeMappedSubNtk()
 {
@@ -170,20 +558,15 @@ void PartNtk::mergeMappedSubNtk()
 	double time;
 	gettimeofday(&t1, NULL);
 
-	Vec_Ptr_t* pSubNtks;
 	Vec_Ptr_t* pSubNtksMapped;
-    pSubNtks = Vec_PtrAlloc( m_vSubNtks.size() );
     pSubNtksMapped = Vec_PtrAlloc( m_vSubNtksMapped.size() );
-	for(auto pNtk : m_vSubNtks)
-        Vec_PtrPush( pSubNtks, pNtk);
 	for(auto pNtk : m_vSubNtksMapped)
         Vec_PtrPush( pSubNtksMapped, pNtk);
 
-	m_pMappedNtk = Abc_NtkMerge(m_pOriginNtk, pSubNtks, pSubNtksMapped);
-	//m_pMappedNtk = Abc_NtkMerge(m_pOriginNtk, pSubNtks, pSubNtks);
+	m_pMappedNtk = Abc_NtkMerge(m_pOriginNtk, pSubNtksMapped, m_vvCiOrigins, m_vvCoOrigins);
+	if (m_pMappedNtk)
+		ylog("Mapped network signature: %08x\n", Abc_NtkPifSignature(m_pMappedNtk));
 
-
-	Vec_PtrFree(pSubNtks);
 	Vec_PtrFree(pSubNtksMapped);
 
 	gettimeofday(&t2, NULL);
@@ -213,69 +596,57 @@ void PartNtk::debug()
 }
 
 
-void PartNtk::Abc_NtkWriteBlif(){
-	
-	std::cout<<"Now in write blif!"<<endl;
-	const char* outputFolder = m_dirName;
-	
-	int i = 0;
-	//char *pFileNameOut = "output.blif";
-	for(auto pNtk : m_vSubNtks){
-
-		char filename[256];
-		snprintf(filename, sizeof(filename),"%s/network_%d.blif",outputFolder, i);
-		printf("Writing file: %s\n", filename);
-
-		Abc_Ntk_t* pNtkNew = Abc_NtkToNetlist(pNtk);
-		//cout<<"Now in iteration!"<<endl;
-
-		Io_WriteBlif(pNtkNew,filename,1,0,0);
-		i++;
-		
-	}
+//The partitions are written while the parts are mapped. A part is not written and
+//mapped at the same time, both use the pCopy fields of its objects.
+void PartNtk::startDump()
+{
+	if (m_dumpFormat.empty())
+		return;
+	waitDump();
+	m_dumpThread = thread([this]() {
+		struct timeval t1,t2;
+		double time;
+		gettimeofday(&t1, NULL);
+		for (int i = 0; i < m_nParts; i++)
+		{
+			lock_guard<mutex> lock(m_vPartLocks[i]);
+			dumpSubNtk(i);
+		}
+		gettimeofday(&t2, NULL);
+		time = t2.tv_sec - t1.tv_sec + (t2.tv_usec - t1.tv_usec)/1000000.0;
+		printf("Writing %d partitions spent time: %f\n", m_nParts, time);
+	});
 }
 
-void PartNtk::Abc_NtkWriteAIG(){
-	std::cout<<"Now in write AIG!"<<endl;
-	const char* outputFolder = m_dirName;
-	
-	int i = 0;
-	for(auto pNtk : m_vSubNtks){
-
-		char filename[256];
-		snprintf(filename, sizeof(filename),"%s/network_%d.aig",outputFolder, i);
-		printf("Writing file: %s\n", filename);
-
-		Abc_Ntk_t* pNtkNew = Abc_NtkToNetlist(pNtk);
-		Abc_NtkSetName(pNtkNew, const_cast<char*>(("network_" + to_string(i)).c_str()) );
-		//cout<<"Now in iteration!"<<endl;
-        Io_WriteAiger( pNtk, filename, 1, 0, 0 );
-		i++;	
-	}
+void PartNtk::waitDump()
+{
+	if (m_dumpThread.joinable())
+		m_dumpThread.join();
 }
 
-void PartNtk::Abc_NtkWriteVerilog(){
-	
-	std::cout<<"Now in write verilog!"<<endl;
-	const char* outputFolder = m_dirName;
-	
-	int i = 0;
-	for(auto pNtk : m_vSubNtks){
-
-		char filename[256];
-		snprintf(filename, sizeof(filename),"%s/network_%d.v",outputFolder, i);
-		printf("Writing file: %s\n", filename);
-
-		Abc_Ntk_t* pNtkNew = Abc_NtkToNetlist(pNtk);
-		Abc_NtkSetName(pNtkNew, const_cast<char*>(("network_" + to_string(i)).c_str()) );
-		//cout<<"Now in iteration!"<<endl;
-
+void PartNtk::dumpSubNtk(int iPart)
+{
+	Abc_Ntk_t* pNtk = m_vSubNtks[iPart];
+	char filename[256];
+	snprintf(filename, sizeof(filename), "%s/network_%d.%s", m_dirName, iPart, m_dumpFormat.c_str());
+	ylog("Writing file: %s\n", filename);
+	if (m_dumpFormat == "aig")
+	{
+		Io_WriteAiger(pNtk, filename, 1, 0, 0);
+		return;
+	}
+	Abc_Ntk_t* pNtkNew = Abc_NtkToNetlist(pNtk);
+	ABC_FREE(pNtkNew->pName);
+	Abc_NtkSetName(pNtkNew, Extra_UtilStrsav(("network_" + to_string(iPart)).c_str()));
+	if (m_dumpFormat == "blif")
+		Io_WriteBlif(pNtkNew, filename, 1, 0, 0);
+	else
+	{
 		if ( !Abc_NtkHasAig(pNtkNew) && !Abc_NtkHasMapping(pNtkNew) )
-            Abc_NtkToAig( pNtkNew );
-        Io_WriteVerilog( pNtkNew, filename, 0 );
-		i++;
-		
+			Abc_NtkToAig( pNtkNew );
+		Io_WriteVerilog( pNtkNew, filename, 0 );
 	}
+	Abc_NtkDelete(pNtkNew);
 }
 
 void PartNtk::Abc_NtkWriteMappedBlif(){
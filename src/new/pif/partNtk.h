@@ -1,13 +1,8 @@
 #pragma once
 
 #include "yaig.h"
-<<<<<<< HEAD
 #include "omp.h"
 #include "base/io/ioAbc.h"
-=======
-
-
->>>>>>> parent of 78fef875 (try Openmp!)
 extern "C" {
 #include "base/abc/abc.h"
 #include "map/if/if.h"
@@ -15,6 +10,7 @@ extern "C" {
 extern Abc_Ntk_t * Abc_NtkIf(Abc_Ntk_t * pNtk, If_Par_t * pPars);
 }
 #include "new/pif/partNtkFuncs.h"
+#include <deque>
 
 using std::vector;
 
@@ -26,28 +22,47 @@ class PartNtk
 public:
 	~PartNtk();
 	PartNtk(Abc_Ntk_t* pNtkOrigin, uint32_t nParts, char* libfile): 
-		m_nParts(nParts), m_pOriginNtk(pNtkOrigin){m_iMaxReqTime = 0; strcpy(m_pDsdLibFile, libfile); init();};
+		m_nParts(nParts), m_pOriginNtk(pNtkOrigin), m_pPifBoard(NULL), m_pDsdMan(NULL), m_nThreads(1), m_nIters(1){strcpy(m_pDsdLibFile, libfile); strcpy(m_dirName, "."); init();};
 	PartNtk(Abc_Ntk_t* pNtkOrigin, uint32_t nParts, uint32_t sCluster, char* libfile, char* dirName): 
-		m_nParts(nParts), m_pOriginNtk(pNtkOrigin), m_sCluster(sCluster){m_iMaxReqTime = 0; if (libfile != NULL) strcpy(m_pDsdLibFile, libfile);strcpy(m_dirName, dirName); init();};
+		m_nParts(nParts), m_pOriginNtk(pNtkOrigin), m_pPifBoard(NULL), m_pDsdMan(NULL), m_nThreads(1), m_nIters(1), m_sCluster(sCluster){m_pDsdLibFile[0] = '\0'; if (libfile != NULL) strcpy(m_pDsdLibFile, libfile); strcpy(m_dirName, dirName ? dirName : "."); init();};
 	void init();
+	bool loadDsdLib(); //get the DSD library shared by all threads
 	void setIfPars(If_Par_t* pIfPars, int threadId);
 	void setOriginNtk(Abc_Ntk_t* pNtk){ m_pOriginNtk = pNtk; m_pMappedNtk = NULL; }
 	Abc_Ntk_t* getResNtk(){ return m_pMappedNtk; }
 	uint32_t getNParts(){ return m_nParts; }
+	void setNThreads(uint32_t nThreads){ m_nThreads = nThreads; }
+	void setNIters(uint32_t nIters){ m_nIters = nIters; }
+	void setDumpFormat(const char* pFormat){ m_dumpFormat = pFormat ? pFormat : ""; }
+	void setCalibrate(bool fCalibrate){ m_fCalibrate = fCalibrate; }
+	void setFringe(uint32_t nFringe){ m_nFringe = nFringe; }
+	void setEcoCache(PifEcoCache* pCache){ m_pEcoCache = pCache; }
 	char* getLibFileName() { return m_pDsdLibFile; }
 
 	void partOriginNtk(); //generate m_vSubNtks
+	void initPifBoard(); //number the cut-caused PI/POs of m_vSubNtks
+	void findReusedParts(); //take the mapped parts of the previous pif -E run that did not change
+	void saveEcoCache();
+	string ecoSettings(); //what the parts of a pif -E run depend on besides the network
 	void mergeMappedSubNtk();
 	void serialMap();
+	void iterativeMap(); //re-map the parts whose boundary timing changed
+	vector<float> boundaryTiming(int iPart);
+	void mapOnePart(int iPart, int threadId);
+	void mergeDsdOverlays();
+	string costModelFile();
+	void reportPartCosts(); //compare the predicted and the measured cost of the parts, and refine the model with -C
 
 	static void threadWrapper(void*, int id);
 	void threadKernel(int id);
-	void startThread();
+	void startThread(); //map the parts on a pool of m_nThreads workers
+	bool popPart(int iWorker, int& iPart);
+
+	void startDump(); //write the partitions on a background thread
+	void waitDump();
+	void dumpSubNtk(int iPart);
 
 	void debug();
-	void Abc_NtkWriteBlif();
-	void Abc_NtkWriteVerilog();
-	void Abc_NtkWriteAIG();
 
 	void Abc_NtkWriteMappedBlif();
 
@@ -55,10 +70,41 @@ private:
 	uint32_t m_nParts;
 	Abc_Ntk_t* m_pOriginNtk;
 	Abc_Ntk_t* m_pMappedNtk; 
-	int m_iMaxReqTime;
+	If_PifBoard_t* m_pPifBoard; //timing exchanged between the parts
+	vector<vector<int>> m_vvPifCiSlots; //board slot of each CI of each part
+	vector<vector<int>> m_vvPifCoSlots; //board slot of each CO of each part
+	If_DsdMan_t* m_pDsdMan; //read-only while mapping, owned by the Abc frame
+	bool m_fDsdFromFrame = false; //m_pDsdMan is the dsd_load manager, which pif leaves unchanged
+	vector<If_DsdMan_t*> m_vpDsdOverlays; //per-thread DSD structures found during mapping
+	vector<int32_t> m_vPartWorkloads; //estimated workload of each part
+	vector<int32_t> m_vPartCutLoads; //cut load of each part, the input of the cost model
+	vector<int32_t> m_vPartNodes; //AND nodes of each part, the input of the cost model
+	vector<double> m_vPartMapTime; //thread CPU time of the first mapping of each part
+	vector<int> m_vPartCutsMerged; //cuts merged in the first mapping of each part
+	vector<int> m_vPartCutsNodeMax; //cuts merged at the costliest node in the first mapping of each part
+	PifCostModel m_costModel;
+	bool m_fCalibrate = false; //refine the cost model with the measured parts
+	uint32_t m_nFringe = 0; //levels of fanin logic copied across a cut edge, see MetisGraph::planSubNtks()
+	PifEcoCache* m_pEcoCache = NULL; //the previous pif -E run, updated by this one
+	string m_ecoSettings; //ecoSettings() before the partitioning changes m_nParts
+	unordered_map<uint64_t, int32_t> m_mNodeParts; //structural hash of each node -> its part
+	vector<uint64_t> m_vPartFingerprints; //see Abc_NtkPifFingerprint()
+	vector<char> m_vPartReused; //the mapping of the part is taken from m_pEcoCache
+	uint32_t m_nThreads;
+	uint32_t m_nIters; //max number of mapping rounds
+	vector<int> m_vPartsToMap; //parts mapped in the current round
+	vector<vector<float>> m_vvBoundaryTiming; //board values each part was last mapped with
+	vector<deque<int>> m_vQueues; //parts waiting in each worker, largest first
+	vector<mutex> m_vQueueLocks;
+	vector<double> m_vBusyTime; //time spent mapping by each worker
 	//vector<If_Par_t*> m_vpIfPars;
 	vector<Abc_Ntk_t*> m_vSubNtks; //remember to dealloc
 	vector<Abc_Ntk_t*> m_vSubNtksMapped; //remember to dealloc
+	vector<vector<CioOrigin>> m_vvCiOrigins; //origin of each CI of each part
+	vector<vector<CioOrigin>> m_vvCoOrigins; //origin of each CO of each part
+	vector<mutex> m_vPartLocks; //held while a part is mapped or dumped
+	string m_dumpFormat; //blif, aig or v; no dump if empty
+	thread m_dumpThread;
 	char m_pDsdLibFile[100];
 	char m_dirName[100];
 	uint32_t m_sCluster;
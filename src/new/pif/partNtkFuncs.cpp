@@ -7,6 +7,8 @@ MetisGraph::MetisGraph(Abc_Ntk_t* pNtk, bool fMetis)
 	yassert(Abc_NtkIsStrash(pNtk) && Abc_NtkHasAig(pNtk));
 	int32_t nNodes = Abc_NtkObjNum(pNtk) - Abc_NtkBoxNum(pNtk) - 1;
 
+	m_sCluster = 0;
+	m_nThreads = 1;
 	metisGraphInit(nNodes, fMetis);
 	createGraphFromNtk(pNtk, fMetis);
 }
@@ -23,6 +25,7 @@ void MetisGraph::metisGraphInit(int32_t nNodes, bool fMetis)
 	m_vPartition.resize(nNodes + 1, -1);
 	m_vpObjs.reserve(nNodes + 1);
 	m_vpObjsNew.reserve(nNodes + 1);
+	m_vCioIds.reserve(nNodes + 1);
 	m_vNodeIndices.push_back(0);
 
 	if(fMetis)
@@ -128,6 +131,7 @@ int MetisGraph::createGraphFromNtk(Abc_Ntk_t* pNtk, bool fMetis)
 		m_vNodeIsPi.push_back(true);
 		m_vpObjs.push_back(pObj);
 		m_vpObjsNew.push_back(NULL);
+		m_vCioIds.push_back(-1);
 		m_vNodeIndices.push_back(iEdgeEnd);
 		iEdgeBeg = iEdgeEnd;
 		m_nNodes++;
@@ -146,6 +150,7 @@ int MetisGraph::createGraphFromNtk(Abc_Ntk_t* pNtk, bool fMetis)
 			m_vNodeIsPi.push_back(true);
 			m_vpObjs.push_back(pObj);
 			m_vpObjsNew.push_back(NULL);
+			m_vCioIds.push_back(i);
 			m_vNodeIndices.push_back(iEdgeEnd);
 			iEdgeBeg = iEdgeEnd;
 			m_nPis++;
@@ -180,6 +185,7 @@ int MetisGraph::createGraphFromNtk(Abc_Ntk_t* pNtk, bool fMetis)
 		m_vNodeIsPi.push_back(false);
 		m_vpObjs.push_back(pObj);
 		m_vpObjsNew.push_back(NULL);
+		m_vCioIds.push_back(-1);
 		m_vNodeIndices.push_back(iEdgeEnd);
 		iEdgeBeg = iEdgeEnd;
 
@@ -207,6 +213,7 @@ int MetisGraph::createGraphFromNtk(Abc_Ntk_t* pNtk, bool fMetis)
 		m_vNodeIsPi.push_back(false);
 		m_vpObjs.push_back(pObj);
 		m_vpObjsNew.push_back(NULL);
+		m_vCioIds.push_back(i);
 		m_vNodeIndices.push_back(iEdgeEnd);
 		iEdgeBeg = iEdgeEnd;
 
@@ -224,6 +231,7 @@ int MetisGraph::createGraphFromNtk(Abc_Ntk_t* pNtk, bool fMetis)
 	yassert(m_nNodes == m_vNodeIsPi.size());
 	yassert(m_nNodes == m_vpObjs.size());
 	yassert(m_nNodes == m_vpObjsNew.size());
+	yassert(m_nNodes == m_vCioIds.size());
 	yassert(m_nNodes == iNode);
 //	yassert(m_nNodes == m_vNodeWeights.size());
 	
@@ -306,33 +314,206 @@ int MetisGraph::createGraphFromNtk(Abc_Ntk_t* pNtk, bool fMetis)
 	return 0;
 }
 
-/* comment metis by zli
-int MetisGraph::partGraphByMetis(int32_t nParts)
-{
-	idx_t options[METIS_NOPTIONS];
-	METIS_SetDefaultOptions(options); 
-	options[METIS_OPTION_CTYPE] = METIS_CTYPE_SHEM;
-	options[METIS_OPTION_IPTYPE] = METIS_IPTYPE_GROW;
-	//options[METIS_OPTION_NO2HOP] = 1;
-	options[METIS_OPTION_UFACTOR] = METIS_UFACTOR;
-	m_nParts = nParts;
+/**Function*************************************************************
 
-	struct timeval t1,t2;
-	double time;
-	gettimeofday(&t1, NULL);
+  Synopsis    [Plan the subnetworks of the partition.]
 
-	if(m_vEdgeWeights.empty() || m_vNodeWeights.empty() )
-		METIS_PartGraphKway(&m_nNodes, &m_nCon, &m_vNodeIndices[0], &m_vEdges[0], NULL, NULL, NULL, &m_nParts, NULL, NULL, NULL, &m_nCutEdges, &m_vPartition[0]);
-	else
-		METIS_PartGraphKway(&m_nNodes, &m_nCon, &m_vNodeIndices[0], &m_vEdges[0], &m_vNodeWeights[0], NULL, &m_vEdgeWeights[0], &m_nParts, NULL, NULL, options, &m_nCutEdges, &m_vPartition[0]);
+  Description [Walk the graph once in DFS order and fill, for every part, the list of its
+               nodes and the nodes driving its cut-caused POs. The CI/CO origins are final
+               after this step: the real CI/COs of a part come first, in graph order, then
+               the cut-caused PIs in the order of the cut edges, and the cut-caused POs in
+               the order of their first cut edge. Only integers are touched here.]
 
-	gettimeofday(&t2, NULL);
-   	time = t2.tv_sec - t1.tv_sec + (t2.tv_usec - t1.tv_usec)/1000000.0;
-   	printf("METIS spent time: %f\n", time);
-	Abc_Print(-2, "nedgecut = %d\n", m_nCutEdges);
-	return m_nCutEdges;
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+int MetisGraph::planSubNtks(vector<vector<CioOrigin>>& vvCiOrigins, vector<vector<CioOrigin>>& vvCoOrigins)
+{
+	int i, k, iFanin, ipart, ipartFanin, fUse;
+	int nCutEdgeFromPi = 0;
+	int nCutEdge = 0;
+	int nFringeEdge = 0, nFringePi = 0, nFringePo = 0;
+	vector<char> vCutSource;
+	set<pair<int32_t, int32_t>> sFringePis; //(part, node) of the fringe leaves read by a part
+
+	m_vCioIdsNew.assign(m_nNodes, -1);
+	m_vvPartNodes.assign(m_nParts, vector<int32_t>());
+	m_vvCutPoNodes.assign(m_nParts, vector<int32_t>());
+	vvCiOrigins.assign(m_nParts, vector<CioOrigin>());
+	vvCoOrigins.assign(m_nParts, vector<CioOrigin>());
+	for(i = 0; i < m_nNodes; i++)
+	{
+		ipart = m_vPartition[i];
+		if (ipart == -1)
+			continue;
+		m_vvPartNodes[ipart].push_back(i);
+		if (Abc_ObjIsCi(m_vpObjs[i]))
+		{
+			m_vCioIdsNew[i] = vvCiOrigins[ipart].size();
+			vvCiOrigins[ipart].push_back(CioOrigin(m_vCioIds[i], -1, false));
+		}
+		else if (Abc_ObjIsCo(m_vpObjs[i]))
+			vvCoOrigins[ipart].push_back(CioOrigin(m_vCioIds[i], -1, true));
+	}
+	if (m_nFringeLevels > 0)
+	{
+		m_vFringeIds.assign(m_nNodes, -1);
+		m_vFringeUse.assign(m_nNodes, 0);
+		m_vvFringeNodes.clear();
+		m_vvFringeLeaves.clear();
+		vCutSource.assign(m_nNodes, 0);
+		for(i = 0; i < m_nNodes; i++)
+			for(k = 0; !m_vNodeIsPi[i] && k < (isNodeAND(i) ? 2 : 1); k++)
+			{
+				iFanin = k ? getNodeFanin1Id(i) : getNodeFanin0Id(i);
+				if (iFanin < i && m_vPartition[iFanin] != m_vPartition[i])
+					vCutSource[iFanin] = 1;
+			}
+	}
+	//DFS order is expected.
+	for(i = 0; i < m_nNodes; i++)
+	{
+		if (m_vNodeIsPi[i])
+			continue;
+		ipart = m_vPartition[i];
+		fUse = m_nFringeLevels > 0 ? planFringeUse(i, vCutSource) : 0;
+		for(k = 0; k < (isNodeAND(i) ? 2 : 1); k++)
+		{
+			iFanin = k ? getNodeFanin1Id(i) : getNodeFanin0Id(i);
+			ipartFanin = m_vPartition[iFanin];
+			if (iFanin >= i || ipartFanin == -1)
+			{
+				Abc_Print(-1, "The AIG Nodes in metis array are expected to be in DFS order.\n ");
+				return 1;
+			}
+			if (ipartFanin == ipart)
+				continue;
+			nCutEdge++;
+			if ((fUse >> k) & 1) //the fanin is rebuilt from the leaves of its fringe, each read once by the part
+			{
+				nFringeEdge++;
+				for(auto iLeaf : m_vvFringeLeaves[m_vFringeIds[iFanin]])
+				{
+					int ipartLeaf = m_vPartition[iLeaf];
+					if (ipartLeaf == ipart || !sFringePis.insert(make_pair(ipart, iLeaf)).second)
+						continue;
+					nFringePi++;
+					if (!Abc_ObjIsCi(m_vpObjs[iLeaf]) && m_vCioIdsNew[iLeaf] == -1)
+					{
+						nFringePo++;
+						m_vCioIdsNew[iLeaf] = vvCoOrigins[ipartLeaf].size();
+						vvCoOrigins[ipartLeaf].push_back(CioOrigin(-1, -1, true));
+						m_vvCutPoNodes[ipartLeaf].push_back(iLeaf);
+					}
+					vvCiOrigins[ipart].push_back(CioOrigin(m_vCioIdsNew[iLeaf], ipartLeaf, !Abc_ObjIsCi(m_vpObjs[iLeaf])));
+				}
+				continue;
+			}
+			if (Abc_ObjIsCi(m_vpObjs[iFanin])) //when the Ci has a fanout edge that is cut, don't generate cut-caused PO
+				nCutEdgeFromPi++;
+			else if (m_vCioIdsNew[iFanin] == -1) //the cut-caused PO is shared by all cut edges of the node
+			{
+				m_vCioIdsNew[iFanin] = vvCoOrigins[ipartFanin].size();
+				vvCoOrigins[ipartFanin].push_back(CioOrigin(-1, -1, true));
+				m_vvCutPoNodes[ipartFanin].push_back(iFanin);
+			}
+			vvCiOrigins[ipart].push_back(CioOrigin(m_vCioIdsNew[iFanin], ipartFanin, !Abc_ObjIsCi(m_vpObjs[iFanin])));
+		}
+	}
+	ylog("Total number of CIs with cut fanout edges: %d\n", nCutEdgeFromPi);
+	ylog("Total number of cut edges: %d\n", nCutEdge);
+	if (m_nFringeLevels > 0)
+		ylog("Fringes of %d levels: %d cut edges read through %d fringes, %d leaf PIs, %d extra cut-caused POs\n", m_nFringeLevels, nFringeEdge, (int)m_vvFringeNodes.size(), nFringePi, nFringePo);
+	return 0;
+}
+
+//Grow the fanin cone of iNode inside its part, level by level, while it has at most
+//m_nFringeLeaves leaves. Its leaves are CIs, nodes of other parts and nodes read by
+//other parts, which have a cut-caused PO anyway: exporting a private node instead
+//forces a LUT root on the owner and costs more than the packing gains. The fringe
+//does not depend on the part reading it, so it is planned once.
+int32_t MetisGraph::planFringe(int32_t iNode, const vector<char>& vCutSource)
+{
+	if (m_vFringeIds[iNode] != -1)
+		return m_vFringeIds[iNode];
+	int32_t ipart = m_vPartition[iNode];
+	vector<int32_t> vNodes, vLeaves(1, iNode), vFront(1, iNode), vNext;
+	for(int32_t iLevel = 0; iLevel < m_nFringeLevels && !vFront.empty(); iLevel++)
+	{
+		vNext.clear();
+		for(auto iObj : vFront)
+		{
+			if (!isNodeAND(iObj) || m_vPartition[iObj] != ipart || (iObj != iNode && vCutSource[iObj]))
+				continue;
+			auto it = find(vLeaves.begin(), vLeaves.end(), iObj);
+			if (it == vLeaves.end()) //already expanded
+				continue;
+			int32_t vFanins[2] = {getNodeFanin0Id(iObj), getNodeFanin1Id(iObj)};
+			int32_t nLeaves = vLeaves.size() - 1;
+			bool fPrivate = false; //a leaf nobody else reads would need a cut-caused PO of its own
+			for(auto iFanin : vFanins)
+				if (find(vLeaves.begin(), vLeaves.end(), iFanin) == vLeaves.end() && find(vNodes.begin(), vNodes.end(), iFanin) == vNodes.end())
+				{
+					nLeaves++;
+					fPrivate |= isNodeAND(iFanin) && m_vPartition[iFanin] == ipart && !vCutSource[iFanin];
+				}
+			if (nLeaves > m_nFringeLeaves || fPrivate)
+				continue;
+			vLeaves.erase(it);
+			vNodes.push_back(iObj);
+			for(auto iFanin : vFanins)
+				if (find(vLeaves.begin(), vLeaves.end(), iFanin) == vLeaves.end() && find(vNodes.begin(), vNodes.end(), iFanin) == vNodes.end())
+				{
+					vLeaves.push_back(iFanin);
+					vNext.push_back(iFanin);
+				}
+		}
+		swap(vFront, vNext);
+	}
+	if (vNodes.empty())
+		vLeaves.clear();
+	sort(vNodes.begin(), vNodes.end());
+	sort(vLeaves.begin(), vLeaves.end());
+	m_vFringeIds[iNode] = m_vvFringeNodes.size();
+	m_vvFringeNodes.push_back(vNodes);
+	m_vvFringeLeaves.push_back(vLeaves);
+	return m_vFringeIds[iNode];
+}
+
+//Which fanins of iNode are read through their fringe. The nodes of a fringe are never
+//roots of a cut (see Abc_NtkToIf()), so every cut of a fringe is made of its leaves, and
+//the node keeps a feasible cut as long as the leaves of its fringe fanins and its other
+//fanins fit into one LUT. A fringe reaching an AND node of the part itself is not used,
+//as the cuts of that node are not bounded by the fringe.
+int MetisGraph::planFringeUse(int32_t iNode, const vector<char>& vCutSource)
+{
+	int k, fUse = 0;
+	int32_t vSizes[2] = {1, 1};
+	if (!isNodeAND(iNode))
+		return 0;
+	for(k = 0; k < 2; k++)
+	{
+		int32_t iFanin = k ? getNodeFanin1Id(iNode) : getNodeFanin0Id(iNode);
+		if (m_vPartition[iFanin] == m_vPartition[iNode] || !isNodeAND(iFanin))
+			continue;
+		int32_t iFringe = planFringe(iFanin, vCutSource);
+		if (m_vvFringeNodes[iFringe].empty())
+			continue;
+		bool fOwnNode = false;
+		for(auto iLeaf : m_vvFringeLeaves[iFringe])
+			fOwnNode |= m_vPartition[iLeaf] == m_vPartition[iNode] && isNodeAND(iLeaf);
+		if (fOwnNode)
+			continue;
+		fUse |= 1 << k;
+		vSizes[k] = m_vvFringeLeaves[iFringe].size();
+	}
+	if (vSizes[0] + vSizes[1] > m_nFringeLeaves + 1)
+		fUse &= vSizes[0] <= vSizes[1] ? 1 : 2;
+	m_vFringeUse[iNode] = fUse;
+	return fUse;
 }
-*/
 
 /**Function*************************************************************
 
@@ -348,15 +529,11 @@ int MetisGraph::partGraphByMetis(int32_t nParts)
 Abc_Ntk_t* MetisGraph::initOneSubNtk(int index)
 {
 	Abc_Ntk_t *pNtkNew;
-	Abc_Obj_t *pObj;
-	int i, ipart;
-	// int fCopyNames;
+	Abc_Obj_t *pObj, *pObjNew = NULL;
 
 	if (m_pNtkOrigin == NULL)
 		return NULL;
 	yassert(index >= 0 && index < m_nParts);
-	// decide whether to copy the names
-	// fCopyNames = (pNtk->ntkType != ABC_NTK_NETLIST);
 	
 	// start the network
 	pNtkNew = Abc_NtkAlloc(m_pNtkOrigin->ntkType, m_pNtkOrigin->ntkFunc, 1);
@@ -371,35 +548,34 @@ Abc_Ntk_t* MetisGraph::initOneSubNtk(int index)
 	pNtkNew->pName = Extra_UtilStrsav(m_pNtkOrigin->pName);
 	pNtkNew->pSpec = Extra_UtilStrsav(m_pNtkOrigin->pSpec);
 	// clone CI/CO Nodes
-	for(i = 0; i < m_nNodes; i++)
+	for(auto i : m_vvPartNodes[index])
 	{
-		ipart = m_vPartition[i];
-		if (ipart != index)
-			continue;
 		pObj = m_vpObjs[i];
 		if (Abc_ObjType(pObj) == ABC_OBJ_NODE)
 			continue;
-		//yassert( pObj->iTemp == i );
 		if (Abc_ObjType(pObj) == ABC_OBJ_CONST1)
-			pObj->pCopy = Abc_AigConst1(pNtkNew);
+			pObjNew = Abc_AigConst1(pNtkNew);
 		else if ( Abc_ObjIsCi(pObj) )
 		{
-			pObj->pCopy = Abc_NtkCreatePi(pNtkNew);
-			Abc_ObjAssignName( pObj->pCopy, Abc_ObjName(pObj), NULL);
+			pObjNew = Abc_NtkCreatePi(pNtkNew);
+			Abc_ObjAssignName( pObjNew, Abc_ObjName(pObj), NULL);
 			yassert(pObj->Level == 0);
-			pObj->pCopy->Level = pObj->Level;
+			pObjNew->Level = pObj->Level;
 		}
 		else if ( Abc_ObjIsCo(pObj))
 		{
-			pObj->pCopy = Abc_NtkCreatePo(pNtkNew);
-			Abc_ObjAssignName( pObj->pCopy, Abc_ObjName(pObj), NULL);				
+			pObjNew = Abc_NtkCreatePo(pNtkNew);
+			Abc_ObjAssignName( pObjNew, Abc_ObjName(pObj), NULL);				
 		}
 		else 
+		{
 			yassert(0);
-		pObj->pCopy->fCompl0 = pObj->fCompl0;
-		pObj->pCopy->fCompl1 = pObj->fCompl1;
+			continue;
+		}
+		pObjNew->fCompl0 = pObj->fCompl0;
+		pObjNew->fCompl1 = pObj->fCompl1;
 		//store the newly created AbcObj for corresponding node in Metis graph
-		m_vpObjsNew[i] = pObj->pCopy;
+		m_vpObjsNew[i] = pObjNew;
 	}
 	Abc_ManTimeDup( m_pNtkOrigin, pNtkNew );
     pNtkNew->AndGateDelay = m_pNtkOrigin->AndGateDelay;
@@ -411,166 +587,269 @@ Abc_Ntk_t* MetisGraph::initOneSubNtk(int index)
 	return pNtkNew;
 }
 
+//Abc_ObjName() of an unnamed object returns a static buffer, which the workers cannot share.
+static void assignTempName(Abc_Obj_t* pObj)
+{
+	char Buffer[100];
+	int i;
+	sprintf(Buffer, "n%d", pObj->Id);
+	for (i = 1; Nm_ManFindIdByName(pObj->pNtk->pManName, Buffer, -1) != -1; i++)
+		sprintf(Buffer, "n%d_%d", pObj->Id, i);
+	Abc_ObjAssignName(pObj, Buffer, NULL);
+}
+
 /**Function*************************************************************
 
-  Synopsis    [Generate subnetworks using hmetis partition results.]
+  Synopsis    [Build one subnetwork from the plan.]
 
-  Description [Create internal AND nodes and new PI/PO pairs for edges that straddle different partitions in DFS order(original pMetis->AbcObj order). Finish the connections as well.]
+  Description [Touches only the nodes of the part (and their entries in m_vpObjsNew), so
+               the parts can be built concurrently. Each subnetwork allocates its objects
+               from its own memory managers. The pData of the cut-caused PIs, which point
+               into other parts, is filled in by createSubNtksFromPartition().]
 
   SideEffects []
 
   SeeAlso     []
 
 ***********************************************************************/
-int MetisGraph::createSubNtksFromPartition(vector<Abc_Ntk_t*>& vSubNtks)
+Abc_Ntk_t* MetisGraph::extractOneSubNtk(int index)
 {
-	Abc_Obj_t *pObj, *pFanin0, *pFanin1, *pFanout;
-	Abc_Obj_t *pObjNew, *pPiNew, *pPoNew;
 	Abc_Ntk_t *pNtk;
-	int iFanin0, iFanin1, ipart, ipart0, ipart1;
-	int i, j;
-	cout << "vSubNtks.size() is " << vSubNtks.size() << " , m_nParts is " << m_nParts << endl;
-
+	Abc_Obj_t *pObj, *pFanin0, *pFanin1, *pObjNew;
+	int iFanin0, iFanin1;
+	unordered_map<int32_t, Abc_Obj_t*> mReplicas, mLeaves; //fringe root -> its copy, fringe leaf -> its PI
 
-	yassert(vSubNtks.size() == m_nParts);
-	int nCutEdgeFromPi = 0;
-	int nCutEdge= 0;
-
-	for(i = 0; i < vSubNtks.size(); i++)
-	{
-		vSubNtks[i] = initOneSubNtk(i);
-	}
-
-	//DFS order is expected.
-	for(i = 0; i < m_vpObjs.size(); i++)
+	pNtk = initOneSubNtk(index);
+	for(auto i : m_vvPartNodes[index])
 	{
 		pObj = m_vpObjs[i];
-		if (Abc_ObjIsCi(pObj) || pObj->Type == ABC_OBJ_CONST1)
+		if (m_vNodeIsPi[i])
 			continue;
-		ipart = m_vPartition[i];
-		pNtk = vSubNtks[ipart];//the pSubNtk that the current pObj belongs to
 
 		//check fanin0 for CO and And nodes
 		iFanin0 = getNodeFanin0Id(i);
-		pFanin0 = m_vpObjsNew[iFanin0]; //pObj in pSubNtk
-		if (pFanin0 == NULL)
+		if (m_nFringeLevels > 0 && (m_vFringeUse[i] & 1))
+			pFanin0 = replicateFringe(pNtk, index, iFanin0, mReplicas, mLeaves);
+		else if (m_vPartition[iFanin0] != index) //cut edge found!
 		{
-			Abc_Print(-1, "The AIG Nodes in metis array are expected to be in DFS order.\n ");
-			return 1;
-		}
-		ipart0 = m_vPartition[iFanin0];
-		if (ipart0 != ipart) //cut edge found!
-		{
-			nCutEdge++;
-			if(Abc_ObjIsPi(pFanin0)) //when the Ci has a fanout edge that is cut, don't generate cut-caused PO
-			{
-				nCutEdgeFromPi++;
-				pPiNew = Abc_NtkCreatePi(pNtk);
-				Abc_ObjAssignName(pPiNew, Abc_ObjName(pPiNew), NULL);
-				pPiNew->fMarkA = 1;
-				pPiNew->pData = pFanin0; //map the cut-caused PI to the corresponding PO
-				pFanin0 = pPiNew;		//point the pFanin0 to the corresponding fanin pObj in the same pSubNtk
-			}
-			else
-			{
-				pPoNew = NULL;
-				Abc_ObjForEachFanout(pFanin0, pFanout, j)
-				{
-					//If cut-caused PO already exists, use it directly, avoiding duplication.
-					if (Abc_ObjIsPo(pFanout) && pFanout->fMarkA == 1)
-					{
-						pPoNew = pFanout;
-						break;
-					}
-				}
-				if (pPoNew == NULL) //create a new cut-caused PO
-				{
-					pPoNew = Abc_NtkCreatePo(vSubNtks[ipart0]);
-					Abc_ObjAssignName(pPoNew, Abc_ObjName(pPoNew), NULL); //assign a temporary name
-					pPoNew->fMarkA = 1;									  //mark as cut-caused PO
-					Abc_ObjAddFanin(pPoNew, pFanin0);
-				}
-				pPiNew = Abc_NtkCreatePi(pNtk);
-				Abc_ObjAssignName(pPiNew, Abc_ObjName(pPiNew), NULL);
-				pPiNew->fMarkA = 1;
-				pPiNew->pData = pPoNew; //map the cut-caused PI to the corresponding PO
-				pFanin0 = pPiNew;		//point the pFanin0 to the corresponding fanin pObj in the same pSubNtk
-			}
-
+			pFanin0 = Abc_NtkCreatePi(pNtk);
+			assignTempName(pFanin0);
+			pFanin0->fMarkA = 1;
 		}
+		else
+			pFanin0 = m_vpObjsNew[iFanin0]; //pObj in pSubNtk
 		if (Abc_ObjIsCo(pObj))
 		{
-			pObjNew = m_vpObjsNew[i]; //pObjNew of CI/CO in pSubNtk has been added in Abc_SubNtkStartFrom()
+			pObjNew = m_vpObjsNew[i]; //pObjNew of CI/CO in pSubNtk has been added in initOneSubNtk()
 			yassert(pObjNew != NULL);
 			Abc_ObjAddFanin(pObjNew, pFanin0); //Connect
+			continue;
 		}
-		else if (Abc_ObjIsNode(pObj))
+		yassert(Abc_ObjIsNode(pObj));
+		iFanin1 = getNodeFanin1Id(i);
+		if (m_nFringeLevels > 0 && (m_vFringeUse[i] & 2))
+			pFanin1 = replicateFringe(pNtk, index, iFanin1, mReplicas, mLeaves);
+		else if (m_vPartition[iFanin1] != index)
 		{
-			//fanin1
-			iFanin1 = getNodeFanin1Id(i);
-			pFanin1 = m_vpObjsNew[iFanin1]; //pObj in pSubNtk. In DFS, fanin should have been processed
-			yassert(pFanin1);
-			if (pFanin1 == NULL)
-			{
-				Abc_Print(-1, "The AIG Nodes in metis array are expected to be in DFS order.\n ");
-				return 1;
-			}
-			ipart1 = m_vPartition[iFanin1];
-			if (ipart1 != ipart)
-			{
-				nCutEdge++;
-				if(Abc_ObjIsPi(pFanin1)) //when the Ci has a fanout edge that is cut, don't generate cut-caused PO
-				{
-					nCutEdgeFromPi++;
-					pPiNew = Abc_NtkCreatePi(pNtk);
-					Abc_ObjAssignName(pPiNew, Abc_ObjName(pPiNew), NULL);
-					pPiNew->fMarkA = 1;
-					pPiNew->pData = pFanin1; //map the cut-caused PI to the corresponding PO
-					pFanin1 = pPiNew;		//point the pFanin0 to the corresponding fanin pObj in the same pSubNtk
-				}
-				else
-				{
-					pPoNew = NULL;
-					Abc_ObjForEachFanout(pFanin1, pFanout, j)
-					{
-						if (Abc_ObjIsPo(pFanout) && pFanout->fMarkA == 1)
-						{
-							pPoNew = pFanout;
-							break;
-						}
-					}
-					if (pPoNew == NULL)
-					{
-						pPoNew = Abc_NtkCreatePo(vSubNtks[ipart1]);
-						Abc_ObjAssignName(pPoNew, Abc_ObjName(pPoNew), NULL);
-						pPoNew->fMarkA = 1;
-						Abc_ObjAddFanin(pPoNew, pFanin1);
-					}
-					pPiNew = Abc_NtkCreatePi(pNtk);
-					Abc_ObjAssignName(pPiNew, Abc_ObjName(pPiNew), NULL);
-					pPiNew->fMarkA = 1;
-					pPiNew->pData = pPoNew;
-					pFanin1 = pPiNew;
-				}
-			}
-
-			pObjNew = Abc_AigAnd(static_cast<Abc_Aig_t*>(pNtk->pManFunc), Abc_ObjNotCond(pFanin0, isNodeFanin0C(i)), Abc_ObjNotCond(pFanin1, isNodeFanin1C(i)));
-
-			m_vpObjsNew[i] = pObjNew;
-			pObj->pCopy = pObjNew;
+			pFanin1 = Abc_NtkCreatePi(pNtk);
+			assignTempName(pFanin1);
+			pFanin1->fMarkA = 1;
 		}
 		else
-			yassert(0);
+			pFanin1 = m_vpObjsNew[iFanin1];
+		m_vpObjsNew[i] = Abc_AigAnd(static_cast<Abc_Aig_t*>(pNtk->pManFunc), Abc_ObjNotCond(pFanin0, isNodeFanin0C(i)), Abc_ObjNotCond(pFanin1, isNodeFanin1C(i)));
 	}
+	for(auto i : m_vvCutPoNodes[index])
+	{
+		pObjNew = Abc_NtkCreatePo(pNtk);
+		assignTempName(pObjNew);
+		pObjNew->fMarkA = 1; //mark as cut-caused PO
+		Abc_ObjAddFanin(pObjNew, m_vpObjsNew[i]);
+	}
+	return pNtk;
+}
 
-	
-	ylog("Total number of CIs with cut fanout edges: %d\n", nCutEdgeFromPi);
-	ylog("Total number of cut edges: %d\n", nCutEdge);
+//Copy the fringe of iNode into the part, once. The copies are marked with fMarkB, so
+//that the mapper does not make them roots of a LUT: the logic stays with the part owning
+//it, and the part reading the fringe only packs it into the LUTs of its own nodes.
+Abc_Obj_t* MetisGraph::replicateFringe(Abc_Ntk_t* pNtk, int index, int32_t iNode, unordered_map<int32_t, Abc_Obj_t*>& mReplicas, unordered_map<int32_t, Abc_Obj_t*>& mLeaves)
+{
+	Abc_Obj_t *pObj, *pFanin0, *pFanin1;
+	auto it = mReplicas.find(iNode);
+	if (it != mReplicas.end())
+		return it->second;
+	const vector<int32_t>& vNodes = m_vvFringeNodes[m_vFringeIds[iNode]];
+	for(auto iLeaf : m_vvFringeLeaves[m_vFringeIds[iNode]])
+	{
+		if (m_vPartition[iLeaf] == index)
+			mLeaves[iLeaf] = m_vpObjsNew[iLeaf];
+		else if (mLeaves.find(iLeaf) == mLeaves.end()) //the same order as in planSubNtks()
+		{
+			pObj = Abc_NtkCreatePi(pNtk);
+			assignTempName(pObj);
+			pObj->fMarkA = 1;
+			mLeaves[iLeaf] = pObj;
+		}
+	}
+	//a node shared with another fringe is merged by strashing
+	unordered_map<int32_t, Abc_Obj_t*> mCopies;
+	for(auto i : vNodes)
+	{
+		int32_t iFanin0 = getNodeFanin0Id(i), iFanin1 = getNodeFanin1Id(i);
+		pFanin0 = binary_search(vNodes.begin(), vNodes.end(), iFanin0) ? mCopies[iFanin0] : mLeaves[iFanin0];
+		pFanin1 = binary_search(vNodes.begin(), vNodes.end(), iFanin1) ? mCopies[iFanin1] : mLeaves[iFanin1];
+		int nObjs = Abc_NtkObjNumMax(pNtk);
+		pObj = Abc_AigAnd(static_cast<Abc_Aig_t*>(pNtk->pManFunc), Abc_ObjNotCond(pFanin0, isNodeFanin0C(i)), Abc_ObjNotCond(pFanin1, isNodeFanin1C(i)));
+		if (Abc_ObjRegular(pObj)->Id >= nObjs)
+			Abc_ObjRegular(pObj)->fMarkB = 1;
+		mCopies[i] = pObj;
+	}
+	yassert(!vNodes.empty() && vNodes.back() == iNode);
+	return mReplicas[iNode] = mCopies[iNode];
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Generate subnetworks using hmetis partition results.]
+
+  Description [Create internal AND nodes and new PI/PO pairs for edges that straddle different partitions in DFS order(original pMetis->AbcObj order). Finish the connections as well.
+               vvCiOrigins/vvCoOrigins record, for every CI/CO of every subnetwork, where it comes from.
+               The subnetworks are built on m_nThreads workers after a serial planning pass.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+int MetisGraph::createSubNtksFromPartition(vector<Abc_Ntk_t*>& vSubNtks, vector<vector<CioOrigin>>& vvCiOrigins, vector<vector<CioOrigin>>& vvCoOrigins)
+{
+	Abc_Obj_t *pObj;
+	int i, j;
+	struct timeval t1,t2;
+	double time;
+	cout << "vSubNtks.size() is " << vSubNtks.size() << " , m_nParts is " << m_nParts << endl;
+
+	yassert(vSubNtks.size() == m_nParts);
+	gettimeofday(&t1, NULL);
+	if (planSubNtks(vvCiOrigins, vvCoOrigins))
+		return 1;
+
+	atomic<int> iNext(0);
+	auto worker = [&]() {
+		for (int iPart = iNext++; iPart < m_nParts; iPart = iNext++)
+			vSubNtks[iPart] = extractOneSubNtk(iPart);
+	};
+	int nWorkers = max(1, min((int)m_nThreads, m_nParts));
+	vector<thread> vThreads;
+	for (i = 1; i < nWorkers; i++)
+		vThreads.push_back(thread(worker));
+	worker();
+	for (auto& th : vThreads)
+		th.join();
+
+	//link the cut-caused PIs to the CO (or CI) they are cut from
+	for(i = 0; i < vSubNtks.size(); i++)
+	{
+		yassert(vvCiOrigins[i].size() == Abc_NtkCiNum(vSubNtks[i]));
+		yassert(vvCoOrigins[i].size() == Abc_NtkCoNum(vSubNtks[i]));
+		Abc_NtkForEachCi(vSubNtks[i], pObj, j)
+		{
+			const CioOrigin& origin = vvCiOrigins[i][j];
+			if (origin.iPart == -1)
+				continue;
+			yassert(pObj->fMarkA);
+			pObj->pData = origin.fCo ? Abc_NtkCo(vSubNtks[origin.iPart], origin.iCio) : Abc_NtkCi(vSubNtks[origin.iPart], origin.iCio);
+		}
+	}
+	gettimeofday(&t2, NULL);
+	time = t2.tv_sec - t1.tv_sec + (t2.tv_usec - t1.tv_usec)/1000000.0;
+	printf("createSubNtksFromPartition with %d workers spent time: %f\n", nWorkers, time);
 
 	return 0;
 }
 
 
+static inline uint64_t Abc_EcoHashMix(uint64_t Hash, uint64_t Value)
+{
+	Hash ^= Value + 0x9e3779b97f4a7c15ull + (Hash << 6) + (Hash >> 2);
+	return Hash * 0xff51afd7ed558ccdull;
+}
+
+//CIs and COs are known by their names, AND nodes by their fanins regardless of their order.
+vector<uint64_t> MetisGraph::nodeHashes()
+{
+	vector<uint64_t> vHashes(m_nNodes, 0);
+	for(int32_t i = 0; i < m_nNodes; i++)
+	{
+		if (m_vNodeIsPi[i])
+		{
+			vHashes[i] = Abc_EcoHashMix(1, hash<string>()(Abc_ObjName(m_vpObjs[i])));
+			continue;
+		}
+		uint64_t hash0 = Abc_EcoHashMix(vHashes[getNodeFanin0Id(i)], isNodeFanin0C(i));
+		if (!isNodeAND(i))
+		{
+			vHashes[i] = Abc_EcoHashMix(Abc_EcoHashMix(2, hash<string>()(Abc_ObjName(m_vpObjs[i]))), hash0);
+			continue;
+		}
+		uint64_t hash1 = Abc_EcoHashMix(vHashes[getNodeFanin1Id(i)], isNodeFanin1C(i));
+		vHashes[i] = Abc_EcoHashMix(Abc_EcoHashMix(3, min(hash0, hash1)), max(hash0, hash1));
+	}
+	return vHashes;
+}
+
+void MetisGraph::getPartition(unordered_map<uint64_t, int32_t>& mNodeParts)
+{
+	vector<uint64_t> vHashes = nodeHashes();
+	mNodeParts.clear();
+	mNodeParts.reserve(m_nNodes);
+	for(int32_t i = 0; i < m_nNodes; i++)
+		if (m_vPartition[i] != -1)
+			mNodeParts[vHashes[i]] = m_vPartition[i];
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Partition the graph like an earlier version of it.]
+
+  Description [A node found in mNodeParts stays in its part. A new node goes
+               to the part of one of its fanouts, or of its fanin0 if none of
+               them is placed, so an ECO changes only the parts it touches.
+               Returns the number of nodes that kept their part.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+int32_t MetisGraph::reusePartition(const unordered_map<uint64_t, int32_t>& mNodeParts, int32_t nParts)
+{
+	int32_t i, k, nReused = 0;
+	vector<uint64_t> vHashes = nodeHashes();
+	m_nParts = nParts;
+	m_vPartition.assign(m_nNodes, -1);
+	for(i = 0; i < m_nNodes; i++)
+	{
+		auto it = mNodeParts.find(vHashes[i]);
+		if (it == mNodeParts.end() || it->second >= nParts)
+			continue;
+		m_vPartition[i] = it->second;
+		nReused++;
+	}
+	//fanouts come after their fanins
+	for(i = m_nNodes - 1; i >= 0; i--)
+		for(k = 0; m_vPartition[i] != -1 && !m_vNodeIsPi[i] && k < (isNodeAND(i) ? 2 : 1); k++)
+		{
+			int32_t iFanin = k ? getNodeFanin1Id(i) : getNodeFanin0Id(i);
+			if (m_vPartition[iFanin] == -1)
+				m_vPartition[iFanin] = m_vPartition[i];
+		}
+	for(i = 0; i < m_nNodes; i++)
+		if (m_vPartition[i] == -1)
+			m_vPartition[i] = m_vNodeIsPi[i] ? 0 : m_vPartition[getNodeFanin0Id(i)];
+	return nReused;
+}
+
 void MetisGraph::tmp()
 {
 	Yaig y;
@@ -611,6 +890,8 @@ void MetisAig::bindGraph(MetisGraph* pmg)
 	{
 		clear();
 		vector<Cone>().swap(m_vCones);
+		vector<Edge>().swap(m_vBoundaryEdges);
+		vector<int32_t>().swap(m_vAdjacentConeIds);
 		vector<Cluster>().swap(m_vClusters);
 		vector<int>().swap(m_vConeId2ClusterId);
 		m_pMG = NULL;
@@ -626,10 +907,10 @@ void MetisAig::printCones()
  #if 0
 	for(auto& c : m_vCones)
 	{
-		if(c.vBoundaryEdges.size())
-			ylog("m_vCones[%d] has %ld boundary edges, level: %d\n",c.iId, c.vBoundaryEdges.size(), c.iMaxLevel);
-		for(auto e : c.vBoundaryEdges)
-			ylog("edge: %d -> %d\n", e.iFaninId, e.iFanoutId);
+		if(c.nBoundaryEdges())
+			ylog("m_vCones[%d] has %d boundary edges, level: %d\n",c.iId, c.nBoundaryEdges(), c.iMaxLevel);
+		for(int i = c.iEdgeBeg; i < c.iEdgeEnd; i++)
+			ylog("edge: %d -> %d\n", m_vBoundaryEdges[i].iFaninId, m_vBoundaryEdges[i].iFanoutId);
 		printOneCone(c.iId);
 	}
  #endif
@@ -640,7 +921,7 @@ void MetisAig::printOneCone(int32_t coneId)
 	ylog("Now print m_vCones[%d]:\n", coneId);
 	auto& cone = m_vCones[coneId];
 	ylog("iMaxLevel = %d, iPoId = %d, iId = %d\n", cone.iMaxLevel, cone.iPoId, cone.iId);
-	ylog("NumBoundaryEdges = %ld, NumNeighborCone = %ld\n", cone.vBoundaryEdges.size(), cone.sAdjacentConeId.size());
+	ylog("NumBoundaryEdges = %d, NumNeighborCone = %d\n", cone.nBoundaryEdges(), cone.nAdjacentCones());
 }
 
 void MetisAig::printClusters()
@@ -664,6 +945,9 @@ void MetisAig::printClusters()
 void MetisAig::parseAig()
 {
 	//yassert(m_pMG);
+	struct timeval t1,t2;
+	double time;
+	gettimeofday(&t1, NULL);
 	//prepare m_vCones
 	//计算所有节点的level
 	computeAllLevel();
@@ -678,18 +962,38 @@ void MetisAig::parseAig()
 	//排序，按照level大小
 	sort(m_vCones.begin(), m_vCones.end(), [](const Cone& c1, const Cone& c2){ return c1.iMaxLevel > c2.iMaxLevel;});
 	for(int i = 0; i < m_vCones.size(); i++)
+		m_vCones[i].iId = i;
+	assignConeIds();
+	//找到它的边界边（即与其他Cone对象相邻的边界边），构建一个BoundaryEdge对象
+	//cones are handed out in contiguous chunks, and the chunks are concatenated in cone order
+	struct ConeChunk { vector<Edge> vEdges; vector<int32_t> vAdjacentConeIds; };
+	int32_t nCones = m_vCones.size();
+	int32_t nChunks = min(nCones, CONE_CHUNKS_PER_THREAD * (int32_t)(m_pMG ? m_pMG->get_nThreads() : 1));
+	vector<ConeChunk> vChunks(nChunks);
+	setNextIter();
+	int32_t nWorkers = parallelFor(nChunks, [&](int32_t iChunk, vector<int32_t>& vStack) {
+		ConeChunk& chunk = vChunks[iChunk];
+		for(int32_t i = (int64_t)nCones * iChunk / nChunks; i < (int64_t)nCones * (iChunk + 1) / nChunks; i++)
+			findBoundaryEdges(m_vCones[i], chunk.vEdges, chunk.vAdjacentConeIds, vStack);
+	});
+	for(int32_t iChunk = 0; iChunk < nChunks; iChunk++)
 	{
-		auto& cone = m_vCones[i];
-		cone.iId = i;
-		//找到它的边界边（即与其他Cone对象相邻的边界边），构建一个BoundaryEdge对象
-		findBoundaryEdges(cone);
+		ConeChunk& chunk = vChunks[iChunk];
+		int32_t iEdgeShift = m_vBoundaryEdges.size();
+		int32_t iAdjShift = m_vAdjacentConeIds.size();
+		for(int32_t i = (int64_t)nCones * iChunk / nChunks; i < (int64_t)nCones * (iChunk + 1) / nChunks; i++)
+		{
+			m_vCones[i].iEdgeBeg += iEdgeShift;
+			m_vCones[i].iEdgeEnd += iEdgeShift;
+			m_vCones[i].iAdjBeg += iAdjShift;
+			m_vCones[i].iAdjEnd += iAdjShift;
+		}
+		m_vBoundaryEdges.insert(m_vBoundaryEdges.end(), chunk.vEdges.begin(), chunk.vEdges.end());
+		m_vAdjacentConeIds.insert(m_vAdjacentConeIds.end(), chunk.vAdjacentConeIds.begin(), chunk.vAdjacentConeIds.end());
 	}
 	//printCones();
 
-	for(auto& cone : m_vCones)
-		m_tmp0 += cone.vBoundaryEdges.size();
-	ylog("There are totally %d boundary edges\n", m_tmp0);
-	m_tmp0 = 0;
+	ylog("There are totally %ld boundary edges\n", m_vBoundaryEdges.size());
 
 	vector<int> coneId2ClusterId(m_vCones.size(), -1);
 
@@ -705,8 +1009,9 @@ void MetisAig::parseAig()
 			m_vClusters.push_back(move(cluster));
 			continue;
 		}
-		for(auto neighborConeId : cone.sAdjacentConeId)
+		for(int i = cone.iAdjBeg; i < cone.iAdjEnd; i++)
 		{
+			int32_t neighborConeId = m_vAdjacentConeIds[i];
 			int32_t clusterIdNeighborCone = coneId2ClusterId[neighborConeId];
 			yassert(clusterIdNeighborCone != -1);
 			int32_t clusterIdCurrentCone = coneId2ClusterId[cone.iId];
@@ -745,17 +1050,20 @@ void MetisAig::parseAig()
 	//compute clusters' workload
 	m_iTotalWorkLoad = 0;
 	m_iMaxClusterWorkLoad = 0;
-	for(auto& cluster : m_vClusters)
-	{
+	setNextIter();
+	parallelFor(m_vClusters.size(), [&](int32_t i, vector<int32_t>& vStack) {
+		Cluster& cluster = m_vClusters[i];
 		if(cluster.iId == -1) //merged cluster
 		{
 			cluster.iWorkload = -1;
 			cluster.nNodes = -1;
-			continue;
+			return;
 		}
-		computeWorkLoad(cluster);
-		m_iTotalWorkLoad += cluster.iWorkload;
-	}
+		computeWorkLoad(cluster, vStack);
+	});
+	for(auto& cluster : m_vClusters)
+		if(cluster.iId != -1)
+			m_iTotalWorkLoad += cluster.iWorkload;
 	//sort clusters by workload
 	//after sorting, the iId field of each cluster in the m_vClusters should be re-assigned. 
 	sort(m_vClusters.begin(), m_vClusters.end(), [](const Cluster& lhs, const Cluster& rhs){return lhs.iWorkload > rhs.iWorkload;});
@@ -782,7 +1090,18 @@ void MetisAig::parseAig()
 	// merge small cluster
 	uint32_t ClusterUpB = m_pMG->get_sCluster();
 	if (ClusterUpB != 0)
+	{
+		//do not merge below PARTS_PER_THREAD parts per worker
+		int32_t nThreads = m_pMG->get_nThreads();
+		if (nThreads > 1)
+		{
+			int32_t nNodesAll = 0;
+			for (auto& cluster : m_vClusters)
+				nNodesAll += cluster.nNodes;
+			ClusterUpB = min(ClusterUpB, (uint32_t)max(1, nNodesAll / (PARTS_PER_THREAD * nThreads)));
+		}
 		mergeSmallClusters(ClusterUpB);
+	}
 	
 	printClusters();
 #if 0 
@@ -793,20 +1112,37 @@ void MetisAig::parseAig()
 #endif
 	ylog("total work load: %d\n", m_iTotalWorkLoad);
 	ylog("max cluster work load: %d\n", m_iMaxClusterWorkLoad);
+	gettimeofday(&t2, NULL);
+	time = t2.tv_sec - t1.tv_sec + (t2.tv_usec - t1.tv_usec)/1000000.0;
+	printf("parseAig with %d workers spent time: %f\n", nWorkers, time);
 }
 
+//With a cost model, clusters are merged up to the predicted cost of size average nodes.
 void MetisAig::mergeSmallClusters(uint32_t size) {
-	sort(m_vClusters.begin(), m_vClusters.end(), [](const Cluster& lhs, const Cluster& rhs){return lhs.nNodes < rhs.nNodes;});
+	auto clusterSize = [this](const Cluster& cluster) -> int64_t { return m_pCostModel ? cluster.iWorkload : cluster.nNodes; };
+	int64_t sizeLimit = size;
+	if (m_pCostModel)
+	{
+		int64_t workloadAll = 0, nNodesAll = 0;
+		for (auto& cluster : m_vClusters)
+		{
+			workloadAll += cluster.iWorkload;
+			nNodesAll += cluster.nNodes;
+		}
+		sizeLimit = max((int64_t)1, (int64_t)size * workloadAll / max((int64_t)1, nNodesAll));
+	}
+	sort(m_vClusters.begin(), m_vClusters.end(), [&](const Cluster& lhs, const Cluster& rhs){return clusterSize(lhs) < clusterSize(rhs);});
 	vector<Cluster> merged_vSmallCluters;
 	for (auto& cluster : m_vClusters) {
 		if (merged_vSmallCluters.empty())
 			merged_vSmallCluters.push_back(cluster);
 		else {
-			if (merged_vSmallCluters.back().nNodes + cluster.nNodes > size)
+			if (clusterSize(merged_vSmallCluters.back()) + clusterSize(cluster) > sizeLimit)
 				merged_vSmallCluters.push_back(cluster);
 			else {
 				merged_vSmallCluters.back().iMaxLevel = max(merged_vSmallCluters.back().iMaxLevel, cluster.iMaxLevel);
 				merged_vSmallCluters.back().iWorkload += cluster.iWorkload;
+				merged_vSmallCluters.back().iCutLoad += cluster.iCutLoad;
 				merged_vSmallCluters.back().nNodes += cluster.nNodes;
 				merged_vSmallCluters.back().vConeIds.insert(merged_vSmallCluters.back().vConeIds.end(), cluster.vConeIds.begin(), cluster.vConeIds.end());
 			}
@@ -852,150 +1188,240 @@ void MetisAig::checkNodeCluster(int32_t nodeId, int32_t clusterId)
 }
 
 
-void MetisAig::findBoundaryEdges(Cone& cone)
-{
-	setNextIter();
-	visitAllFaninFromNode(cone.iPoId, cone); //mark all the AND nodes in this cone and prepare nVisits of the nodes
-	setNextIter();
-	findBoundaryEdges_rec(cone, cone.iPoId, 0);
-	return;
-}
-
-//遍历以指定节点为起点的所有 fanin 节点，同时更新每个节点的访问状态和节点所属的cone区域
-void MetisAig::visitAllFaninFromNode(int32_t nodeId, Cone& cone)
+//按level从高到低处理cone，每个节点的iConeId是包含它的最长cone，nVisits是它在该cone外的扇出数
+void MetisAig::assignConeIds()
 {
-	Node& node = m_vNodes[nodeId];
-	if(node.isPo())
+	for(auto& node : m_vNodes)
 	{
-		visitAllFaninFromNode(node.getFanin0Id(), cone);
-		return;
+		node.iConeId = -1;
+		node.nVisits = 0;
 	}
-	if(node.iIter == m_iGlobalIter)
+	for(auto& cone : m_vCones)
+		m_vNodes[cone.iPoId].iConeId = cone.iId;
+	//fanins are created before their fanouts, so a backward sweep sees all the fanouts of a node first
+	for(int32_t i = m_vNodes.size() - 1; i >= 0; i--)
 	{
-		yassert(node.nVisits);
-		node.nVisits--;
-		return ;
+		Node& node = m_vNodes[i];
+		if(node.isPi() || node.iConeId == -1)
+			continue;
+		for(int k = 0; k < (node.isPo() ? 1 : 2); k++)
+		{
+			Node& fanin = m_vNodes[k ? node.getFanin1Id() : node.getFanin0Id()];
+			yassert(fanin.id < node.id);
+			if(fanin.iConeId == -1 || fanin.iConeId > node.iConeId)
+				fanin.iConeId = node.iConeId;
+		}
+	}
+	//a fanout is in the cone of its fanin only if the cone is also the longest cone of the fanout
+	for(auto& node : m_vNodes)
+	{
+		if(node.isPi())
+			continue;
+		Node& fanin0 = m_vNodes[node.getFanin0Id()];
+		if(fanin0.iConeId != node.iConeId)
+			fanin0.nVisits++;
+		if(node.isPo())
+			continue;
+		Node& fanin1 = m_vNodes[node.getFanin1Id()];
+		if(fanin1.iConeId != node.iConeId)
+			fanin1.nVisits++;
 	}
-	/*
-	if(node.isPi())
-		return ;
-	*/
-	node.iIter = m_iGlobalIter;
-	node.nVisits = node.nFanouts - 1;
-	if(node.iConeId == -1)
-		node.iConeId = cone.iId;
-	else
-		if(cone.iMaxLevel > m_vCones[node.iConeId].iMaxLevel)
-			yassert(0);
-	if(node.isPi())
-		return;
-			//node.iConeId = cone.iId;
-	visitAllFaninFromNode(node.getFanin0Id(), cone);
-	visitAllFaninFromNode(node.getFanin1Id(), cone);
-	return;
 }
 
 //在一个有向无环图中找到一个锥形子图的边界边
-void MetisAig::findBoundaryEdges_rec(Cone& cone, int32_t nodeId, int32_t fCovered)
+//Only the nodes whose longest cone is this cone are traversed. Below a node of a longer cone every edge
+//is covered by the edge entering it, and the cones met there are already adjacent to that longer cone.
+//The traversed nodes of different cones are disjoint, so cones may be processed concurrently under one iIter.
+void MetisAig::findBoundaryEdges(Cone& cone, vector<Edge>& vEdges, vector<int32_t>& vAdjacentConeIds, vector<int32_t>& vStack)
 {
-	Node& node = m_vNodes[nodeId];
-	int fc = fCovered;
-
-	//检查是否为PO
-	if(node.isPo())
+	Node& po = m_vNodes[cone.iPoId];
+	cone.iEdgeBeg = vEdges.size();
+	cone.iAdjBeg = vAdjacentConeIds.size();
+	vStack.clear();
+	vStack.push_back(checkBoundaryEdge(cone, po.getFanin0Id(), po.id, 0, vEdges, vAdjacentConeIds));
+	while(!vStack.empty())
 	{
-		//递归访问它的输入节点，并检查是否为边界边
-		Node& fanin = m_vNodes[node.getFanin0Id()];
-		if(fanin.nVisits)// && !fanin.isPi())
+		int32_t entry = vStack.back();
+		vStack.pop_back();
+		Node& node = m_vNodes[entry >> 1];
+		if(node.isPi())
+			continue;
+		if(node.iConeId != cone.iId)
 		{
-			Edge edge(fanin.id, nodeId);
-			cone.vBoundaryEdges.push_back(move(edge));
-			if(fanin.iConeId != cone.iId)
-				cone.sAdjacentConeId.insert(fanin.iConeId);
-			fc = 1;
+			yassert(entry & 1);
+			continue;
 		}
-		findBoundaryEdges_rec(cone, node.getFanin0Id(), fc);
-		return;
+		if(node.iIter == m_iGlobalIter)
+			continue;
+		node.iIter = m_iGlobalIter;
+		//fanin0 is popped first, the same order as a recursive DFS
+		int32_t entry0 = checkBoundaryEdge(cone, node.getFanin0Id(), node.id, entry & 1, vEdges, vAdjacentConeIds);
+		int32_t entry1 = checkBoundaryEdge(cone, node.getFanin1Id(), node.id, entry & 1, vEdges, vAdjacentConeIds);
+		vStack.push_back(entry1);
+		vStack.push_back(entry0);
 	}
-	if(node.isPi())
-		return;
-	if(node.iIter == m_iGlobalIter)
-		return;
-	node.iIter = m_iGlobalIter;
-
-	//如果不是输出节点，那么它会继续访问两个输入节点，并对它们进行递归调用。
-	Node& fanin0 = m_vNodes[node.getFanin0Id()];
-	Node& fanin1 = m_vNodes[node.getFanin1Id()];
+	cone.iEdgeEnd = vEdges.size();
+	sort(vAdjacentConeIds.begin() + cone.iAdjBeg, vAdjacentConeIds.end());
+	vAdjacentConeIds.erase(unique(vAdjacentConeIds.begin() + cone.iAdjBeg, vAdjacentConeIds.end()), vAdjacentConeIds.end());
+	cone.iAdjEnd = vAdjacentConeIds.size();
+	return;
+}
 
-	//如果该节点的一个输入节点已被访问过或它的多个输出节点不属于给定锥体(cone)，那么该节点就是边界节点。
-	if(fanin0.nVisits || (fanin0.nFanouts > 1 && fanin0.iConeId != cone.iId))// && !fanin0.isPi()) //has fanout node that belongs other cone
+//如果输入节点在cone外还有扇出，该边就是边界边；返回输入节点的DFS栈项
+int32_t MetisAig::checkBoundaryEdge(Cone& cone, int32_t faninId, int32_t fanoutId, int32_t fCovered, vector<Edge>& vEdges, vector<int32_t>& vAdjacentConeIds)
+{
+	Node& fanin = m_vNodes[faninId];
+	if(fanin.nVisits || (fanin.nFanouts > 1 && fanin.iConeId != cone.iId)) //has fanout node that belongs other cone
 	{
 		if(!fCovered)
-		{
-			//每个边界边被保存到锥体的边界边列表中
-			Edge edge(fanin0.id, nodeId);
-			cone.vBoundaryEdges.push_back(move(edge));
-		}
-		if(fanin0.iConeId != cone.iId)
-			//与其相邻的其他锥体的ID被保存到锥体的相邻锥体ID集合中
-			cone.sAdjacentConeId.insert(fanin0.iConeId);
-		fc = 1;
+			vEdges.push_back(Edge(faninId, fanoutId));
+		if(fanin.iConeId != cone.iId)
+			vAdjacentConeIds.push_back(fanin.iConeId);
+		fCovered = 1;
 	}
-	findBoundaryEdges_rec(cone, fanin0.id, fc);
+	return (faninId << 1) | fCovered;
+}
 
-	fc = fCovered;
-	if(fanin1.nVisits || (fanin1.nFanouts > 1 && fanin1.iConeId != cone.iId))// && !fanin1.isPi()) //has fanout node that belongs other cone
+//clusters share no AND node, so their workloads may be computed concurrently under one iIter
+void MetisAig::computeWorkLoad(Cluster& cluster)
+{
+	setNextIter();
+	computeWorkLoad(cluster, m_vStack);
+}
+
+void MetisAig::computeWorkLoad(Cluster& cluster, vector<int32_t>& vStack)
+{
+	cluster.iCutLoad = 0;
+	cluster.nNodes = 0;
+	for(auto coneId : cluster.vConeIds)
+		computeConeWorkLoad(m_vCones[coneId].iPoId, cluster.iCutLoad, cluster.nNodes, vStack);
+	cluster.iWorkload = m_pCostModel ? m_pCostModel->predict(cluster.iCutLoad, cluster.nNodes) : cluster.iCutLoad;
+}
+
+//post-order DFS; an entry with flag 1 means the fanins of the node are done
+void MetisAig::computeConeWorkLoad(int32_t poId, int32_t& workload, int32_t& nNodes, vector<int32_t>& vStack)
+{
+	vStack.clear();
+	vStack.push_back(m_vNodes[poId].getFanin0Id() << 1);
+	while(!vStack.empty())
 	{
-		if(!fCovered)
+		int32_t entry = vStack.back();
+		vStack.pop_back();
+		Node& node = m_vNodes[entry >> 1];
+		if(node.isPi())
 		{
-			Edge edge(fanin1.id, nodeId);
-			cone.vBoundaryEdges.push_back(move(edge));
+			workload += PI_WORK_LOAD;
+			continue;
+		}
+		if(entry & 1)
+		{
+			Node& fanin0 = m_vNodes[node.getFanin0Id()];
+			Node& fanin1 = m_vNodes[node.getFanin1Id()];
+			int32_t nCuts = (fanin0.isPi() ? 1 : fanin0.iNCuts) * (fanin1.isPi() ? 1 : fanin1.iNCuts);
+			workload += nCuts;
+			if(nCuts > 8)
+				nCuts = 8;
+			node.iNCuts = nCuts + 1;
+			continue;
 		}
-		if(fanin1.iConeId != cone.iId)
-			cone.sAdjacentConeId.insert(fanin1.iConeId);
-		fc = 1;
+		if(node.iIter == m_iGlobalIter)
+			continue;
+		node.iIter = m_iGlobalIter;
+		nNodes++;
+		vStack.push_back(entry | 1);
+		vStack.push_back(node.getFanin1Id() << 1);
+		vStack.push_back(node.getFanin0Id() << 1);
 	}
-	findBoundaryEdges_rec(cone, fanin1.id, fc);
+}
 
-	return;
+bool PifCostModel::load(const string& fileName)
+{
+	FILE* pFile = fopen(fileName.c_str(), "r");
+	if (pFile == NULL)
+		return false;
+	int nRead = fscanf(pFile, "%d %lf %lf %lf %lf %lf", &nSamples, &sLL, &sLN, &sNN, &sLT, &sNT);
+	fclose(pFile);
+	if (nRead != 6 || nSamples <= 0)
+	{
+		*this = PifCostModel();
+		return false;
+	}
+	return fit();
 }
 
-void MetisAig::computeWorkLoad(Cluster& cluster)
+bool PifCostModel::save(const string& fileName) const
 {
-	cluster.iWorkload = 0;
-	cluster.nNodes = 0;
-	setNextIter();
-	for(auto coneId : cluster.vConeIds)
-		computeWorkLoad_rec(m_vCones[coneId].iPoId, cluster.iWorkload, cluster.nNodes);
+	FILE* pFile = fopen(fileName.c_str(), "w");
+	if (pFile == NULL)
+		return false;
+	fprintf(pFile, "%d %.17g %.17g %.17g %.17g %.17g\n", nSamples, sLL, sLN, sNN, sLT, sNT);
+	fprintf(pFile, "# pif cost model: time(us) = %g * cutLoad + %g * nNodes\n", a, b);
+	fclose(pFile);
+	return true;
 }
 
-int32_t MetisAig::computeWorkLoad_rec(int32_t nodeId, int32_t& workload, int32_t& nNodes)
+void PifCostModel::addSample(double cutLoad, double nNodes, double time)
 {
-	Node& node = m_vNodes[nodeId];
-	if(node.isPo())
-	{
-		computeWorkLoad_rec(node.getFanin0Id(), workload, nNodes);
-		return workload;
-	}
-	if(node.isPi())
+	nSamples++;
+	sLL += cutLoad * cutLoad;
+	sLN += cutLoad * nNodes;
+	sNN += nNodes * nNodes;
+	sLT += cutLoad * time;
+	sNT += nNodes * time;
+}
+
+//Solves the 2x2 normal equations. If they are singular or give a negative
+//coefficient, the time is fitted on the cut load alone.
+bool PifCostModel::fit()
+{
+	a = b = 0;
+	double det = sLL * sNN - sLN * sLN;
+	if (nSamples > 1 && det > 1e-9 * sLL * sNN)
 	{
-		workload += PI_WORK_LOAD;
-		return 1;
+		a = (sLT * sNN - sNT * sLN) / det;
+		b = (sNT * sLL - sLT * sLN) / det;
+		if (a >= 0 && b >= 0 && isFitted())
+			return true;
 	}
-	if(node.iIter == m_iGlobalIter)
-		return node.iNCuts;
-	node.iIter = m_iGlobalIter;
-	nNodes++;
-
-	int32_t nCuts, nCutsLeft, nCutsRight;
-	nCutsLeft = computeWorkLoad_rec(node.getFanin0Id(), workload, nNodes);
-	nCutsRight = computeWorkLoad_rec(node.getFanin1Id(), workload, nNodes);
-	nCuts = nCutsLeft * nCutsRight;
-	workload += nCuts;
-	if(nCuts > 8)
-		nCuts = 8;
-	node.iNCuts = nCuts + 1;
-	return node.iNCuts;
+	a = sLL > 0 ? sLT / sLL : 0;
+	b = 0;
+	return isFitted();
+}
+
+int32_t PifCostModel::predict(int32_t cutLoad, int32_t nNodes) const
+{
+	if (!isFitted())
+		return cutLoad;
+	return (int32_t)max(1.0, min((double)(INT32_MAX / 4), a * cutLoad + b * nNodes + 0.5)); //the workloads of the clusters are summed
+}
+
+void PifEcoCache::clear()
+{
+	for (auto& part : mParts)
+		Abc_NtkDelete(part.second.pNtkMapped);
+	mParts.clear();
+	mNodeParts.clear();
+	settings.clear();
+	nParts = 0;
+}
+
+//calls f(i, vStack) for every i in [0, n) on up to nThreads workers, each with its own DFS stack
+int32_t MetisAig::parallelFor(int32_t n, const function<void(int32_t, vector<int32_t>&)>& f)
+{
+	atomic<int> iNext(0);
+	auto worker = [&]() {
+		vector<int32_t> vStack;
+		for (int i = iNext++; i < n; i = iNext++)
+			f(i, vStack);
+	};
+	int nWorkers = max(1, min(m_pMG ? (int)m_pMG->get_nThreads() : 1, n));
+	vector<thread> vThreads;
+	for (int i = 1; i < nWorkers; i++)
+		vThreads.push_back(thread(worker));
+	worker();
+	for (auto& th : vThreads)
+		th.join();
+	return nWorkers;
 }
 
 int32_t MetisAig::decideNumParts()
@@ -1119,7 +1545,7 @@ int32_t MetisAig::partBiggestCluster(int32_t clusterId, int32_t workLoadLimit)
 		return 0;
 	yassert(m_vClusters[clusterId].iWorkload == m_iMaxClusterWorkLoad);
 	sort(m_vClusters[clusterId].vConeIds.begin(), m_vClusters[clusterId].vConeIds.end(), [this](int32_t lhs, int32_t rhs){
-		return m_vCones[lhs].sAdjacentConeId.size() > m_vCones[rhs].sAdjacentConeId.size();
+		return m_vCones[lhs].nAdjacentCones() > m_vCones[rhs].nAdjacentCones();
 	});
 	int nConesCut = 0;
 	int workloadNew = 0;
@@ -1129,8 +1555,9 @@ int32_t MetisAig::partBiggestCluster(int32_t clusterId, int32_t workLoadLimit)
 	{
 		auto& cone = m_vCones[m_vClusters[clusterId].vConeIds[i]];
 		bool fCut = 1;
-		for(auto edge : cone.vBoundaryEdges)
+		for(int k = cone.iEdgeBeg; k < cone.iEdgeEnd; k++)
 		{
+			auto& edge = m_vBoundaryEdges[k];
 			auto& fanin = m_vNodes[edge.iFaninId];
 			auto& fanout = m_vNodes[edge.iFanoutId];
 #if 0
@@ -1160,10 +1587,8 @@ int32_t MetisAig::partBiggestCluster(int32_t clusterId, int32_t workLoadLimit)
 		}
 		if(fCut) //Cut this cone from cluster
 		{
-			for(auto edge : cone.vBoundaryEdges)
-				cutOneBoundaryEdge(edge);
-			//vector<Edge>().swap(cone.vBoundaryEdges);
-			//set<int32_t>().swap(cone.sAdjacentConeId);
+			for(int k = cone.iEdgeBeg; k < cone.iEdgeEnd; k++)
+				cutOneBoundaryEdge(m_vBoundaryEdges[k]);
 			cone.iMaxLevel = computeNodeLevel(m_vNodes[cone.iPoId].getFanin0Id());
 
 			Cluster clusterNew(m_vClusters.size(), cone.iMaxLevel);
@@ -1249,11 +1674,11 @@ int32_t MetisAig::partBiggestClusterByPICut(int32_t clusterId)
 	for(auto i = 0; i < m_vClusters[clusterId].vConeIds.size(); i++)
 	{
 		auto& cone = m_vCones[m_vClusters[clusterId].vConeIds[i]];
-		yassert(!cone.vBoundaryEdges.empty());
+		yassert(cone.nBoundaryEdges());
 		fPiCut = true;
-		for(auto edge : cone.vBoundaryEdges) //make sure all the boundary edges of the cone are fanouts of PI
+		for(int k = cone.iEdgeBeg; k < cone.iEdgeEnd; k++) //make sure all the boundary edges of the cone are fanouts of PI
 		{
-			auto fanin = m_vNodes[edge.iFaninId];
+			auto& fanin = m_vNodes[m_vBoundaryEdges[k].iFaninId];
 			if(!fanin.isPi())
 			{
 				fPiCut = false;
@@ -1311,17 +1736,25 @@ int32_t MetisAig::partBiggestClusterByPICut(int32_t clusterId)
 
 void MetisAig::visitConeForEdgeWight(int32_t nodeId, int32_t coneId)
 {
-	Node& node = m_vNodes[nodeId];
-	if(node.isPo())
+	m_vStack.clear();
+	m_vStack.push_back(m_vNodes[nodeId].isPo() ? m_vNodes[nodeId].getFanin0Id() : nodeId);
+	while(!m_vStack.empty())
 	{
-		visitConeForEdgeWight(node.getFanin0Id(), coneId);
-		return ;
+		Node& node = m_vNodes[m_vStack.back()];
+		m_vStack.pop_back();
+		if(node.iIter == m_iGlobalIter)
+			continue;
+		if(node.isPi())
+			continue;
+		node.iIter = m_iGlobalIter;
+		setConeEdgeWeights(node);
+		m_vStack.push_back(node.getFanin1Id());
+		m_vStack.push_back(node.getFanin0Id());
 	}
-	if(node.iIter == m_iGlobalIter)
-		return ;
-	if(node.isPi())
-		return ;
-	node.iIter = m_iGlobalIter;
+}
+
+void MetisAig::setConeEdgeWeights(Node& node)
+{
 	Cone& coneNode = m_vCones[node.iConeId];
 
 	Node& fanin0 = m_vNodes[node.getFanin0Id()];
@@ -1353,13 +1786,6 @@ void MetisAig::visitConeForEdgeWight(int32_t nodeId, int32_t coneId)
 			m_pMG->setEdgeWeight(fanin1.iData, node.iData, 100);
 
 	}
-
-	visitConeForEdgeWight(fanin0.id, coneId);
-	visitConeForEdgeWight(fanin1.id, coneId);
-
-	return;
-
-
 }
 
 //划分AIG
@@ -1368,45 +1794,32 @@ int32_t MetisAig::partitionAig()
 {
 	// int32_t nParts = decideNumParts();
 	int32_t nParts = m_vClusters.size();
-// 	if(nParts == -1)
-// 	{
-// 		//Metis is used. Prepare weight vectors
-// 		m_pMG->initWeightVector();
-// 		setNextIter();
-// 		for(auto& cone : m_vCones)
-// 		{
-// 			visitConeForEdgeWight(cone.iPoId, cone.iId);
-// 			//对 AIG 图中的节点进行遍历，并计算节点间的边权重和节点权重
-// #if 0
-// 			for(auto& edge : cone.vBoundaryEdges)
-// 			{
-				
-// 				Node fanin = m_vNodes[edge.iFaninId];
-// 				Node fanout = m_vNodes[edge.iFanoutId];
-// 				if(fanout.isPo())
-// 					continue;
-// 				if(fanin.isPi())
-// 					m_pMG->setEdgeWeight(fanin.iData, fanout.iData, 1);
-// 				else 
-// 					m_pMG->setEdgeWeight(fanin.iData, fanout.iData, 10);
-// 			}
-// #endif
-// 		}
-// 		for(auto& node : m_vNodes)
-// 		{
-// 			if(node.isPi() || node.isPo())
-// 			{
-// 				if(node.iData != -1)
-// 					m_pMG->setNodeWeight(node.iData, 1);
-// 			}
-// 			else
-// 				if(node.iData != -1)
-// 					m_pMG->setNodeWeight(node.iData, 100);
-// 		}
-// 		//调用 partGraphByMetis() 方法进行分区
-// 		m_pMG->partGraphByMetis(METIS_N_PART);
-// 		return METIS_N_PART;
-// 	}
+	if(nParts < MIN_N_PART)
+	{
+		//The graph cannot be partitioned naturally. Prepare weight vectors for the k-way partitioner
+		ylog("This graph cannot be partitioned naturally. The k-way partitioner will be used\n");
+		m_pMG->initWeightVector();
+		setNextIter();
+		for(auto& cone : m_vCones)
+			visitConeForEdgeWight(cone.iPoId, cone.iId);
+		for(auto& node : m_vNodes)
+		{
+			if(node.isPi() || node.isPo())
+			{
+				if(node.iData != -1)
+					m_pMG->setNodeWeight(node.iData, 1);
+			}
+			else
+				if(node.iData != -1)
+					m_pMG->setNodeWeight(node.iData, 100);
+		}
+		m_vPartWorkloads.clear();
+		m_vPartCutLoads.clear();
+		m_vPartNodes.clear();
+		if(m_pMG->partGraphKway(METIS_N_PART) >= 0)
+			return METIS_N_PART;
+		//too small to split: keep the single cluster
+	}
 	//yassert(nParts * m_iMaxClusterWorkLoad <= m_iTotalWorkLoad);
 
 	//如果不适用metis，直接将 AIG 图分为指定数量的分区。
@@ -1424,9 +1837,15 @@ int32_t MetisAig::partitionAig()
 	}
 	*/
 
+	m_vPartWorkloads.clear();
+	m_vPartCutLoads.clear();
+	m_vPartNodes.clear();
 	for(int i = 0; i < partitions.size(); i++)
 	{
 		auto& part = partitions[i];
+		m_vPartWorkloads.push_back(part.iWorkload);
+		m_vPartCutLoads.push_back(part.iCutLoad);
+		m_vPartNodes.push_back(part.nNodes);
 		for(auto clusterId : part.vClusterIds)
 		{
 			auto& cluster = m_vClusters[clusterId];
@@ -1448,104 +1867,103 @@ void MetisAig::setGraphPartition(Cluster& cluster, int32_t partId)
 
 void MetisAig::setNodePartition(int32_t nodeId, int32_t partId)
 {
-	Node& node = m_vNodes[nodeId];
-	if(node.isPo())
-	{
-		setNodePartition(node.getFanin0Id(), partId);
-		return;
-	}
-	if(node.isPi())
+	m_vStack.clear();
+	m_vStack.push_back(m_vNodes[nodeId].isPo() ? m_vNodes[nodeId].getFanin0Id() : nodeId);
+	while(!m_vStack.empty())
 	{
+		Node& node = m_vNodes[m_vStack.back()];
+		m_vStack.pop_back();
+		if(node.isPi())
+		{
+			if(node.iData != -1)
+				m_pMG->setNodePart(node.iData, partId);
+			continue;
+		}
+		if(node.iIter == m_iGlobalIter)
+			continue;
+		node.iIter = m_iGlobalIter;
 		if(node.iData != -1)
 			m_pMG->setNodePart(node.iData, partId);
-		return;
+		m_vStack.push_back(node.getFanin1Id());
+		m_vStack.push_back(node.getFanin0Id());
 	}
-	if(node.iIter == m_iGlobalIter)
-		return; 
-	node.iIter = m_iGlobalIter;
-	if(node.iData != -1)
-		m_pMG->setNodePart(node.iData, partId);
-	setNodePartition(node.getFanin0Id(), partId);
-	setNodePartition(node.getFanin1Id(), partId);
-	return; 
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Returns the copy in the merged network of a CI of a mapped subnetwork.]
+
+  Description [A cut-caused PI is replaced by the driver of the PO it is cut from
+               (which may itself be a cut-caused PI), or by the real CI it duplicates.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static Abc_Obj_t* Abc_NtkMergeCiCopy(Vec_Ptr_t *pSubNtksNew, const vector<vector<CioOrigin>>& vvCiOrigins, int iPart, int iCi)
+{
+	Abc_Obj_t *pObj, *pPo, *pDriver;
+	Abc_Ntk_t *pSubNtk;
+	pObj = Abc_NtkCi(static_cast<Abc_Ntk_t*>(Vec_PtrEntry(pSubNtksNew, iPart)), iCi);
+	if (pObj->pCopy)
+		return pObj->pCopy;
+	const CioOrigin& origin = vvCiOrigins[iPart][iCi];
+	yassert(origin.iPart >= 0);
+	pSubNtk = static_cast<Abc_Ntk_t*>(Vec_PtrEntry(pSubNtksNew, origin.iPart));
+	if (!origin.fCo)
+		return pObj->pCopy = Abc_NtkMergeCiCopy(pSubNtksNew, vvCiOrigins, origin.iPart, origin.iCio);
+	pPo = Abc_NtkCo(pSubNtk, origin.iCio);
+	pDriver = Abc_ObjFanin0(pPo);
+	if (Abc_ObjIsCi(pDriver))
+		pObj->pCopy = Abc_NtkMergeCiCopy(pSubNtksNew, vvCiOrigins, origin.iPart, pDriver->iTemp);
+	else
+		pObj->pCopy = pDriver->pCopy;
+	return pObj->pCopy = Abc_ObjNotCond(pObj->pCopy, Abc_ObjFaninC0(pPo));
 }
 
 /**Function*************************************************************
 
   Synopsis    [Merge several mapped networks.]
 
-  Description []
+  Description [The CI/COs of the mapped subnetworks are matched with pNtk and with each
+               other by index through vvCiOrigins/vvCoOrigins (see createSubNtksFromPartition),
+               which relies on Abc_NtkIf keeping the order of CI/COs. The copies of the
+               fringes are never roots of a LUT, so each node is emitted by its own part
+               only; the leaves of a fringe resolve like any cut-caused PI.]
 
   SideEffects []
 
   SeeAlso     []
 
 ***********************************************************************/
-Abc_Ntk_t *Abc_NtkMerge(Abc_Ntk_t *pNtk, Vec_Ptr_t *pSubNtksOld, Vec_Ptr_t *pSubNtksNew)
+Abc_Ntk_t *Abc_NtkMerge(Abc_Ntk_t *pNtk, Vec_Ptr_t *pSubNtksNew, const vector<vector<CioOrigin>>& vvCiOrigins, const vector<vector<CioOrigin>>& vvCoOrigins)
 {
 	Abc_Ntk_t *pNtkRes, *pSubNtk;
 	Abc_Obj_t *pObj, *pObjNew, *pFanin, *pConst1, *pConst0;
-	Nm_Man_t *pManName;
-	int iObjId;
+	Hop_Man_t *pManRes;
 	int i, j, k;
 	pConst0 = pConst1 = NULL;
 
-	yassert(Vec_PtrSize(pSubNtksNew) == Vec_PtrSize(pSubNtksOld));
+	yassert(Vec_PtrSize(pSubNtksNew) == vvCiOrigins.size());
+	yassert(Vec_PtrSize(pSubNtksNew) == vvCoOrigins.size());
 	if (Vec_PtrSize(pSubNtksNew) == 0)
 		return NULL;
 	pNtkRes = Abc_NtkStartFrom(pNtk, ABC_NTK_LOGIC, ABC_FUNC_AIG);
-	
-	
-	pManName = pNtkRes->pManName;
-	// Clone information about newly generated PI/POs during partition process from pSubNtksOld to pSubNtksNew
-	Vec_PtrForEachEntry(Abc_Ntk_t *, pSubNtksOld, pSubNtk, i)
-    //for ( i = 0; (i < Vec_PtrSize(pSubNtksOld)) && (((pSubNtk) = (Type)Vec_PtrEntry(pSubNtksOld, i)), 1); i++ )
-	{
-		Abc_NtkForEachPi(pSubNtk, pObj, j)
-    	//for ( i = 0; (i < Abc_NtkPiNum(pSubNtk)) && (((pObj) = Abc_NtkPi(pSubNtk, i)), 1); i++ )
-		{
-			if (pObj->fMarkA == 1)
-			{
-				pObj->pCopy->fMarkA = 1;
-				pObj->pCopy->pData = Abc_ObjCopy(static_cast<Abc_Obj_t*>(pObj->pData));
-				yassert(pObj->pCopy->pData != NULL);
-			}
-		}
-		Abc_NtkForEachPo(pSubNtk, pObj, j)
-		{
-			if (pObj->fMarkA == 1)
-				pObj->pCopy->fMarkA = 1;
-		}
-	}
-	// Find exsiting CI/CO and Create new internal nodes in pNtkRes
-	//Vec_PtrForEachEntry(Abc_Ntk_t *, pSubNtksNew, pSubNtk, i)
+	pManRes = static_cast<Hop_Man_t*>(pNtkRes->pManFunc);
+
+	// Find CI/COs in pNtkRes for the real CI/COs in pSubNtk and create internal nodes
 	Vec_PtrForEachEntry(Abc_Ntk_t *, pSubNtksNew, pSubNtk, i)
 	{
-		// Find new CI/COs in pNtkRes for corresponding CI/COs in pSubNtk
+		yassert(vvCiOrigins[i].size() == Abc_NtkCiNum(pSubNtk));
+		yassert(vvCoOrigins[i].size() == Abc_NtkCoNum(pSubNtk));
 		Abc_NtkForEachCi(pSubNtk, pObj, j)
 		{
-			if (pObj->fMarkA != 1)
-			{
-				iObjId = Nm_ManFindIdByName(pManName, Abc_ObjName(pObj), Abc_ObjType(pObj) );
-				if(iObjId == -1)
-				{
-					iObjId = Nm_ManFindIdByName(pManName, Abc_ObjName(pObj),  ABC_OBJ_BO );
-				}
-				pObj->pCopy = Abc_NtkObj(pNtkRes, iObjId);
-			}
+			pObj->iTemp = j;
+			pObj->pCopy = vvCiOrigins[i][j].iPart == -1 ? Abc_NtkCi(pNtkRes, vvCiOrigins[i][j].iCio) : NULL;
 		}
 		Abc_NtkForEachCo(pSubNtk, pObj, j)
-		{
-			if (pObj->fMarkA != 1)
-			{
-				iObjId = Nm_ManFindIdByName(pManName, Abc_ObjName(pObj), Abc_ObjType(pObj) );
-				if(iObjId == -1)
-				{
-					iObjId = Nm_ManFindIdByName(pManName, Abc_ObjName(pObj),  ABC_OBJ_BI );
-				}
-				pObj->pCopy = Abc_NtkObj(pNtkRes, iObjId);
-			}
-		}
+			pObj->pCopy = vvCoOrigins[i][j].iCio == -1 ? NULL : Abc_NtkCo(pNtkRes, vvCoOrigins[i][j].iCio);
 		// Create internel logic nodes
 		Abc_NtkForEachNode(pSubNtk, pObj, j)
 		{
@@ -1565,83 +1983,126 @@ Abc_Ntk_t *Abc_NtkMerge(Abc_Ntk_t *pNtk, Vec_Ptr_t *pSubNtksOld, Vec_Ptr_t *pSub
 				continue;
 			}
 			pObjNew = Abc_NtkCreateNode(pNtkRes);
-			pObjNew->pData = Hop_Transfer(static_cast<Hop_Man_t*>(pSubNtk->pManFunc), static_cast<Hop_Man_t*>(pNtkRes->pManFunc), static_cast<Hop_Obj_t*>(pObj->pData), Abc_ObjFaninNum(pObj));
+			pObjNew->pData = Hop_Transfer(static_cast<Hop_Man_t*>(pSubNtk->pManFunc), pManRes, static_cast<Hop_Obj_t*>(pObj->pData), Abc_ObjFaninNum(pObj));
 			pObj->pCopy = pObjNew;
 		}
 	}
+	// Replace cut-caused PIs by the logic they are cut from
+	Vec_PtrForEachEntry(Abc_Ntk_t *, pSubNtksNew, pSubNtk, i)
+		Abc_NtkForEachCi(pSubNtk, pObj, j)
+			Abc_NtkMergeCiCopy(pSubNtksNew, vvCiOrigins, i, j);
 	//Finish Connections
 	Vec_PtrForEachEntry(Abc_Ntk_t *, pSubNtksNew, pSubNtk, i)
 	{
 		Abc_NtkForEachCo(pSubNtk, pObj, j)
 		{
+			if (pObj->pCopy == NULL) //cut-caused POs don't need connection
+				continue;
 			pFanin = Abc_ObjFanin0(pObj);
-			if (pObj->fMarkA != 1) //cut-caused PI/POs don't need connection
-			{
-				if (pFanin->fMarkA != 1)
-					Abc_ObjAddFanin(pObj->pCopy, Abc_ObjNotCond(pFanin->pCopy, pObj->fCompl0));
-				else //if CO's fanin is a cut-caused CI
-				{
-					if(Abc_ObjIsPo(static_cast<Abc_Obj_t*>(pFanin->pData)))
-						Abc_ObjAddFanin(pObj->pCopy, Abc_ObjNotCond(Abc_ObjCopy(Abc_ObjFanin0(static_cast<Abc_Obj_t*>(pFanin->pData))), Abc_ObjFaninC0(static_cast<Abc_Obj_t*>(pFanin->pData)) ^ Abc_ObjFaninC0(pObj)));
-					else if(Abc_ObjIsPi(static_cast<Abc_Obj_t*>(pFanin->pData)))
-						Abc_ObjAddFanin(pObj->pCopy, Abc_ObjNotCond(Abc_ObjCopy(static_cast<Abc_Obj_t*>(pFanin->pData)), Abc_ObjFaninC0(pObj)));
-					else
-						yassert(0);
-				}
-			}
+			Abc_ObjAddFanin(pObj->pCopy, Abc_ObjNotCond(pFanin->pCopy, pObj->fCompl0));
 		}
 		Abc_NtkForEachNode(pSubNtk, pObj, j)
 		{
 			Abc_ObjForEachFanin(pObj, pFanin, k)
 			{
-				if (pFanin->fMarkA != 1)
-					Abc_ObjAddFanin(pObj->pCopy, pFanin->pCopy);
-				else
-				{
-					if(Abc_ObjIsPo(static_cast<Abc_Obj_t*>(pFanin->pData)))
-					{
-						if (Abc_ObjFaninC0(static_cast<Abc_Obj_t*>(pFanin->pData)) == 1)
-						{
-							pObj->pData = Hop_Complement(static_cast<Hop_Man_t*>(pNtkRes->pManFunc), static_cast<Hop_Obj_t*>(pObj->pData), k);
-						}
-						Abc_ObjAddFanin(pObj->pCopy, Abc_ObjCopy(Abc_ObjFanin0(static_cast<Abc_Obj_t*>(pFanin->pData))));
-					}
-					else if(Abc_ObjIsPi(static_cast<Abc_Obj_t*>(pFanin->pData)))
-						Abc_ObjAddFanin(pObj->pCopy, Abc_ObjNotCond(Abc_ObjCopy(static_cast<Abc_Obj_t*>(pFanin->pData)), Abc_ObjFaninC0(pObj)));
-					else
-						yassert(0);
-				}
+				if (Abc_ObjIsComplement(pFanin->pCopy)) //a cut-caused PI driven through a complemented edge
+					pObj->pCopy->pData = Hop_Complement(pManRes, static_cast<Hop_Obj_t*>(pObj->pCopy->pData), k);
+				Abc_ObjAddFanin(pObj->pCopy, Abc_ObjRegular(pFanin->pCopy));
 			}
 		}
 	}
 
-	//zkx
-	// for ( i = 0; (i < Vec_PtrSize(pSubNtksOld)) && (((pNtk) = (Abc_Ntk_t *)Vec_PtrEntry(pSubNtksOld, i)), 1); i++ ){
-	// //for(auto pNtk : pSubNtksNew){
+	return pNtkRes;
+}
+
+static inline unsigned Abc_SignatureMix(unsigned Sign, unsigned Value)
+{
+	return (Sign ^ Value) * 16777619;
+}
+
+static unsigned Abc_SignatureHop_rec(Hop_Obj_t* pObj)
+{
+	unsigned Sign = 2166136261u;
+	Sign = Abc_SignatureMix(Sign, Hop_IsComplement(pObj));
+	pObj = Hop_Regular(pObj);
+	Sign = Abc_SignatureMix(Sign, pObj->Type);
+	if (Hop_ObjIsPi(pObj))
+		return Abc_SignatureMix(Sign, pObj->PioNum);
+	if (Hop_ObjIsConst1(pObj))
+		return Sign;
+	Sign = Abc_SignatureMix(Sign, Abc_SignatureHop_rec(Hop_ObjChild0(pObj)));
+	return Abc_SignatureMix(Sign, Abc_SignatureHop_rec(Hop_ObjChild1(pObj)));
+}
 
-	// 	char filename[256];
-	// 	const char* outputFolder ="/home/kxzhu/partition/abc/test";
-	// 	snprintf(filename, sizeof(filename),"%s/Mappednetwork_%d.blif",outputFolder, i);
-	// 	printf("Writing file: %s\n", filename);
+/**Function*************************************************************
 
-	// 	Abc_Ntk_t* pNtkNew = Abc_NtkToNetlist(pNtk);
-	// 	//cout<<"Now in iteration!"<<endl;
+  Synopsis    [Signature of a logic network with AIG functions.]
 
-	// 	Io_WriteBlif(pNtkNew,filename,1,0,0);
-		
-	// }
-	
-	// wxx: Network check. Attention: some of PI->pData are not empty!
-	// if ( !Abc_NtkCheck( pNtkRes ) )
-	// {
-	// 	printf( "Abc_NtkPartition: The network check has failed.\n" );
-	// 	Abc_NtkCleanMarkA(pNtkRes);
-	// 	Abc_NtkDelete( pNtkRes );
-	// 	return NULL;
-	// }
-	//	Abc_NtkShow( pSubNtksNew->pArray[0], 0, 0, 1);
+  Description [Depends on the object order, the connections and the structure of
+               the node functions, so equal signatures mean identical netlists for
+               all practical purposes. Used to check that pif runs are reproducible.]
 
-	return pNtkRes;
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+unsigned Abc_NtkPifSignature(Abc_Ntk_t *pNtk)
+{
+	Abc_Obj_t *pObj, *pFanin;
+	unsigned Sign = 2166136261u;
+	int i, k;
+	yassert(Abc_NtkHasAig(pNtk));
+	Abc_NtkForEachObj(pNtk, pObj, i)
+	{
+		Sign = Abc_SignatureMix(Sign, pObj->Type);
+		Abc_ObjForEachFanin(pObj, pFanin, k)
+		{
+			Sign = Abc_SignatureMix(Sign, pFanin->Id);
+			Sign = Abc_SignatureMix(Sign, k < 2 && Abc_ObjFaninC(pObj, k));
+		}
+		if (Abc_ObjIsNode(pObj))
+			Sign = Abc_SignatureMix(Sign, Abc_SignatureHop_rec(static_cast<Hop_Obj_t*>(pObj->pData)));
+	}
+	return Sign;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Fingerprint of a subnetwork before mapping.]
+
+  Description [Two subnetworks with the same fingerprint compute the same
+               functions of their CIs by position, with the same structure,
+               and map the same way for the same boundary timing. The node ids
+               and the order of the fanins do not matter.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+uint64_t Abc_NtkPifFingerprint(Abc_Ntk_t *pNtk)
+{
+	Abc_Obj_t *pObj;
+	int i;
+	uint64_t hash0, hash1, Hash = Abc_EcoHashMix(Abc_NtkCiNum(pNtk), Abc_NtkCoNum(pNtk));
+	vector<uint64_t> vHashes(Abc_NtkObjNumMax(pNtk), 0);
+	yassert(Abc_NtkIsStrash(pNtk));
+	vHashes[Abc_AigConst1(pNtk)->Id] = 1;
+	Abc_NtkForEachCi(pNtk, pObj, i)
+		vHashes[pObj->Id] = Abc_EcoHashMix(Abc_EcoHashMix(2, i), pObj->fMarkA);
+	Abc_AigForEachAnd(pNtk, pObj, i) //the fanins of a node are created before it
+	{
+		hash0 = Abc_EcoHashMix(vHashes[Abc_ObjFaninId0(pObj)], Abc_ObjFaninC0(pObj));
+		hash1 = Abc_EcoHashMix(vHashes[Abc_ObjFaninId1(pObj)], Abc_ObjFaninC1(pObj));
+		vHashes[pObj->Id] = Abc_EcoHashMix(Abc_EcoHashMix(Abc_EcoHashMix(3, pObj->fMarkB), min(hash0, hash1)), max(hash0, hash1));
+	}
+	Abc_NtkForEachCo(pNtk, pObj, i)
+	{
+		Hash = Abc_EcoHashMix(Hash, pObj->fMarkA);
+		Hash = Abc_EcoHashMix(Hash, Abc_EcoHashMix(vHashes[Abc_ObjFaninId0(pObj)], Abc_ObjFaninC0(pObj)));
+	}
+	return Hash;
 }
 
 static Abc_Obj_t* Abc_ObjExtractSubNtk_rec(Abc_Obj_t* pObj, Abc_Ntk_t* pNtkNew)
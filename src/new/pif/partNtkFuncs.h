@@ -8,14 +8,26 @@ extern "C" {
 #include "base/io/ioAbc.h"
 }
 #include <sys/time.h>
-// #include </home/kxzhu/partition/metis/include/metis.h> comment metis by zli
 #include "yaig.h"
 #include <map>
 #include <utility>
+#include <atomic>
+#include <functional>
 
 
 namespace ymc {
 
+//Where a CI/CO of a sub-network comes from. Real CI/COs point to the original
+//network (iPart == -1). A cut-caused PI points to the CO (fCo) or CI of the part
+//driving it. Cut-caused POs have iCio == -1.
+class CioOrigin {
+public:
+    CioOrigin(int32_t id = -1, int32_t part = -1, bool co = false) : iCio(id), iPart(part), fCo(co) {};
+    int32_t iCio; //index among the CIs (or COs) of part iPart, or of the original network
+    int32_t iPart;
+    bool fCo;
+};
+
 class MetisGraph:public Graph //for partitioning
 {
 public:
@@ -31,9 +43,11 @@ public:
         m_vEdgeWeights.resize(m_vEdges.size(), WALL_EDGE_WEIGHT);
     }
 
-    int partGraphByMetis(int32_t nParts);
+    int partGraphKway(int32_t nParts); //built-in multilevel k-way partitioner (partGraph.cpp)
+    int planSubNtks(vector<vector<CioOrigin>>& vvCiOrigins, vector<vector<CioOrigin>>& vvCoOrigins);
     Abc_Ntk_t* initOneSubNtk(int index);
-    int createSubNtksFromPartition(vector<Abc_Ntk_t*>& vSubNtks);
+    Abc_Ntk_t* extractOneSubNtk(int index);
+    int createSubNtksFromPartition(vector<Abc_Ntk_t*>& vSubNtks, vector<vector<CioOrigin>>& vvCiOrigins, vector<vector<CioOrigin>>& vvCoOrigins);
 
     void tmp();
     int computeNodeWeightByLevel(int leftChildLevel, int rightChildLevel);
@@ -67,20 +81,46 @@ public:
     void setPoPart();
     void set_sCluster(uint32_t size) { m_sCluster = size; };
     uint32_t get_sCluster() { return m_sCluster; };
+    void set_nThreads(uint32_t nThreads) { m_nThreads = nThreads; };
+    uint32_t get_nThreads() { return m_nThreads; };
+    void set_fringe(int32_t nLevels, int32_t nLeaves) { m_nFringeLevels = nLevels; m_nFringeLeaves = nLeaves; };
+    vector<uint64_t> nodeHashes(); //structural hash of each node, independent of the node ids
+    void getPartition(unordered_map<uint64_t, int32_t>& mNodeParts);
+    int32_t reusePartition(const unordered_map<uint64_t, int32_t>& mNodeParts, int32_t nParts);
 
 private:
+    int32_t planFringe(int32_t iNode, const vector<char>& vCutSource);
+    int planFringeUse(int32_t iNode, const vector<char>& vCutSource);
+    Abc_Obj_t* replicateFringe(Abc_Ntk_t* pNtk, int index, int32_t iNode, unordered_map<int32_t, Abc_Obj_t*>& mReplicas, unordered_map<int32_t, Abc_Obj_t*>& mLeaves);
+
     const int MAX_NODE_WEIGHT = 1; 
     const int MAX_EDGE_WEIGHT_FOR_NODE = 150; 
     const int MIN_EDGE_WEIGHT_FOR_NODE = 10; 
     const int WALL_EDGE_WEIGHT = 10000; //wall to prevent metis to cut the edge 
     const int WALL_THRESHOLD = 20; //threshold of slack to generate wall
-    const int METIS_UFACTOR = 30;
+    const int METIS_UFACTOR = 30; //allowed imbalance of a part, in 1/1000
+    const int KWAY_COARSEN_TO = 30; //stop coarsening at about this many nodes per part
+    const int KWAY_MAX_LEVELS = 40;
+    const int KWAY_N_INIT_TRIES = 4;
+    const int KWAY_N_PASSES = 8; //FM passes per level
+    const int KWAY_FM_NO_GAIN = 100; //moves without improvement before an FM pass stops
     Abc_Ntk_t* m_pNtkOrigin;
     vector<Abc_Obj_t*> m_vpObjs; //nodeId -> pObj in origin Ntk
     vector<Abc_Obj_t*> m_vpObjsNew; //nodeId -> pObj in SubNtks
+    vector<int32_t> m_vCioIds; //nodeId -> CI/CO index in origin Ntk
+    vector<int32_t> m_vCioIdsNew; //nodeId -> CI index in its SubNtk, or CO index of its cut-caused PO
+    vector<vector<int32_t>> m_vvPartNodes; //part -> its nodes in DFS order
+    vector<vector<int32_t>> m_vvCutPoNodes; //part -> nodes driving its cut-caused POs
+    int32_t m_nFringeLevels = 0; //levels of the fanin logic of a cut edge replicated into the part reading it, 0 for none
+    int32_t m_nFringeLeaves = 0; //max leaves of a replicated fringe
+    vector<int32_t> m_vFringeIds; //nodeId -> its fringe, -1 if not planned
+    vector<vector<int32_t>> m_vvFringeNodes; //fringe -> its AND nodes in DFS order, the root last; empty if it cannot grow
+    vector<vector<int32_t>> m_vvFringeLeaves; //fringe -> its leaves in increasing order
+    vector<uint8_t> m_vFringeUse; //nodeId -> bit k is set if fanin k is read through its fringe
     vector<int32_t> m_vNodeWeights;
     vector<int32_t> m_vEdgeWeights;
     uint32_t m_sCluster;
+    uint32_t m_nThreads;
 };
 
 class Edge {
@@ -92,21 +132,24 @@ public:
 
 class Cone {
 public:
-    Cone(int32_t lev, int32_t nodeId) : iMaxLevel(lev), iPoId(nodeId), iId(0){};
+    Cone(int32_t lev, int32_t nodeId) : iMaxLevel(lev), iPoId(nodeId), iId(0), iEdgeBeg(0), iEdgeEnd(0), iAdjBeg(0), iAdjEnd(0){};
+    int32_t nBoundaryEdges() const { return iEdgeEnd - iEdgeBeg; }
+    int32_t nAdjacentCones() const { return iAdjEnd - iAdjBeg; }
 	int32_t iMaxLevel;
 	int32_t iPoId;
     int32_t iId;
-	vector<Edge> vBoundaryEdges;
-    set<int32_t> sAdjacentConeId;
+	int32_t iEdgeBeg, iEdgeEnd; //range of its boundary edges in MetisAig::m_vBoundaryEdges
+	int32_t iAdjBeg, iAdjEnd; //range of its sorted adjacent cone ids in MetisAig::m_vAdjacentConeIds
 };
 
 class Cluster {
 public: 
     Cluster() = default;
-    Cluster(int32_t id, int32_t lev):iId(id), iMaxLevel(lev), iWorkload(0), nNodes(0), iPartitionId(-1) {};
+    Cluster(int32_t id, int32_t lev):iId(id), iMaxLevel(lev), iWorkload(0), iCutLoad(0), nNodes(0), iPartitionId(-1) {};
     int32_t iId;
 	int32_t iMaxLevel;
-	int32_t iWorkload;
+	int32_t iWorkload; //predicted mapping cost, see PifCostModel
+	int32_t iCutLoad; //sum of the estimated cut numbers of its nodes
     int32_t nNodes; //excluding PI/PO
     int32_t iPartitionId;
 	vector<int32_t> vConeIds;
@@ -114,30 +157,72 @@ public:
 
 class Partition {
 public:
-    Partition(): iWorkload(0), nNodes(0) {};
+    Partition(): iWorkload(0), iCutLoad(0), nNodes(0) {};
     void addCluster(Cluster& cluster){
         iWorkload += cluster.iWorkload;
+        iCutLoad += cluster.iCutLoad;
         nNodes += cluster.nNodes;
         vClusterIds.push_back(cluster.iId);
     };
     int32_t iWorkload;
+    int32_t iCutLoad;
     int32_t nNodes;
     vector<int32_t> vClusterIds;
 };
 
+//Mapping time of a part in microseconds of thread CPU time, predicted from its cut load and
+//its number of AND nodes: t = a * cutLoad + b * nNodes. a and b are fitted by least squares
+//on the parts mapped with pif -C. The sums of the normal equations are kept in a file next
+//to the DSD library, so that every calibration run refines the same model.
+class PifCostModel {
+public:
+    PifCostModel() : nSamples(0), sLL(0), sLN(0), sNN(0), sLT(0), sNT(0), a(0), b(0) {};
+    bool load(const string& fileName);
+    bool save(const string& fileName) const;
+    void addSample(double cutLoad, double nNodes, double time);
+    bool fit(); //false if the samples do not determine the model
+    bool isFitted() const { return a > 0 || b > 0; }
+    int32_t predict(int32_t cutLoad, int32_t nNodes) const;
+    int32_t nSamples;
+    double sLL, sLN, sNN, sLT, sNT;
+    double a, b;
+};
+
+//What a pif -E run leaves for the next one, so that an ECO only re-maps the parts it
+//touches: the part of every node, keyed by its structural hash, and the mapped network
+//of every part with the timing it published, keyed by the fingerprint of the part.
+class PifEcoCache {
+public:
+    class Part {
+    public:
+        Abc_Ntk_t* pNtkMapped;
+        float delay;
+        vector<float> vCoArrs; //arrival time of each CO, used for the cut-caused POs
+    };
+    PifEcoCache() : nParts(0) {};
+    ~PifEcoCache() { clear(); }
+    void clear();
+    string settings; //the library and the options the parts were made with, see PartNtk::ecoSettings()
+    int32_t nParts;
+    unordered_map<uint64_t, int32_t> mNodeParts;
+    unordered_map<uint64_t, Part> mParts;
+};
+
 class MetisAig : public Yaig //for analysing the original NTK
 {
 public:
-    MetisAig() : m_pMG(NULL) {} ;
+    MetisAig() : m_pMG(NULL), m_pCostModel(NULL) {} ;
     ~MetisAig() = default;
     void bindGraph(MetisGraph* pmg);
 
     void parseAig();
-	void visitAllFaninFromNode(int32_t nodeId, Cone& cone); //set node.iIter equal to m_iGlobalIter
-    void findBoundaryEdges(Cone& cone);
-    void findBoundaryEdges_rec(Cone& cone, int32_t nodeId, int32_t fCovered);
+    void assignConeIds(); //set node.iConeId and node.nVisits of all the nodes
+    void findBoundaryEdges(Cone& cone, vector<Edge>& vEdges, vector<int32_t>& vAdjacentConeIds, vector<int32_t>& vStack);
+    int32_t checkBoundaryEdge(Cone& cone, int32_t faninId, int32_t fanoutId, int32_t fCovered, vector<Edge>& vEdges, vector<int32_t>& vAdjacentConeIds);
     void computeWorkLoad(Cluster& cluster);
-    int32_t computeWorkLoad_rec(int32_t nodeId, int32_t& workload, int32_t& nNodes);
+    void computeWorkLoad(Cluster& cluster, vector<int32_t>& vStack);
+    void computeConeWorkLoad(int32_t poId, int32_t& workload, int32_t& nNodes, vector<int32_t>& vStack);
+    int32_t parallelFor(int32_t n, const function<void(int32_t, vector<int32_t>&)>& f);
     int32_t decideNumParts();
     int32_t partBiggestClusterByPICut(int32_t clusterId);
     int32_t partBiggestCluster(int32_t clusterId, int32_t workLoadLimit);
@@ -145,10 +230,15 @@ public:
     int32_t tryPart(); //A-B-C
     int32_t tryPart2(); //from critical
     int32_t partitionAig();
+    const vector<int32_t>& getPartWorkloads() { return m_vPartWorkloads; }
+    const vector<int32_t>& getPartCutLoads() { return m_vPartCutLoads; }
+    const vector<int32_t>& getPartNodes() { return m_vPartNodes; }
+    void setCostModel(const PifCostModel* pModel) { m_pCostModel = pModel; }
     void mergeSmallClusters(uint32_t size);
     void setGraphPartition(Cluster& cluster, int32_t partId);
     void setNodePartition(int32_t nodeId, int32_t partId);
     void visitConeForEdgeWight(int32_t nodeId, int32_t coneId);
+    void setConeEdgeWeights(Node& node);
 
     void printCones();
     void printOneCone(int32_t coneId);
@@ -164,18 +254,29 @@ private:
     const int32_t MAX_N_PART = 20;
     const int32_t METIS_N_PART = 4;
     const int32_t CRITICAL_PATH_FACTOR = 50;
+    const int32_t PARTS_PER_THREAD = 4; //keep parts finer than the pool for load balancing
+    const int32_t CONE_CHUNKS_PER_THREAD = 16; //cone chunks handed to each worker in parseAig
 
     MetisGraph* m_pMG;
     vector<Cone> m_vCones;
+    vector<Edge> m_vBoundaryEdges; //boundary edges of all the cones, cone by cone
+    vector<int32_t> m_vAdjacentConeIds; //adjacent cone ids of all the cones, cone by cone
+    vector<int32_t> m_vStack; //explicit DFS stack of node ids; some traversals keep a flag in bit 0
     vector<Cluster> m_vClusters;
     int32_t m_iTotalWorkLoad;
     int32_t m_iMaxClusterWorkLoad;
 
     vector<int> m_vConeId2ClusterId;
+    const PifCostModel* m_pCostModel; //the workload is the predicted time if not NULL
+    vector<int32_t> m_vPartWorkloads;
+    vector<int32_t> m_vPartCutLoads;
+    vector<int32_t> m_vPartNodes;
 };
 
 
-Abc_Ntk_t * Abc_NtkMerge( Abc_Ntk_t * pNtk, Vec_Ptr_t * pSubNtksOld, Vec_Ptr_t * pSubNtksNew);
+Abc_Ntk_t * Abc_NtkMerge( Abc_Ntk_t * pNtk, Vec_Ptr_t * pSubNtksNew, const vector<vector<CioOrigin>>& vvCiOrigins, const vector<vector<CioOrigin>>& vvCoOrigins);
+unsigned Abc_NtkPifSignature( Abc_Ntk_t * pNtk );
+uint64_t Abc_NtkPifFingerprint( Abc_Ntk_t * pNtk );
 Abc_Ntk_t* Abc_NtkExtractCriticalPath(Abc_Ntk_t* pNtk, Abc_Obj_t* pCos);
 Abc_Obj_t* Abc_NtkPickCriticalPo(Abc_Ntk_t* pNtk);
 
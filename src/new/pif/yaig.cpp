@@ -170,16 +170,26 @@ void Yaig::printOneNode(Node& node)
 int32_t Yaig::computeAllLevel()
 {
 	ylog("Now in computeAllLevel()\n");
-	int level;
-	//使用 setNextIter() 函数设置遍历顺序
-	setNextIter();
-	//对于每个输出节点，计算其输入节点的级别并更新该输出节点的级别
-	for(auto po : m_vPos)
+	//节点总是在其输入节点之后创建，按id顺序遍历一次即可
+	for(auto& node : m_vNodes)
 	{
-		level = computeNodeLevel(m_vNodes[po].getFanin0Id());
-		m_vNodes[po].iLevel = level;
-		if(level > m_iMaxLevel)
-			m_iMaxLevel = level;
+		if(node.isPi())
+		{
+			node.iLevel = 0;
+			continue;
+		}
+		Node& fanin0 = m_vNodes[node.getFanin0Id()];
+		yassert(fanin0.id < node.id);
+		if(node.isPo())
+		{
+			node.iLevel = fanin0.iLevel;
+			if(node.iLevel > m_iMaxLevel)
+				m_iMaxLevel = node.iLevel;
+			continue;
+		}
+		Node& fanin1 = m_vNodes[node.getFanin1Id()];
+		yassert(fanin1.id < node.id);
+		node.iLevel = 1 + ((fanin0.iLevel < fanin1.iLevel) ? fanin1.iLevel : fanin0.iLevel);
 	}
 	ylog("MaxLevel: %d\n", m_iMaxLevel);
 	return m_iMaxLevel;
@@ -87,10 +87,16 @@ extern void          Abc_TtHieManStop(Abc_TtHieMan_t * p );
 extern unsigned      Abc_TtCanonicizeWrap(TtCanonicizeFunc func, Abc_TtHieMan_t * p, word * pTruth, int nVars, char * pCanonPerm, int flag);
 extern unsigned      Abc_TtCanonicizeAda(Abc_TtHieMan_t * p, word * pTruth, int nVars, char * pCanonPerm, int iThres);
 extern unsigned      Abc_TtCanonicizeHie(Abc_TtHieMan_t * p, word * pTruthInit, int nVars, char * pCanonPerm, int fExact);
+/*=== dauCache.c ==========================================================*/
+extern unsigned      Abc_TtCanonicizeCache( word * pTruth, int nVars, char * pCanonPerm );
+extern void          Abc_TtCachePrintStats();
+extern void          Abc_TtCacheGlobalStop();
+/*=== dauCanonBatch.c ==========================================================*/
+extern int           Abc_TtCanonicizeBatch( word * pTruths, int nFuncs, int nVars, char * pPerms, unsigned * pPhases, int nThreads, int fCheck );
 /*=== dauCount.c ==========================================================*/
 extern int           Abc_TtCountOnesInCofsQuick( word * pTruth, int nVars, int * pStore );
 /*=== dauDsd.c  ==========================================================*/
-extern int *         Dau_DsdComputeMatches( char * p );
+extern int *         Dau_DsdComputeMatches( char * p, int * pMatches );
 extern int           Dau_DsdDecompose( word * pTruth, int nVarsInit, int fSplitPrime, int fWriteTruth, char * pRes );
 extern int           Dau_DsdDecomposeLevel( word * pTruth, int nVarsInit, int fSplitPrime, int fWriteTruth, char * pRes, int * pVarLevels );
 extern void          Dau_DsdPrintFromTruthFile( FILE * pFile, word * pTruth, int nVarsInit );
@@ -0,0 +1,387 @@
+/**CFile****************************************************************
+
+  FileName    [dauCache.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [DAG-aware unmapping.]
+
+  Synopsis    [Process-wide concurrent cache of semi-canonical forms.]
+
+  Author      [ymc]
+
+  Affiliation []
+
+  Date        [Ver. 1.0. Started - October 17, 2026.]
+
+  Revision    [$Id: dauCache.c,v 1.00 2026/10/17 00:00:00 ymc Exp $]
+
+***********************************************************************/
+
+#include "dauInt.h"
+#include "misc/util/utilTruth.h"
+
+#ifdef ABC_USE_PTHREADS
+
+#ifdef _WIN32
+#include "../lib/pthread.h"
+#else
+#include <pthread.h>
+#endif
+
+#endif
+
+ABC_NAMESPACE_IMPL_START
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+// Abc_TtCanonicize() is a pure function of the truth table, so its results
+// can be shared by all the callers in the process (mappers, DSD, rewriting)
+// and all their threads. There is one cache for each number of variables,
+// created on first use and freed when the frame is deallocated.
+//
+// A cache is a bounded set-associative table. The sets are grouped into
+// shards, each with a lock serializing the writers. Readers take no locks:
+// every entry has a sequence number, odd while the entry is written, and
+// a reader retries (treats the entry as a miss) if the number changed
+// while it copied the entry. Eviction follows the CLOCK policy inside a
+// set: a hit sets the reference bit of the entry, and the hand of the set
+// clears the bits until it finds an entry without one.
+
+#define DAU_CACHE_WAYS       4              // entries per set
+#define DAU_CACHE_SHARD_LOG  6              // 64 shards
+#define DAU_CACHE_BYTES      (1 << 22)      // the max size of one cache in bytes
+
+typedef struct Dau_CacheEntry_t_ Dau_CacheEntry_t;
+struct Dau_CacheEntry_t_
+{
+    unsigned           Seq;           // odd while the entry is written
+    unsigned           Hash;          // the hash value of the key
+    unsigned           Phase;         // the phase returned by Abc_TtCanonicize()
+    unsigned char      fUsed;         // the entry is used
+    unsigned char      fRef;          // the reference bit of CLOCK
+    char               Perm[16];      // the permutation returned by Abc_TtCanonicize()
+    word               Data[0];       // the key followed by the semi-canonical form
+};
+
+typedef struct Dau_CacheShard_t_ Dau_CacheShard_t;
+struct Dau_CacheShard_t_
+{
+    word               nHits;         // the number of lookups finding the entry
+    word               nMisses;       // the number of lookups not finding the entry
+    word               nEvicts;       // the number of entries replaced
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_t    Mutex;         // serializes the writers
+#endif
+};
+
+typedef struct Dau_Cache_t_ Dau_Cache_t;
+struct Dau_Cache_t_
+{
+    int                nVars;         // the number of variables
+    int                nWords;        // the number of words in a truth table
+    int                nEntryBytes;   // the size of an entry
+    int                nSets;         // the number of sets (power of 2)
+    unsigned char *    pHands;        // the CLOCK hand of each set
+    char *             pEntries;      // the entries, set by set
+    Dau_CacheShard_t * pShards;       // the shards
+};
+
+static Dau_Cache_t * s_TtCaches[17] = { NULL };
+
+#ifdef ABC_USE_PTHREADS
+static pthread_mutex_t s_TtCacheMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+/**Function*************************************************************
+
+  Synopsis    [Helpers.]
+
+  Description []
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static inline unsigned Dau_CacheHash( word * pTruth, int nWords )
+{
+    word Key = 0;
+    int i;
+    for ( i = 0; i < nWords; i++ )
+        Key = (Key ^ pTruth[i]) * ABC_CONST(0x9E3779B97F4A7C15);
+    return (unsigned)(Key >> 32) ^ (unsigned)Key;
+}
+static inline Dau_CacheEntry_t * Dau_CacheEntry( Dau_Cache_t * p, int iSet, int iWay )
+{
+    return (Dau_CacheEntry_t *)(p->pEntries + (size_t)(iSet * DAU_CACHE_WAYS + iWay) * p->nEntryBytes);
+}
+static inline Dau_CacheShard_t * Dau_CacheShard( Dau_Cache_t * p, int iSet )
+{
+    return p->pShards + (iSet & ((1 << DAU_CACHE_SHARD_LOG) - 1));
+}
+// the counters are approximate when the cache is used concurrently
+static inline void Dau_CacheCount( word * pCounter )
+{
+    __atomic_store_n( pCounter, __atomic_load_n(pCounter, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Returns the cache for the given number of variables.]
+
+  Description [Creates it on first use.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static Dau_Cache_t * Dau_CacheAlloc( int nVars )
+{
+    Dau_Cache_t * p = ABC_CALLOC( Dau_Cache_t, 1 );
+    int i;
+    p->nVars       = nVars;
+    p->nWords      = Abc_TtWordNum( nVars );
+    p->nEntryBytes = sizeof(Dau_CacheEntry_t) + 2 * sizeof(word) * p->nWords;
+    for ( p->nSets = 1 << DAU_CACHE_SHARD_LOG; 2 * p->nSets * DAU_CACHE_WAYS * p->nEntryBytes <= DAU_CACHE_BYTES; p->nSets *= 2 );
+    p->pHands   = ABC_CALLOC( unsigned char, p->nSets );
+    p->pEntries = ABC_CALLOC( char, (size_t)p->nSets * DAU_CACHE_WAYS * p->nEntryBytes );
+    p->pShards  = ABC_CALLOC( Dau_CacheShard_t, 1 << DAU_CACHE_SHARD_LOG );
+#ifdef ABC_USE_PTHREADS
+    for ( i = 0; i < (1 << DAU_CACHE_SHARD_LOG); i++ )
+        pthread_mutex_init( &p->pShards[i].Mutex, NULL );
+#endif
+    (void)i;
+    return p;
+}
+static inline Dau_Cache_t * Dau_CacheGet( int nVars )
+{
+    Dau_Cache_t * p = __atomic_load_n( &s_TtCaches[nVars], __ATOMIC_ACQUIRE );
+    if ( p )
+        return p;
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_lock( &s_TtCacheMutex );
+#endif
+    if ( (p = s_TtCaches[nVars]) == NULL )
+    {
+        p = Dau_CacheAlloc( nVars );
+        __atomic_store_n( &s_TtCaches[nVars], p, __ATOMIC_RELEASE );
+    }
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_unlock( &s_TtCacheMutex );
+#endif
+    return p;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Looks up the truth table in a set.]
+
+  Description [Returns 1 and copies the result if found. Takes no locks.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static int Dau_CacheLookup( Dau_Cache_t * p, int iSet, unsigned Hash, word * pTruth, word * pCanon, unsigned * puPhase, char * pPerm )
+{
+    Dau_CacheEntry_t * pEntry;
+    unsigned Seq;
+    int k;
+    for ( k = 0; k < DAU_CACHE_WAYS; k++ )
+    {
+        pEntry = Dau_CacheEntry( p, iSet, k );
+        Seq = __atomic_load_n( &pEntry->Seq, __ATOMIC_ACQUIRE );
+        if ( (Seq & 1) || !pEntry->fUsed || pEntry->Hash != Hash )
+            continue;
+        if ( memcmp(pEntry->Data, pTruth, sizeof(word) * p->nWords) )
+            continue;
+        memcpy( pCanon, pEntry->Data + p->nWords, sizeof(word) * p->nWords );
+        memcpy( pPerm, pEntry->Perm, 16 );
+        *puPhase = pEntry->Phase;
+        __atomic_thread_fence( __ATOMIC_ACQUIRE );
+        if ( __atomic_load_n( &pEntry->Seq, __ATOMIC_RELAXED ) != Seq )
+            continue;
+        if ( !__atomic_load_n( &pEntry->fRef, __ATOMIC_RELAXED ) )
+            __atomic_store_n( &pEntry->fRef, 1, __ATOMIC_RELAXED );
+        return 1;
+    }
+    return 0;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Inserts the result into a set.]
+
+  Description [Called with the shard locked. Uses a free entry or evicts
+  the one chosen by the CLOCK hand of the set.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static void Dau_CacheInsert( Dau_Cache_t * p, int iSet, unsigned Hash, word * pTruth, word * pCanon, unsigned uPhase, char * pPerm )
+{
+    Dau_CacheEntry_t * pEntry = NULL;
+    int k;
+    for ( k = 0; k < DAU_CACHE_WAYS; k++ )
+    {
+        pEntry = Dau_CacheEntry( p, iSet, k );
+        if ( !pEntry->fUsed )
+            break;
+        // another thread may have inserted it
+        if ( pEntry->Hash == Hash && !memcmp(pEntry->Data, pTruth, sizeof(word) * p->nWords) )
+            return;
+    }
+    if ( k == DAU_CACHE_WAYS )
+    {
+        for ( ; ; p->pHands[iSet] = (p->pHands[iSet] + 1) % DAU_CACHE_WAYS )
+        {
+            pEntry = Dau_CacheEntry( p, iSet, p->pHands[iSet] );
+            if ( !__atomic_load_n( &pEntry->fRef, __ATOMIC_RELAXED ) )
+                break;
+            __atomic_store_n( &pEntry->fRef, 0, __ATOMIC_RELAXED );
+        }
+        p->pHands[iSet] = (p->pHands[iSet] + 1) % DAU_CACHE_WAYS;
+        Dau_CacheCount( &Dau_CacheShard(p, iSet)->nEvicts );
+    }
+    __atomic_store_n( &pEntry->Seq, pEntry->Seq + 1, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+    pEntry->Hash  = Hash;
+    pEntry->Phase = uPhase;
+    pEntry->fUsed = 1;
+    __atomic_store_n( &pEntry->fRef, 0, __ATOMIC_RELAXED );
+    memcpy( pEntry->Perm, pPerm, 16 );
+    memcpy( pEntry->Data, pTruth, sizeof(word) * p->nWords );
+    memcpy( pEntry->Data + p->nWords, pCanon, sizeof(word) * p->nWords );
+    __atomic_store_n( &pEntry->Seq, pEntry->Seq + 1, __ATOMIC_RELEASE );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Semi-canonical form computation using the shared cache.]
+
+  Description [Same interface and results as Abc_TtCanonicize(). Safe to
+  call from several threads.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+unsigned Abc_TtCanonicizeCache( word * pTruth, int nVars, char * pCanonPerm )
+{
+    word pKey[1024];
+    char pPerm[16];
+    unsigned uPhase, Hash;
+    Dau_Cache_t * p;
+    Dau_CacheShard_t * pShard;
+    int iSet;
+    assert( nVars <= 16 );
+    p = Dau_CacheGet( nVars );
+    Hash   = Dau_CacheHash( pTruth, p->nWords );
+    iSet   = Hash & (p->nSets - 1);
+    pShard = Dau_CacheShard( p, iSet );
+    if ( Dau_CacheLookup( p, iSet, Hash, pTruth, pKey, &uPhase, pPerm ) )
+    {
+        Dau_CacheCount( &pShard->nHits );
+        memcpy( pTruth, pKey, sizeof(word) * p->nWords );
+        memcpy( pCanonPerm, pPerm, nVars );
+        return uPhase;
+    }
+    Dau_CacheCount( &pShard->nMisses );
+    memcpy( pKey, pTruth, sizeof(word) * p->nWords );
+    memset( pPerm, 0, 16 );
+    uPhase = Abc_TtCanonicize( pTruth, nVars, pPerm );
+    memcpy( pCanonPerm, pPerm, nVars );
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_lock( &pShard->Mutex );
+#endif
+    Dau_CacheInsert( p, iSet, Hash, pKey, pTruth, uPhase, pPerm );
+#ifdef ABC_USE_PTHREADS
+    pthread_mutex_unlock( &pShard->Mutex );
+#endif
+    return uPhase;
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Reports the statistics of the caches.]
+
+  Description []
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void Abc_TtCachePrintStats()
+{
+    Dau_Cache_t * p;
+    word nHits, nMisses, nEvicts;
+    int v, i;
+    for ( v = 0; v <= 16; v++ )
+    {
+        if ( (p = __atomic_load_n( &s_TtCaches[v], __ATOMIC_ACQUIRE )) == NULL )
+            continue;
+        nHits = nMisses = nEvicts = 0;
+        for ( i = 0; i < (1 << DAU_CACHE_SHARD_LOG); i++ )
+        {
+            nHits   += p->pShards[i].nHits;
+            nMisses += p->pShards[i].nMisses;
+            nEvicts += p->pShards[i].nEvicts;
+        }
+        printf( "Canon cache %2d: Entries = %8d  Hits = %10.0f  Misses = %10.0f (%6.2f %% hits)  Evictions = %10.0f  Memory = %7.2f MB\n",
+            v, p->nSets * DAU_CACHE_WAYS, (double)nHits, (double)nMisses, nHits + nMisses ? 100.0 * nHits / (nHits + nMisses) : 0.0,
+            (double)nEvicts, 1.0 * p->nSets * DAU_CACHE_WAYS * p->nEntryBytes / (1<<20) );
+    }
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Frees the caches.]
+
+  Description [Should be called when no other thread uses them.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+void Abc_TtCacheGlobalStop()
+{
+    Dau_Cache_t * p;
+    int v, i;
+    for ( v = 0; v <= 16; v++ )
+    {
+        if ( (p = s_TtCaches[v]) == NULL )
+            continue;
+#ifdef ABC_USE_PTHREADS
+        for ( i = 0; i < (1 << DAU_CACHE_SHARD_LOG); i++ )
+            pthread_mutex_destroy( &p->pShards[i].Mutex );
+#endif
+        (void)i;
+        ABC_FREE( p->pHands );
+        ABC_FREE( p->pEntries );
+        ABC_FREE( p->pShards );
+        ABC_FREE( p );
+        s_TtCaches[v] = NULL;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
+
+
+ABC_NAMESPACE_IMPL_END
+
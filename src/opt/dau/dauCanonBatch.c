@@ -0,0 +1,410 @@
+/**CFile****************************************************************
+
+  FileName    [dauCanonBatch.c]
+
+  SystemName  [ABC: Logic synthesis and verification system.]
+
+  PackageName [DAG-aware unmapping.]
+
+  Synopsis    [Canonical form computation for arrays of functions.]
+
+  Author      [ymc]
+
+  Affiliation []
+
+  Date        [Ver. 1.0. Started - October 17, 2026.]
+
+  Revision    [$Id: dauCanonBatch.c,v 1.00 2026/10/17 00:00:00 ymc Exp $]
+
+***********************************************************************/
+
+#include "dauInt.h"
+#include "misc/util/utilTruth.h"
+
+// the lanes are compiled for AVX2 and used if the CPU supports it
+#if defined(__AVX2__) || ((defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && !defined(ABC_USE_NO_AVX2))
+#define DAU_BATCH_AVX2
+#include <immintrin.h>
+#endif
+
+#ifdef ABC_USE_PTHREADS
+
+#ifdef _WIN32
+#include "../lib/pthread.h"
+#else
+#include <pthread.h>
+#endif
+
+#endif
+
+ABC_NAMESPACE_IMPL_START
+
+////////////////////////////////////////////////////////////////////////
+///                        DECLARATIONS                              ///
+////////////////////////////////////////////////////////////////////////
+
+// The batch computes the same semi-canonical form as Abc_TtCanonicize().
+// With AVX2, the functions of up to 6 variables are processed four at a
+// time: each 64-bit lane holds the truth table, the phase, the permutation
+// (4 bits per variable) and the cofactor counts of one function, and the
+// data-dependent decisions of the scalar code (polarity, phase, selection
+// sort of variables, cofactor permutations) become lane masks. The larger
+// functions, and all functions on CPUs without AVX2, use the scalar code.
+// The lanes are compiled with a function-level target, so the default
+// build uses them when the CPU supports AVX2 (ABC_USE_NO_AVX2 disables them).
+
+#define DAU_BATCH_THR_MAX  64
+
+typedef struct Dau_BatchThr_t_ Dau_BatchThr_t;
+struct Dau_BatchThr_t_
+{
+    word *             pTruths;       // the truth tables of the shard
+    char *             pPerms;        // the permutations of the shard
+    unsigned *         pPhases;       // the phases of the shard
+    int                nFuncs;        // the number of functions in the shard
+    int                nVars;         // the number of variables
+    int                fCheck;        // compares with the scalar code
+    int                nFails;        // the number of functions that differ
+};
+
+////////////////////////////////////////////////////////////////////////
+///                     FUNCTION DEFINITIONS                         ///
+////////////////////////////////////////////////////////////////////////
+
+#ifdef DAU_BATCH_AVX2
+
+#ifdef __AVX2__
+#define DAU_AVX2
+#else
+#define DAU_AVX2 __attribute__((target("avx2")))
+#endif
+
+/**Function*************************************************************
+
+  Synopsis    [Lane-wise operations on four 6-variable functions.]
+
+  Description [Masks have all bits of a lane set or cleared.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static inline DAU_AVX2 __m256i Dau_Lanes( word w )                                { return _mm256_set1_epi64x( (long long)w );                          }
+static inline DAU_AVX2 __m256i Dau_LanesShl( __m256i x, int s )                   { return _mm256_sll_epi64( x, _mm_cvtsi32_si128(s) );                 }
+static inline DAU_AVX2 __m256i Dau_LanesShr( __m256i x, int s )                   { return _mm256_srl_epi64( x, _mm_cvtsi32_si128(s) );                 }
+static inline DAU_AVX2 __m256i Dau_LanesMux( __m256i m, __m256i a, __m256i b )    { return _mm256_blendv_epi8( b, a, m );                               }
+static inline DAU_AVX2 __m256i Dau_LanesNonZero( __m256i x )                      { return _mm256_xor_si256( _mm256_cmpeq_epi64(x, _mm256_setzero_si256()), _mm256_set1_epi64x(-1) ); }
+static inline DAU_AVX2 __m256i Dau_LanesGreaterU( __m256i a, __m256i b )
+{
+    __m256i Sign = Dau_Lanes( ABC_CONST(0x8000000000000000) );
+    return _mm256_cmpgt_epi64( _mm256_xor_si256(a, Sign), _mm256_xor_si256(b, Sign) );
+}
+static inline DAU_AVX2 __m256i Dau_LanesCountOnes( __m256i x )
+{
+    __m256i Table = _mm256_setr_epi8( 0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4, 0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4 );
+    __m256i Mask  = _mm256_set1_epi8( 0x0F );
+    __m256i Lo    = _mm256_shuffle_epi8( Table, _mm256_and_si256(x, Mask) );
+    __m256i Hi    = _mm256_shuffle_epi8( Table, _mm256_and_si256(_mm256_srli_epi16(x, 4), Mask) );
+    return _mm256_sad_epu8( _mm256_add_epi8(Lo, Hi), _mm256_setzero_si256() );
+}
+static inline DAU_AVX2 __m256i Dau_LanesFlip( __m256i t, int iVar )
+{
+    __m256i Mask = Dau_Lanes( s_Truths6[iVar] );
+    return _mm256_or_si256( _mm256_and_si256(Dau_LanesShl(t, 1 << iVar), Mask), Dau_LanesShr(_mm256_and_si256(t, Mask), 1 << iVar) );
+}
+static inline DAU_AVX2 __m256i Dau_LanesSwapAdjacent( __m256i t, int iVar )
+{
+    return _mm256_or_si256( _mm256_and_si256(t, Dau_Lanes(s_PMasks[iVar][0])),
+           _mm256_or_si256( Dau_LanesShl(_mm256_and_si256(t, Dau_Lanes(s_PMasks[iVar][1])), 1 << iVar),
+                            Dau_LanesShr(_mm256_and_si256(t, Dau_Lanes(s_PMasks[iVar][2])), 1 << iVar) ) );
+}
+static inline DAU_AVX2 __m256i Dau_LanesSwapVars( __m256i t, int iVar, int jVar )
+{
+    word * pMasks = s_PPMasks[iVar][jVar];
+    int Shift = (1 << jVar) - (1 << iVar);
+    assert( iVar < jVar );
+    return _mm256_or_si256( _mm256_and_si256(t, Dau_Lanes(pMasks[0])),
+           _mm256_or_si256( Dau_LanesShl(_mm256_and_si256(t, Dau_Lanes(pMasks[1])), Shift),
+                            Dau_LanesShr(_mm256_and_si256(t, Dau_Lanes(pMasks[2])), Shift) ) );
+}
+// swaps the fields i and j of nBits bits
+static inline DAU_AVX2 __m256i Dau_LanesSwapFields( __m256i x, int i, int j, int nBits )
+{
+    __m256i Diff = _mm256_and_si256( _mm256_xor_si256(Dau_LanesShr(x, i * nBits), Dau_LanesShr(x, j * nBits)), Dau_Lanes((1 << nBits) - 1) );
+    return _mm256_xor_si256( x, _mm256_xor_si256(Dau_LanesShl(Diff, i * nBits), Dau_LanesShl(Diff, j * nBits)) );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Tries the cofactor permutations of variables i and i+1.]
+
+  Description [Follows Abc_TtCofactorPerm() for one-word functions in the
+  lanes of mask Care. Returns the mask of the lanes that changed.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static inline DAU_AVX2 __m256i Dau_LanesCofactorPerm( __m256i * pT, __m256i * pP, __m256i * pM, int i, __m256i Care, __m256i SwapOnly )
+{
+    __m256i T = *pT, Copy, Best, BestS, Config, ConfigS, Less, Mask;
+    // swap only
+    Copy    = Dau_LanesSwapAdjacent( T, i );
+    Less    = Dau_LanesGreaterU( T, Copy );
+    BestS   = Dau_LanesMux( Less, Copy, T );
+    ConfigS = _mm256_and_si256( Less, Dau_Lanes(4) );
+    // all eight configurations in the order of Abc_Tt6CofactorPermNaive()
+    Best = Copy = T; Config = _mm256_setzero_si256();
+    Copy = Dau_LanesFlip( Copy, i );          Less = Dau_LanesGreaterU( Best, Copy ); Best = Dau_LanesMux( Less, Copy, Best ); Config = Dau_LanesMux( Less, Dau_Lanes(1), Config );
+    Copy = Dau_LanesFlip( Copy, i+1 );        Less = Dau_LanesGreaterU( Best, Copy ); Best = Dau_LanesMux( Less, Copy, Best ); Config = Dau_LanesMux( Less, Dau_Lanes(3), Config );
+    Copy = Dau_LanesFlip( Copy, i );          Less = Dau_LanesGreaterU( Best, Copy ); Best = Dau_LanesMux( Less, Copy, Best ); Config = Dau_LanesMux( Less, Dau_Lanes(2), Config );
+    Copy = Dau_LanesSwapAdjacent( Copy, i );  Less = Dau_LanesGreaterU( Best, Copy ); Best = Dau_LanesMux( Less, Copy, Best ); Config = Dau_LanesMux( Less, Dau_Lanes(6), Config );
+    Copy = Dau_LanesFlip( Copy, i+1 );        Less = Dau_LanesGreaterU( Best, Copy ); Best = Dau_LanesMux( Less, Copy, Best ); Config = Dau_LanesMux( Less, Dau_Lanes(7), Config );
+    Copy = Dau_LanesFlip( Copy, i );          Less = Dau_LanesGreaterU( Best, Copy ); Best = Dau_LanesMux( Less, Copy, Best ); Config = Dau_LanesMux( Less, Dau_Lanes(5), Config );
+    Copy = Dau_LanesFlip( Copy, i+1 );        Less = Dau_LanesGreaterU( Best, Copy ); Best = Dau_LanesMux( Less, Copy, Best ); Config = Dau_LanesMux( Less, Dau_Lanes(4), Config );
+    // select the mode and the lanes
+    Best   = Dau_LanesMux( SwapOnly, BestS, Best );
+    Config = _mm256_and_si256( Care, Dau_LanesMux(SwapOnly, ConfigS, Config) );
+    *pT    = Dau_LanesMux( Care, Best, T );
+    // update the phase and the permutation
+    Mask   = Dau_LanesNonZero( _mm256_and_si256(Config, Dau_Lanes(1)) );
+    *pP    = _mm256_xor_si256( *pP, _mm256_and_si256(Mask, Dau_Lanes(1 << i)) );
+    Mask   = Dau_LanesNonZero( _mm256_and_si256(Config, Dau_Lanes(2)) );
+    *pP    = _mm256_xor_si256( *pP, _mm256_and_si256(Mask, Dau_Lanes(1 << (i+1))) );
+    Mask   = Dau_LanesNonZero( _mm256_and_si256(Config, Dau_Lanes(4)) );
+    *pP    = Dau_LanesMux( Mask, Dau_LanesSwapFields(*pP, i, i+1, 1), *pP );
+    *pM    = Dau_LanesMux( Mask, Dau_LanesSwapFields(*pM, i, i+1, 4), *pM );
+    return Dau_LanesNonZero( Config );
+}
+
+/**Function*************************************************************
+
+  Synopsis    [Computes the semi-canonical form of four functions.]
+
+  Description [The functions have up to 6 variables and are stored in
+  consecutive words. The result is the same as Abc_TtCanonicize().]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+static DAU_AVX2 void Dau_CanonicizeLanes( word * pTruths, int nVars, char * pPerms, unsigned * pPhases )
+{
+    __m256i S[7], T, P, M, N, Half, Mask, Care, Active, Changes, BestK, BestV;
+    word Perm = 0, pP[4], pM[4];
+    int i, k, v, nPasses;
+    assert( nVars <= 6 );
+    for ( i = 0; i < nVars; i++ )
+        Perm |= (word)i << (4 * i);
+    T = _mm256_loadu_si256( (__m256i *)pTruths );
+    P = _mm256_setzero_si256();
+    M = Dau_Lanes( Perm );
+    // normalize polarity
+    N    = Dau_LanesCountOnes( T );
+    Mask = _mm256_cmpgt_epi64( N, Dau_Lanes(32) );
+    T    = _mm256_xor_si256( T, Mask );
+    N    = Dau_LanesMux( Mask, _mm256_sub_epi64(Dau_Lanes(64), N), N );
+    P    = _mm256_and_si256( Mask, Dau_Lanes(1 << nVars) );
+    // normalize phase
+    for ( i = 0; i < nVars; i++ )
+        S[i] = Dau_LanesCountOnes( _mm256_and_si256(T, Dau_Lanes(s_Truths6Neg[i])) );
+    S[nVars] = N;
+    for ( i = 0; i < nVars; i++ )
+    {
+        __m256i Rest = _mm256_sub_epi64( N, S[i] );
+        Mask = _mm256_cmpgt_epi64( Rest, S[i] );
+        T    = Dau_LanesMux( Mask, Dau_LanesFlip(T, i), T );
+        P    = _mm256_or_si256( P, _mm256_and_si256(Mask, Dau_Lanes(1 << i)) );
+        S[i] = Dau_LanesMux( Mask, Rest, S[i] );
+    }
+    // normalize permutation by selection sort
+    for ( i = 0; i < nVars - 1; i++ )
+    {
+        BestK = Dau_Lanes( i + 1 );
+        BestV = S[i + 1];
+        for ( k = i + 2; k < nVars; k++ )
+        {
+            Mask  = _mm256_cmpgt_epi64( BestV, S[k] );
+            BestK = Dau_LanesMux( Mask, Dau_Lanes(k), BestK );
+            BestV = Dau_LanesMux( Mask, S[k], BestV );
+        }
+        Care = _mm256_cmpgt_epi64( S[i], BestV );
+        if ( _mm256_testz_si256(Care, Care) )
+            continue;
+        for ( k = i + 1; k < nVars; k++ )
+        {
+            Mask = _mm256_and_si256( Care, _mm256_cmpeq_epi64(BestK, Dau_Lanes(k)) );
+            if ( _mm256_testz_si256(Mask, Mask) )
+                continue;
+            M    = Dau_LanesMux( Mask, Dau_LanesSwapFields(M, i, k, 4), M );
+            P    = Dau_LanesMux( Mask, Dau_LanesSwapFields(P, i, k, 1), P );
+            T    = Dau_LanesMux( Mask, Dau_LanesSwapVars(T, i, k), T );
+            S[k] = Dau_LanesMux( Mask, S[i], S[k] );
+        }
+        S[i] = Dau_LanesMux( Care, BestV, S[i] );
+    }
+    // improve by cofactor permutations of the variables with equal counts
+    Half   = Dau_LanesShr( S[nVars], 1 );
+    Active = _mm256_set1_epi64x( -1 );
+    for ( k = 0; k < 5; k++ )
+    {
+        for ( nPasses = 0; nPasses < 2; nPasses++ )
+        {
+            Changes = _mm256_setzero_si256();
+            for ( v = 0; v < nVars - 1 - nPasses; v++ )
+            {
+                i = nPasses ? v + 1 : nVars - 2 - v;
+                Care = _mm256_and_si256( Active, _mm256_cmpeq_epi64(S[i], S[i+1]) );
+                if ( _mm256_testz_si256(Care, Care) )
+                    continue;
+                Mask = _mm256_xor_si256( _mm256_cmpeq_epi64(S[i], Half), _mm256_set1_epi64x(-1) );
+                Changes = _mm256_or_si256( Changes, Dau_LanesCofactorPerm(&T, &P, &M, i, Care, Mask) );
+            }
+            Active = _mm256_and_si256( Active, Changes );
+            if ( _mm256_testz_si256(Active, Active) )
+                break;
+        }
+        if ( nPasses < 2 )
+            break;
+    }
+    // save the results
+    _mm256_storeu_si256( (__m256i *)pTruths, T );
+    _mm256_storeu_si256( (__m256i *)pP, P );
+    _mm256_storeu_si256( (__m256i *)pM, M );
+    _mm256_zeroupper();
+    for ( k = 0; k < 4; k++ )
+    {
+        pPhases[k] = (unsigned)pP[k];
+        for ( i = 0; i < nVars; i++ )
+            pPerms[k * nVars + i] = (char)((pM[k] >> (4 * i)) & 15);
+    }
+}
+
+#endif
+
+/**Function*************************************************************
+
+  Synopsis    [Computes the semi-canonical forms of one shard.]
+
+  Description [If fCheck is set, compares the results with the scalar
+  code and returns the number of functions that differ.]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+#ifdef DAU_BATCH_AVX2
+static inline int Dau_CanonicizeHasAvx2()
+{
+#ifdef __AVX2__
+    return 1;
+#else
+    return __builtin_cpu_supports( "avx2" );
+#endif
+}
+#endif
+static int Dau_CanonicizeShard( word * pTruths, int nFuncs, int nVars, char * pPerms, unsigned * pPhases, int fCheck )
+{
+    int nWords = Abc_TtWordNum( nVars );
+    word * pCopy = fCheck ? ABC_ALLOC( word, nWords * nFuncs ) : NULL;
+    int i = 0, nFails = 0;
+    if ( pCopy )
+        memcpy( pCopy, pTruths, sizeof(word) * nWords * nFuncs );
+#ifdef DAU_BATCH_AVX2
+    if ( nVars <= 6 && Dau_CanonicizeHasAvx2() )
+        for ( ; i + 4 <= nFuncs; i += 4 )
+            Dau_CanonicizeLanes( pTruths + i, nVars, pPerms + i * nVars, pPhases + i );
+#endif
+    for ( ; i < nFuncs; i++ )
+        pPhases[i] = Abc_TtCanonicize( pTruths + i * nWords, nVars, pPerms + i * nVars );
+    if ( pCopy == NULL )
+        return 0;
+    for ( i = 0; i < nFuncs; i++ )
+    {
+        char pPerm[16];
+        unsigned uPhase = Abc_TtCanonicize( pCopy + i * nWords, nVars, pPerm );
+        if ( uPhase != pPhases[i] || memcmp(pPerm, pPerms + i * nVars, nVars) || !Abc_TtEqual(pCopy + i * nWords, pTruths + i * nWords, nWords) )
+            nFails++;
+    }
+    ABC_FREE( pCopy );
+    return nFails;
+}
+
+#ifdef ABC_USE_PTHREADS
+static void * Dau_CanonicizeWorker( void * pArg )
+{
+    Dau_BatchThr_t * pThr = (Dau_BatchThr_t *)pArg;
+    pThr->nFails = Dau_CanonicizeShard( pThr->pTruths, pThr->nFuncs, pThr->nVars, pThr->pPerms, pThr->pPhases, pThr->fCheck );
+    return NULL;
+}
+#endif
+
+/**Function*************************************************************
+
+  Synopsis    [Computes the semi-canonical forms of an array of functions.]
+
+  Description [The truth tables of nFuncs functions of nVars variables
+  (up to 16) are stored one after another and are canonicized in place.
+  The permutations (nVars chars per function) and the phases are the same
+  as those returned by Abc_TtCanonicize(). The array is split into nThreads
+  shards. If fCheck is set, each result is compared with the scalar code;
+  returns the number of functions that differ (0 if fCheck is not set).]
+
+  SideEffects []
+
+  SeeAlso     []
+
+***********************************************************************/
+int Abc_TtCanonicizeBatch( word * pTruths, int nFuncs, int nVars, char * pPerms, unsigned * pPhases, int nThreads, int fCheck )
+{
+    int nWords = Abc_TtWordNum( nVars );
+    assert( nVars <= 16 );
+#if defined(ABC_USE_PTHREADS) && defined(PIF_MULTITHREAD)
+    // the scalar code keeps its scratch tables on the stack only with PIF_MULTITHREAD
+    if ( nThreads > 1 && nFuncs >= 2 * nThreads )
+    {
+        Dau_BatchThr_t pThrs[DAU_BATCH_THR_MAX];
+        pthread_t WorkerThread[DAU_BATCH_THR_MAX];
+        char pStarted[DAU_BATCH_THR_MAX];
+        int i, Beg, End, nFails = 0;
+        nThreads = Abc_MinInt( nThreads, DAU_BATCH_THR_MAX );
+        for ( i = 0; i < nThreads; i++ )
+        {
+            // shards are multiples of four functions to keep the lanes full
+            Beg = (int)(4 * ((long long)nFuncs * i / nThreads / 4));
+            End = i == nThreads - 1 ? nFuncs : (int)(4 * ((long long)nFuncs * (i+1) / nThreads / 4));
+            pThrs[i].pTruths = pTruths + (long long)Beg * nWords;
+            pThrs[i].pPerms  = pPerms + (long long)Beg * nVars;
+            pThrs[i].pPhases = pPhases + Beg;
+            pThrs[i].nFuncs  = End - Beg;
+            pThrs[i].nVars   = nVars;
+            pThrs[i].fCheck  = fCheck;
+            pThrs[i].nFails  = 0;
+            // if the thread cannot be started, the shard is done here
+            pStarted[i] = (char)(pthread_create( WorkerThread + i, NULL, Dau_CanonicizeWorker, (void *)(pThrs + i) ) == 0);
+            if ( !pStarted[i] )
+                Dau_CanonicizeWorker( (void *)(pThrs + i) );
+        }
+        for ( i = 0; i < nThreads; i++ )
+        {
+            if ( pStarted[i] )
+                pthread_join( WorkerThread[i], NULL );
+            nFails += pThrs[i].nFails;
+        }
+        return nFails;
+    }
+#endif
+    return Dau_CanonicizeShard( pTruths, nFuncs, nVars, pPerms, pPhases, fCheck );
+}
+
+////////////////////////////////////////////////////////////////////////
+///                       END OF FILE                                ///
+////////////////////////////////////////////////////////////////////////
+
+
+ABC_NAMESPACE_IMPL_END
+
@@ -77,13 +77,8 @@ static inline word ** Dau_DsdTtElems()
   SeeAlso     []
 
 ***********************************************************************/
-int * Dau_DsdComputeMatches( char * p )
+int * Dau_DsdComputeMatches( char * p, int * pMatches )
 {
-#ifndef PIF_MULTITHREAD //ymc
-    static int pMatches[DAU_MAX_STR]; //static variables cause thread problem.
-#else
-    int* pMatches = (int*) malloc(sizeof(int)*strlen(p)*2);
-#endif
     int pNested[DAU_MAX_VAR];
     int v, nNested = 0;
     for ( v = 0; p[v]; v++ )
@@ -265,11 +260,9 @@ void Dau_DsdNormalize( char * pDsd )
 {
     if ( pDsd[1] != 0 )
     {
-        int* pMatch = Dau_DsdComputeMatches(pDsd);
+        int pMatch[DAU_MAX_STR];
+        Dau_DsdComputeMatches( pDsd, pMatch );
         Dau_DsdNormalize_rec( pDsd, &pDsd, pMatch);
-#ifdef PIF_MULTITHREAD //ymc
-        free(pMatch);
-#endif
     }
 }
 
@@ -327,11 +320,9 @@ int Dau_DsdCountAnds( char * pDsd )
 {
     if ( pDsd[1] == 0 )
         return 0;
-    int* pMatch = Dau_DsdComputeMatches(pDsd);
+    int pMatch[DAU_MAX_STR];
+    Dau_DsdComputeMatches( pDsd, pMatch );
     int res = Dau_DsdCountAnds_rec( pDsd, &pDsd, pMatch);
-#ifdef PIF_MULTITHREAD //ymc
-    free(pMatch);
-#endif
     return res;
 }
 
@@ -466,11 +457,9 @@ word Dau_Dsd6ToTruth( char * p )
         Res = ~(word)0;
     else
     {
-        int* pMatch = Dau_DsdComputeMatches(p);
+        int pMatch[DAU_MAX_STR];
+        Dau_DsdComputeMatches( p, pMatch );
         Res = Dau_Dsd6ToTruth_rec( p, &p, pMatch, s_Truths6 );
-#ifdef PIF_MULTITHREAD //ymc
-        free(pMatch);
-#endif
     }
     assert( *++p == 0 );
     return Res;
@@ -639,11 +628,9 @@ word * Dau_DsdToTruth( char * p, int nVars )
         Abc_TtConst1( pRes, nWords );
     else
     {
-        int* pMatch = Dau_DsdComputeMatches(p);
+        int pMatch[DAU_MAX_STR];
+        Dau_DsdComputeMatches( p, pMatch );
         Dau_DsdToTruth_rec( p, &p, pMatch, pTtElems, pRes, nVars );
-#ifdef PIF_MULTITHREAD //ymc
-        free(pMatch);
-#endif
     }
     assert( *++p == 0 );
     return pRes;
@@ -866,11 +853,9 @@ char * Dau_DsdPerform( word t )
     pBuffer[Pos++] = 0;
 //    printf( "%d ", strlen(pBuffer) );
 //    printf( "%s ->", pBuffer );
-    int* pMatch = Dau_DsdComputeMatches(pBuffer);
+    int pMatch[DAU_MAX_STR];
+    Dau_DsdComputeMatches( pBuffer, pMatch );
     Dau_DsdRemoveBraces( pBuffer, pMatch );
-#ifdef PIF_MULTITHREAD //ymc
-    free(pMatch);
-#endif
 //    printf( " %s\n", pBuffer );
     return pBuffer;
 }
@@ -1954,11 +1939,9 @@ int Dau_DsdDecompose( word * pTruth, int nVarsInit, int fSplitPrime, int fWriteT
     else 
     {
         int Status = Dau_DsdDecomposeInt( p, pTruth, nVarsInit );
-        int* pMatch = Dau_DsdComputeMatches(p->pOutput);
+        int pMatch[DAU_MAX_STR];
+        Dau_DsdComputeMatches( p->pOutput, pMatch );
         Dau_DsdRemoveBraces( p->pOutput, pMatch);
-#ifdef PIF_MULTITHREAD //ymc
-        free(pMatch);
-#endif
         if ( pRes )
             strcpy( pRes, p->pOutput );
         assert( fSplitPrime || Status != 1 );
@@ -1982,11 +1965,9 @@ int Dau_DsdDecomposeLevel( word * pTruth, int nVarsInit, int fSplitPrime, int fW
     else 
     {
         int Status = Dau_DsdDecomposeInt( p, pTruth, nVarsInit );
-        int* pMatch = Dau_DsdComputeMatches(p->pOutput);
+        int pMatch[DAU_MAX_STR];
+        Dau_DsdComputeMatches( p->pOutput, pMatch );
         Dau_DsdRemoveBraces( p->pOutput, pMatch );
-#ifdef PIF_MULTITHREAD //ymc
-        free(pMatch);
-#endif
         if ( pRes )
             strcpy( pRes, p->pOutput );
         assert( fSplitPrime || Status != 1 );
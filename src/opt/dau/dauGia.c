@@ -194,13 +194,14 @@ int Dau_DsdToGia2_rec( Gia_Man_t * pGia, char * pStr, char ** p, int * pMatches,
 }
 int Dau_DsdToGia2( Gia_Man_t * pGia, char * p, int * pLits, Vec_Int_t * vCover )
 {
+    int pMatches[DAU_MAX_STR];
     int Res;
     if ( *p == '0' && *(p+1) == 0 )
         Res = 0;
     else if ( *p == '1' && *(p+1) == 0 )
         Res = 1;
     else
-        Res = Dau_DsdToGia2_rec( pGia, p, &p, Dau_DsdComputeMatches(p), pLits, vCover );
+        Res = Dau_DsdToGia2_rec( pGia, p, &p, Dau_DsdComputeMatches(p, pMatches), pLits, vCover );
     assert( *++p == 0 );
     return Res;
 }
@@ -423,11 +424,9 @@ int Dau_DsdToGia( Gia_Man_t * pGia, char * p, int * pLits, Vec_Int_t * vCover )
         Res = 1;
     else
     {
-        int* pMatch = Dau_DsdComputeMatches(p);
+        int pMatch[DAU_MAX_STR];
+        Dau_DsdComputeMatches( p, pMatch );
         Res = Dau_DsdToGia_rec( pGia, p, &p, pMatch, pLits, vCover );
-#ifdef PIF_MULTITHREAD //ymc
-        free(pMatch);
-#endif
     }
     assert( *++p == 0 );
     return Res;